@@ -0,0 +1,186 @@
+#include "bench.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#include "support/alloc_counter.h"
+
+namespace {
+    volatile size_t g_sink = 0;
+} // namespace
+
+namespace bench {
+    std::vector<uint8_t> runner::make_input(const size_t size) {
+        // xorshift64, so every run and every release sees the same bytes
+        std::vector<uint8_t> data(size);
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (auto &byte : data) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            byte = static_cast<uint8_t>(state);
+        }
+        return data;
+    }
+
+    void runner::add(const std::string &name,
+                     body_fn body,
+                     const size_t max_size,
+                     prepare_fn prepare) {
+        cases.push_back(
+                {name, max_size, std::move(prepare), std::move(body)});
+    }
+
+    result runner::measure(const size_t case_index,
+                           const std::vector<uint8_t> &arg,
+                           const size_t size,
+                           const double min_time) const {
+        using clock = std::chrono::steady_clock;
+        const bench_case &c = cases[case_index];
+
+        // warm-up, also faults in the input pages
+        g_sink = g_sink + c.body(arg);
+
+        uint64_t iterations = 1;
+        double elapsed = 0;
+        uint64_t cycles = 0;
+        uint64_t allocs = 0;
+        uint64_t bytes = 0;
+        while (true) {
+            const support::alloc_stats alloc_begin =
+                    support::global_alloc_stats();
+            const auto time_begin = clock::now();
+            const uint64_t tsc_begin = __rdtsc();
+            for (uint64_t i = 0; i < iterations; ++i) {
+                g_sink = g_sink + c.body(arg);
+            }
+            const uint64_t tsc_end = __rdtsc();
+            const auto time_end = clock::now();
+            elapsed = std::chrono::duration<double>(time_end - time_begin)
+                              .count();
+            cycles = tsc_end - tsc_begin;
+            const support::alloc_stats alloc_end =
+                    support::global_alloc_stats();
+            allocs = alloc_end.count - alloc_begin.count;
+            bytes = alloc_end.bytes - alloc_begin.bytes;
+            if (elapsed >= min_time || iterations >= (1ULL << 40)) {
+                break;
+            }
+            // aim a little past min_time so the next batch is the last one
+            const double scale =
+                    elapsed > 0 ? (min_time * 1.2) / elapsed : 16;
+            iterations = static_cast<uint64_t>(
+                    static_cast<double>(iterations) *
+                    std::clamp(scale, 2.0, 16.0));
+        }
+
+        result r;
+        r.case_index = case_index;
+        r.name = c.name;
+        r.size = size;
+        r.iterations = iterations;
+        const auto n = static_cast<double>(iterations);
+        r.ns_per_call = elapsed * 1e9 / n;
+        r.mb_per_sec = static_cast<double>(size) * n / elapsed / 1e6;
+        r.cycles_per_byte = static_cast<double>(cycles) /
+                (n * static_cast<double>(size ? size : 1));
+        r.allocs_per_call = static_cast<double>(allocs) / n;
+        r.alloc_bytes_per_call = static_cast<double>(bytes) / n;
+        return r;
+    }
+
+    const std::vector<result> &runner::run(const options &opt) {
+        results.clear();
+        for (size_t size = opt.min_size; size <= opt.max_size; size *= 4) {
+            const std::vector<uint8_t> input = make_input(size);
+            for (size_t i = 0; i < cases.size(); ++i) {
+                const bench_case &c = cases[i];
+                if (size > c.max_size) {
+                    continue;
+                }
+                if (!opt.filter.empty() &&
+                    c.name.find(opt.filter) == std::string::npos) {
+                    continue;
+                }
+                if (c.prepare) {
+                    const std::vector<uint8_t> arg = c.prepare(input);
+                    results.push_back(measure(i, arg, size, opt.min_time));
+                } else {
+                    results.push_back(measure(i, input, size, opt.min_time));
+                }
+                const result &r = results.back();
+                std::fprintf(stderr, "%-28s %12zu  %10.2f MB/s\n",
+                             r.name.data(), r.size, r.mb_per_sec);
+            }
+            if (size > SIZE_MAX / 4) {
+                break;
+            }
+        }
+        std::stable_sort(results.begin(), results.end(),
+                         [](const result &a, const result &b) {
+                             return a.case_index < b.case_index;
+                         });
+        return results;
+    }
+
+    void runner::print() const {
+        std::printf("%-28s %12s %12s %12s %10s %10s %12s\n", "benchmark",
+                    "size", "ns/call", "MB/s", "cyc/byte", "allocs",
+                    "alloc bytes");
+        for (const auto &r : results) {
+            std::printf("%-28s %12zu %12.1f %12.2f %10.2f %10.2f %12.0f\n",
+                        r.name.data(), r.size, r.ns_per_call, r.mb_per_sec,
+                        r.cycles_per_byte, r.allocs_per_call,
+                        r.alloc_bytes_per_call);
+        }
+    }
+
+    bool runner::write_json(const std::string &path,
+                            const options &opt) const {
+        FILE *file = std::fopen(path.data(), "wb");
+        if (!file) {
+            return false;
+        }
+        char date[32] = {};
+        const std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ",
+                      std::gmtime(&now));
+#ifdef NDEBUG
+        const char *build_type = "release";
+#else
+        const char *build_type = "debug";
+#endif
+        std::fprintf(file,
+                     "{\n"
+                     "  \"context\": {\n"
+                     "    \"date\": \"%s\",\n"
+                     "    \"build_type\": \"%s\",\n"
+                     "    \"min_time\": %.3f,\n"
+                     "    \"min_size\": %zu,\n"
+                     "    \"max_size\": %zu\n"
+                     "  },\n"
+                     "  \"benchmarks\": [",
+                     date, build_type, opt.min_time, opt.min_size,
+                     opt.max_size);
+        for (size_t i = 0; i < results.size(); ++i) {
+            const result &r = results[i];
+            std::fprintf(file,
+                         "%s\n    {\"name\": \"%s\", \"size\": %zu, "
+                         "\"iterations\": %llu, \"ns_per_call\": %.3f, "
+                         "\"mb_per_sec\": %.3f, \"cycles_per_byte\": %.4f, "
+                         "\"allocs_per_call\": %.3f, "
+                         "\"alloc_bytes_per_call\": %.1f}",
+                         i ? "," : "", r.name.data(), r.size,
+                         static_cast<unsigned long long>(r.iterations),
+                         r.ns_per_call, r.mb_per_sec, r.cycles_per_byte,
+                         r.allocs_per_call, r.alloc_bytes_per_call);
+        }
+        std::fprintf(file, "\n  ]\n}\n");
+        return std::fclose(file) == 0;
+    }
+} // namespace bench
@@ -0,0 +1,92 @@
+#ifndef BENCH_H
+#define BENCH_H
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench {
+    struct result {
+        size_t case_index = 0;
+        std::string name{};
+        size_t size = 0;
+        uint64_t iterations = 0;
+        double ns_per_call = 0;
+        double mb_per_sec = 0;
+        double cycles_per_byte = 0;
+        double allocs_per_call = 0;
+        double alloc_bytes_per_call = 0;
+    };
+
+    struct options {
+        size_t min_size = 16;
+        size_t max_size = 1ULL << 30;
+        double min_time = 0.2;
+        std::string filter{};
+        std::string json_path{};
+    };
+
+    // prepare turns the raw random input into the argument the body expects
+    // (e.g. ciphertext for a decoder); it runs outside the timed region.
+    using prepare_fn =
+            std::function<std::vector<uint8_t>(const std::vector<uint8_t> &)>;
+
+    using body_fn = std::function<size_t(const std::vector<uint8_t> &)>;
+
+    class runner {
+    private:
+        struct bench_case {
+            std::string name;
+            size_t max_size;
+            prepare_fn prepare;
+            body_fn body;
+        };
+
+        std::vector<bench_case> cases = {};
+        std::vector<result> results = {};
+
+        static std::vector<uint8_t> make_input(size_t size);
+
+        result measure(size_t case_index,
+                       const std::vector<uint8_t> &arg,
+                       size_t size,
+                       double min_time) const;
+
+    public:
+        runner(const runner &other) = delete;
+
+        runner(runner &&other) = delete;
+
+        runner &operator=(const runner &other) = delete;
+
+        runner &operator=(runner &&other) = delete;
+
+        runner() = default;
+
+        ~runner() = default;
+
+        void add(const std::string &name,
+                 body_fn body,
+                 size_t max_size = SIZE_MAX,
+                 prepare_fn prepare = nullptr);
+
+        const std::vector<result> &run(const options &opt);
+
+        void print() const;
+
+        bool write_json(const std::string &path, const options &opt) const;
+    };
+
+    void register_crypto(runner &r);
+
+    void register_hash(runner &r);
+
+    void register_mem(runner &r);
+
+    void register_sync(runner &r);
+
+    void register_sys(runner &r);
+
+    void register_text(runner &r);
+} // namespace bench
+#endif // BENCH_H
@@ -0,0 +1,159 @@
+#include "bench.h"
+#include <memory>
+#include "crypto/aes.h"
+#include "crypto/aes192.h"
+#include "crypto/aes256.h"
+#include "crypto/base100.h"
+#include "crypto/base16.h"
+#include "crypto/base32.h"
+#include "crypto/base58.h"
+#include "crypto/base62.h"
+#include "crypto/base64.h"
+#include "crypto/base85.h"
+#include "crypto/base91.h"
+#include "crypto/base92.h"
+#include "crypto/rsa.h"
+#include "crypto/uuencode.h"
+#include "crypto/vigenere.h"
+#include "crypto/xxencode.h"
+namespace crypto = YanLib::crypto;
+
+namespace {
+    template <typename Codec>
+    void add_codec(bench::runner &r,
+                   const std::string &name,
+                   const size_t max_size = SIZE_MAX) {
+        r.add(
+                name + "::encode",
+                [](const std::vector<uint8_t> &in) {
+                    return Codec::encode(in).size();
+                },
+                max_size);
+        r.add(
+                name + "::decode",
+                [](const std::vector<uint8_t> &in) {
+                    return Codec::decode(in).size();
+                },
+                max_size,
+                [](const std::vector<uint8_t> &in) {
+                    return Codec::encode(in);
+                });
+    }
+
+    template <typename Aes>
+    void add_aes(bench::runner &r, const std::string &name, size_t key_size) {
+        const auto cipher = std::make_shared<Aes>();
+        const std::vector<uint8_t> key(key_size, 0x5A);
+        const std::vector<uint8_t> iv(16, 0xA5);
+        r.add(name + "::encode_cbc",
+              [cipher, key, iv](const std::vector<uint8_t> &in) {
+                  return cipher->encode_cbc(in, key, iv).size();
+              });
+        r.add(
+                name + "::decode_cbc",
+                [cipher, key, iv](const std::vector<uint8_t> &in) {
+                    return cipher->decode_cbc(in, key, iv).size();
+                },
+                SIZE_MAX,
+                [cipher, key, iv](const std::vector<uint8_t> &in) {
+                    return cipher->encode_cbc(in, key, iv);
+                });
+        r.add(name + "::encode_ecb",
+              [cipher, key](const std::vector<uint8_t> &in) {
+                  return cipher->encode_ecb(in, key).size();
+              });
+        r.add(
+                name + "::decode_ecb",
+                [cipher, key](const std::vector<uint8_t> &in) {
+                    return cipher->decode_ecb(in, key).size();
+                },
+                SIZE_MAX,
+                [cipher, key](const std::vector<uint8_t> &in) {
+                    return cipher->encode_ecb(in, key);
+                });
+        r.add(name + "::encode_cfb",
+              [cipher, key, iv](const std::vector<uint8_t> &in) {
+                  return cipher->encode_cfb(in, key, iv).size();
+              });
+        r.add(
+                name + "::decode_cfb",
+                [cipher, key, iv](const std::vector<uint8_t> &in) {
+                    return cipher->decode_cfb(in, key, iv).size();
+                },
+                SIZE_MAX,
+                [cipher, key, iv](const std::vector<uint8_t> &in) {
+                    return cipher->encode_cfb(in, key, iv);
+                });
+    }
+} // namespace
+
+namespace bench {
+    void register_crypto(runner &r) {
+        add_codec<crypto::base16>(r, "base16");
+        add_codec<crypto::base32>(r, "base32");
+        // base58/base62 are big-number conversions, quadratic in the input
+        add_codec<crypto::base58>(r, "base58", 16 * 1024);
+        add_codec<crypto::base62>(r, "base62", 16 * 1024);
+        add_codec<crypto::base64>(r, "base64");
+        add_codec<crypto::base85>(r, "base85");
+        add_codec<crypto::base91>(r, "base91");
+        add_codec<crypto::base92>(r, "base92");
+        add_codec<crypto::base100>(r, "base100");
+        add_codec<crypto::uuencode>(r, "uuencode");
+        add_codec<crypto::xxencode>(r, "xxencode");
+
+        r.add("base64::encode_url", [](const std::vector<uint8_t> &in) {
+            return crypto::base64::encode_url(in).size();
+        });
+        r.add(
+                "base64::decode_url",
+                [](const std::vector<uint8_t> &in) {
+                    return crypto::base64::decode_url(in).size();
+                },
+                SIZE_MAX,
+                [](const std::vector<uint8_t> &in) {
+                    return crypto::base64::encode_url(in);
+                });
+
+        const std::vector<uint8_t> vigenere_key = {'Y', 'a', 'n', 'L', 'i', 'b'};
+        r.add("vigenere::encode",
+              [vigenere_key](const std::vector<uint8_t> &in) {
+                  return crypto::vigenere::encode(in, vigenere_key).size();
+              });
+        r.add(
+                "vigenere::decode",
+                [vigenere_key](const std::vector<uint8_t> &in) {
+                    return crypto::vigenere::decode(in, vigenere_key).size();
+                },
+                SIZE_MAX,
+                [vigenere_key](const std::vector<uint8_t> &in) {
+                    return crypto::vigenere::encode(in, vigenere_key);
+                });
+
+        add_aes<crypto::aes>(r, "aes", 16);
+        add_aes<crypto::aes192>(r, "aes192", 24);
+        add_aes<crypto::aes256>(r, "aes256", 32);
+
+        // a 2048-bit key takes at most 245 bytes per PKCS#1 v1.5 block
+        const auto rsa = std::make_shared<crypto::rsa>();
+        if (rsa->generate_key(crypto::RsaKeyBits::Bit2048)) {
+            const std::vector<uint8_t> pub = rsa->pub_blob();
+            const std::vector<uint8_t> priv = rsa->priv_blob();
+            r.add(
+                    "rsa::encode",
+                    [rsa, pub](const std::vector<uint8_t> &in) {
+                        return rsa->encode(in, pub).size();
+                    },
+                    128);
+            r.add(
+                    "rsa::decode",
+                    [rsa, priv](const std::vector<uint8_t> &in) {
+                        return rsa->decode(in, priv).size();
+                    },
+                    128,
+                    [rsa, pub](const std::vector<uint8_t> &in) {
+                        return rsa->encode(in, pub);
+                    });
+        }
+    }
+} // namespace bench
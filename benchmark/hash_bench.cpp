@@ -0,0 +1,31 @@
+#include "bench.h"
+#include "hash/md5.h"
+#include "hash/sha1.h"
+#include "hash/sha256.h"
+#include "hash/sha384.h"
+#include "hash/sha512.h"
+namespace hash = YanLib::hash;
+
+namespace {
+    template <typename Hash>
+    void add_hash(bench::runner &r, const std::string &name) {
+        r.add(name + "::hash", [](const std::vector<uint8_t> &in) {
+            Hash h(in);
+            return h.hash().size();
+        });
+        r.add(name + "::hash_string", [](const std::vector<uint8_t> &in) {
+            Hash h(in);
+            return h.hash_string().size();
+        });
+    }
+} // namespace
+
+namespace bench {
+    void register_hash(runner &r) {
+        add_hash<hash::md5>(r, "md5");
+        add_hash<hash::sha1>(r, "sha1");
+        add_hash<hash::sha256>(r, "sha256");
+        add_hash<hash::sha384>(r, "sha384");
+        add_hash<hash::sha512>(r, "sha512");
+    }
+} // namespace bench
@@ -0,0 +1,86 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "bench.h"
+
+namespace {
+    // accepts plain byte counts and K/M/G suffixes (powers of 1024)
+    size_t parse_size(const char *text) {
+        char *end = nullptr;
+        size_t value = std::strtoull(text, &end, 10);
+        switch (end ? *end : '\0') {
+            case 'G':
+            case 'g':
+                value <<= 10;
+                [[fallthrough]];
+            case 'M':
+            case 'm':
+                value <<= 10;
+                [[fallthrough]];
+            case 'K':
+            case 'k':
+                value <<= 10;
+                break;
+            default:
+                break;
+        }
+        return value;
+    }
+
+    bool match(const char *arg, const char *name, const char **value) {
+        const size_t len = std::strlen(name);
+        if (std::strncmp(arg, name, len) != 0 || arg[len] != '=') {
+            return false;
+        }
+        *value = arg + len + 1;
+        return true;
+    }
+
+    void usage(const char *program) {
+        std::fprintf(stderr,
+                     "usage: %s [--min-size=16] [--max-size=1G] "
+                     "[--min-time=0.2] [--filter=name] [--json=file]\n",
+                     program);
+    }
+} // namespace
+
+int main(int argc, char **argv) {
+    bench::options opt;
+    for (int i = 1; i < argc; ++i) {
+        const char *value = nullptr;
+        if (match(argv[i], "--min-size", &value)) {
+            opt.min_size = parse_size(value);
+        } else if (match(argv[i], "--max-size", &value)) {
+            opt.max_size = parse_size(value);
+        } else if (match(argv[i], "--min-time", &value)) {
+            opt.min_time = std::strtod(value, nullptr);
+        } else if (match(argv[i], "--filter", &value)) {
+            opt.filter = value;
+        } else if (match(argv[i], "--json", &value)) {
+            opt.json_path = value;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (opt.min_size == 0 || opt.min_size > opt.max_size) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    bench::runner runner;
+    bench::register_crypto(runner);
+    bench::register_hash(runner);
+    bench::register_mem(runner);
+    bench::register_sync(runner);
+    bench::register_sys(runner);
+    bench::register_text(runner);
+    runner.run(opt);
+    runner.print();
+    if (!opt.json_path.empty() && !runner.write_json(opt.json_path, opt)) {
+        std::fprintf(stderr, "failed to write %s\n", opt.json_path.data());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,191 @@
+#include "bench.h"
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include "mem/allocate.h"
+#include "mem/epoch.h"
+#include "mem/hazard.h"
+#include "mem/slab.h"
+namespace mem = YanLib::mem;
+
+namespace {
+    // every call allocates BATCH blocks of in.size() bytes, touches them and
+    // frees them again, so ns/call covers BATCH malloc/free pairs
+    constexpr size_t BATCH = 64;
+
+    // past this the slab hands out whole mappings as well
+    constexpr size_t MAX_SIZE = 1024 * 1024;
+
+    // dependent random reads, so every access waits for its translation
+    constexpr size_t RANDOM_READS = 4096;
+
+    // keeps one buffer of the benchmarked size alive between calls
+    struct random_buffer {
+        mem::allocate allocate;
+        bool large_pages = false;
+        uint8_t *data = nullptr;
+        size_t size = 0;
+
+        explicit random_buffer(const bool large_pages)
+            : large_pages(large_pages) {
+        }
+
+        const uint8_t *get(const size_t new_size) {
+            if (size != new_size) {
+                if (data) {
+                    allocate.free(data);
+                }
+                data = static_cast<uint8_t *>(
+                        large_pages ? allocate.malloc_large_page(new_size)
+                                    : allocate.malloc(new_size));
+                size = data ? new_size : 0;
+                for (size_t i = 0; i < size; i += 4096) {
+                    data[i] = static_cast<uint8_t>(i >> 12);
+                }
+            }
+            return data;
+        }
+    };
+
+    size_t random_reads(const uint8_t *data, const size_t size) {
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        size_t sum = 0;
+        for (size_t i = 0; i < RANDOM_READS; ++i) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            sum += data[(state + sum) % size];
+        }
+        return sum;
+    }
+
+    // a shared pointer replaced over and over, readers go through the
+    // scheme under test; the input size does not matter
+    struct reclaim_state {
+        mem::object_pool<uint64_t> pool{BATCH};
+        // declared after the pool, their garbage goes back to it
+        mem::epoch_domain epochs;
+        mem::hazard_domain hazards;
+        std::atomic<uint64_t *> shared{nullptr};
+
+        reclaim_state() {
+            shared = pool.create(0);
+        }
+
+        ~reclaim_state() {
+            pool.destroy(shared.load());
+        }
+    };
+
+    // every call reads and replaces the shared value BATCH times
+    template <typename Read, typename Retire>
+    size_t replace(reclaim_state &state, Read &&read_fn, Retire &&retire_fn) {
+        size_t sum = 0;
+        for (size_t i = 0; i < BATCH; ++i) {
+            sum += read_fn();
+            retire_fn(state.shared.exchange(state.pool.create(i)));
+        }
+        return sum;
+    }
+
+    template <typename Malloc, typename Free>
+    size_t churn(const size_t size, Malloc &&malloc_fn, Free &&free_fn) {
+        void *blocks[BATCH];
+        size_t sum = 0;
+        for (auto &block : blocks) {
+            block = malloc_fn(size);
+            if (block) {
+                *static_cast<uint8_t *>(block) = 1;
+                ++sum;
+            }
+        }
+        for (const auto block : blocks) {
+            free_fn(block);
+        }
+        return sum;
+    }
+} // namespace
+
+namespace bench {
+    void register_mem(runner &r) {
+        const auto allocate = std::make_shared<mem::allocate>();
+        r.add(
+                "allocate::malloc",
+                [allocate](const std::vector<uint8_t> &in) {
+                    return churn(
+                            in.size(),
+                            [&](size_t size) { return allocate->malloc(size); },
+                            [&](void *addr) { allocate->free(addr); });
+                },
+                MAX_SIZE);
+
+        const auto slab = std::make_shared<mem::slab>();
+        r.add(
+                "slab::malloc",
+                [slab](const std::vector<uint8_t> &in) {
+                    return churn(
+                            in.size(),
+                            [&](size_t size) { return slab->malloc(size); },
+                            [&](void *addr) { slab->free(addr); });
+                },
+                MAX_SIZE);
+
+        // Random access over buffers up to 1 GiB. Past the reach of the 4 KiB
+        // TLB every read also walks the page table, large pages keep the
+        // walk cached for much longer.
+        for (const bool large_pages : {false, true}) {
+            const auto buffer = std::make_shared<random_buffer>(large_pages);
+            r.add(large_pages ? "allocate::random_read_large"
+                              : "allocate::random_read",
+                  [buffer](const std::vector<uint8_t> &in) {
+                      const uint8_t *data = buffer->get(in.size());
+                      return data ? random_reads(data, in.size()) : 0;
+                  });
+        }
+
+        const auto reclaim = std::make_shared<reclaim_state>();
+        r.add(
+                "reclaim::epoch",
+                [reclaim](const std::vector<uint8_t> &) {
+                    return replace(
+                            *reclaim,
+                            [&] {
+                                mem::epoch_guard guard(reclaim->epochs);
+                                return static_cast<size_t>(
+                                        *reclaim->shared.load());
+                            },
+                            [&](uint64_t *old) {
+                                reclaim->epochs.retire(old, reclaim->pool);
+                            });
+                },
+                16);
+
+        r.add(
+                "reclaim::hazard",
+                [reclaim](const std::vector<uint8_t> &) {
+                    mem::hazard_pointer hp(reclaim->hazards);
+                    return replace(
+                            *reclaim,
+                            [&] {
+                                const size_t value =
+                                        *hp.protect(reclaim->shared);
+                                hp.reset();
+                                return value;
+                            },
+                            [&](uint64_t *old) {
+                                reclaim->hazards.retire(old, reclaim->pool);
+                            });
+                },
+                16);
+
+        r.add(
+                "std::malloc",
+                [](const std::vector<uint8_t> &in) {
+                    return churn(
+                            in.size(),
+                            [](size_t size) { return std::malloc(size); },
+                            [](void *addr) { std::free(addr); });
+                },
+                MAX_SIZE);
+    }
+} // namespace bench
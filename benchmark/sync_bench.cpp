@@ -0,0 +1,188 @@
+#include "bench.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "sync/futex_rwlock.h"
+#include "sync/mpmc_queue.h"
+#include "sync/percpu_rwlock.h"
+#include "sync/spsc_ring.h"
+#include "sys/scheduler.h"
+#ifdef _WIN32
+#include "sync/rwlock.h"
+#else
+#include <pthread.h>
+#endif
+namespace sys = YanLib::sys;
+using YanLib::sync::futex_rwlock;
+using YanLib::sync::mpmc_queue;
+using YanLib::sync::percpu_rwlock;
+using YanLib::sync::spsc_ring;
+
+namespace {
+    // read-locked lookups per task, small enough that the lock dominates
+    constexpr size_t GRAIN = 64;
+
+    // small, so producers and consumers keep running into each other
+    constexpr size_t QUEUE_CAPACITY = 256;
+
+    constexpr int PRODUCERS = 2;
+    constexpr int CONSUMERS = 2;
+
+    // the std::deque + mutex + condition variable handoff the queues replace
+    template <typename T> class locked_queue {
+    private:
+        std::mutex mutex;
+        std::condition_variable not_empty;
+        std::condition_variable not_full;
+        std::deque<T> items;
+        size_t limit;
+
+    public:
+        explicit locked_queue(const size_t capacity) : limit(capacity) {
+        }
+
+        void push(T value) {
+            std::unique_lock<std::mutex> lock(mutex);
+            not_full.wait(lock, [this] { return items.size() < limit; });
+            items.push_back(std::move(value));
+            lock.unlock();
+            not_empty.notify_one();
+        }
+
+        T pop() {
+            std::unique_lock<std::mutex> lock(mutex);
+            not_empty.wait(lock, [this] { return !items.empty(); });
+            T value = std::move(items.front());
+            items.pop_front();
+            lock.unlock();
+            not_full.notify_one();
+            return value;
+        }
+    };
+
+    // every byte becomes one item, pushed by PRODUCERS threads and popped
+    // by CONSUMERS threads through blocking calls
+    template <typename Queue>
+    size_t contended_handoff(const std::vector<uint8_t> &in) {
+        Queue queue(QUEUE_CAPACITY);
+        std::atomic<size_t> total{0};
+        std::vector<std::thread> threads;
+        const size_t per_consumer = in.size() / CONSUMERS;
+        const size_t per_producer = per_consumer * CONSUMERS / PRODUCERS;
+        for (int p = 0; p < PRODUCERS; ++p) {
+            threads.emplace_back([&, p] {
+                const size_t base = p * per_producer;
+                for (size_t i = 0; i < per_producer; ++i) {
+                    queue.push(in[base + i]);
+                }
+            });
+        }
+        for (int c = 0; c < CONSUMERS; ++c) {
+            threads.emplace_back([&] {
+                size_t sum = 0;
+                for (size_t i = 0; i < per_consumer; ++i) {
+                    sum += queue.pop();
+                }
+                total.fetch_add(sum, std::memory_order_relaxed);
+            });
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+        return total.load();
+    }
+
+    // every byte makes one round trip to an echo thread and back, so
+    // ns/call divided by the size is the handoff latency twice over
+    template <typename Queue>
+    size_t round_trip(const std::vector<uint8_t> &in) {
+        Queue request(QUEUE_CAPACITY);
+        Queue reply(QUEUE_CAPACITY);
+        std::thread echo([&] {
+            for (size_t i = 0; i < in.size(); ++i) {
+                reply.push(request.pop());
+            }
+        });
+        size_t sum = 0;
+        for (const uint8_t byte : in) {
+            request.push(byte);
+            sum += reply.pop();
+        }
+        echo.join();
+        return sum;
+    }
+
+#ifndef _WIN32
+    struct pthread_lock {
+        pthread_rwlock_t lock = PTHREAD_RWLOCK_INITIALIZER;
+
+        ~pthread_lock() {
+            pthread_rwlock_destroy(&lock);
+        }
+
+        void read_lock() {
+            pthread_rwlock_rdlock(&lock);
+        }
+
+        void read_unlock() {
+            pthread_rwlock_unlock(&lock);
+        }
+    };
+#endif
+
+    // every byte is one read-locked lookup, spread over all workers that
+    // share the one lock; no writer ever shows up
+    template <typename Lock>
+    bench::body_fn read_mostly(const std::shared_ptr<sys::scheduler> &pool) {
+        auto lock = std::make_shared<Lock>();
+        return [pool, lock](const std::vector<uint8_t> &in) {
+            std::atomic<size_t> total{0};
+            pool->parallel_for(
+                    0, (in.size() + GRAIN - 1) / GRAIN,
+                    [&](const size_t block) {
+                        const size_t end = (block + 1) * GRAIN < in.size()
+                                ? (block + 1) * GRAIN
+                                : in.size();
+                        size_t sum = 0;
+                        for (size_t i = block * GRAIN; i < end; ++i) {
+                            lock->read_lock();
+                            sum += in[i];
+                            lock->read_unlock();
+                        }
+                        total.fetch_add(sum, std::memory_order_relaxed);
+                    },
+                    1);
+            return total.load();
+        };
+    }
+} // namespace
+
+namespace bench {
+    void register_sync(runner &r) {
+        const auto pool = std::make_shared<sys::scheduler>();
+        constexpr size_t max_size = 4 * 1024 * 1024;
+#ifdef _WIN32
+        r.add("rwlock::srw", read_mostly<YanLib::sync::rwlock>(pool),
+              max_size);
+#else
+        r.add("rwlock::pthread", read_mostly<pthread_lock>(pool), max_size);
+#endif
+        r.add("rwlock::futex", read_mostly<futex_rwlock>(pool),
+              max_size);
+        r.add("rwlock::percpu", read_mostly<percpu_rwlock>(pool),
+              max_size);
+        r.add("handoff::deque_condvar", contended_handoff<locked_queue<int>>,
+              max_size);
+        r.add("handoff::mpmc_queue", contended_handoff<mpmc_queue<int>>,
+              max_size);
+        constexpr size_t max_trips = 256 * 1024;
+        r.add("round_trip::deque_condvar", round_trip<locked_queue<int>>,
+              max_trips);
+        r.add("round_trip::mpmc_queue", round_trip<mpmc_queue<int>>,
+              max_trips);
+        r.add("round_trip::spsc_ring", round_trip<spsc_ring<int>>, max_trips);
+    }
+} // namespace bench
@@ -0,0 +1,60 @@
+#include "bench.h"
+#include <future>
+#include <memory>
+#include "sys/scheduler.h"
+namespace sys = YanLib::sys;
+
+namespace {
+    // per-index work heavy enough that the split overhead has to pay off
+    uint64_t mix(uint64_t x) {
+        for (int i = 0; i < 8; ++i) {
+            x ^= x >> 33;
+            x *= 0xFF51AFD7ED558CCDULL;
+        }
+        return x;
+    }
+} // namespace
+
+namespace bench {
+    void register_sys(runner &r) {
+        r.add("serial::for", [](const std::vector<uint8_t> &in) {
+            std::vector<uint8_t> out(in.size());
+            for (size_t i = 0; i < in.size(); ++i) {
+                out[i] = static_cast<uint8_t>(mix(in[i]));
+            }
+            return static_cast<size_t>(out[out.size() / 2]);
+        });
+        const auto pool = std::make_shared<sys::scheduler>();
+        r.add("scheduler::parallel_for",
+              [pool](const std::vector<uint8_t> &in) {
+                  std::vector<uint8_t> out(in.size());
+                  pool->parallel_for(0, in.size(), [&](const size_t i) {
+                      out[i] = static_cast<uint8_t>(mix(in[i]));
+                  });
+                  return static_cast<size_t>(out[out.size() / 2]);
+              });
+        r.add(
+                "scheduler::submit",
+                [pool](const std::vector<uint8_t> &in) {
+                    // one task per 256 bytes, joined through the futures
+                    std::vector<std::future<uint64_t>> parts;
+                    for (size_t i = 0; i < in.size(); i += 256) {
+                        parts.push_back(pool->submit([&in, i] {
+                            uint64_t sum = 0;
+                            const size_t end =
+                                    i + 256 < in.size() ? i + 256 : in.size();
+                            for (size_t j = i; j < end; ++j) {
+                                sum += mix(in[j]);
+                            }
+                            return sum;
+                        }));
+                    }
+                    uint64_t sum = 0;
+                    for (auto &part : parts) {
+                        sum += pool->wait(part);
+                    }
+                    return static_cast<size_t>(sum);
+                },
+                16 * 1024 * 1024);
+    }
+} // namespace bench
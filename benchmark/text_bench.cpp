@@ -0,0 +1,148 @@
+#include "bench.h"
+#include <cstring>
+#include "helper/codepage.h"
+#include "helper/utf.h"
+namespace helper = YanLib::helper;
+
+namespace {
+    // Mixed text of exactly in.size() bytes in a double-byte code page:
+    // bytes below 0xA0 become ASCII, the rest GB2312/Big5 level-1 hanzi.
+    std::vector<uint8_t> make_dbcs(const std::vector<uint8_t> &in,
+                                   const uint8_t lead_min) {
+        std::vector<uint8_t> out(in.size());
+        for (size_t i = 0; i < in.size(); ++i) {
+            if (in[i] < 0xA0 || i + 1 == in.size()) {
+                out[i] = 0x20 + in[i] % 0x5F;
+            } else {
+                out[i] = lead_min + in[i] % 0x10;
+                out[i + 1] = 0xA1 + in[i + 1] % 0x5E;
+                ++i;
+            }
+        }
+        return out;
+    }
+
+    // the same text as UTF-8, in.size() bytes
+    std::vector<uint8_t> make_utf8(const std::vector<uint8_t> &in) {
+        std::vector<uint8_t> out(in.size());
+        for (size_t i = 0; i < in.size(); ++i) {
+            if (in[i] < 0xA0 || i + 3 > in.size()) {
+                out[i] = 0x20 + in[i] % 0x5F;
+            } else {
+                const uint32_t unit = 0x4E00 + in[i] * 37;
+                out[i] = static_cast<uint8_t>(0xE0 | (unit >> 12));
+                out[i + 1] = static_cast<uint8_t>(0x80 | ((unit >> 6) & 0x3F));
+                out[i + 2] = static_cast<uint8_t>(0x80 | (unit & 0x3F));
+                i += 2;
+            }
+        }
+        return out;
+    }
+
+    // UTF-16 of a code page text, packed into bytes
+    std::vector<uint8_t> to_utf16(const uint32_t code_page,
+                                  const std::vector<uint8_t> &text) {
+        const auto *str = reinterpret_cast<const char *>(text.data());
+        const size_t len =
+                helper::codepage::decode_length(code_page, str, text.size());
+        std::vector<uint8_t> out(len * sizeof(char16_t));
+        helper::codepage::decode(code_page, str, text.size(),
+                                 reinterpret_cast<char16_t *>(out.data()),
+                                 len);
+        return out;
+    }
+
+    // output buffers live across calls so only the conversion is timed
+    std::vector<char16_t> &wide_buffer(const size_t size) {
+        static std::vector<char16_t> buffer;
+        if (buffer.size() < size) {
+            buffer.resize(size);
+        }
+        return buffer;
+    }
+
+    std::vector<char> &narrow_buffer(const size_t size) {
+        static std::vector<char> buffer;
+        if (buffer.size() < size) {
+            buffer.resize(size);
+        }
+        return buffer;
+    }
+
+    void add_codepage(bench::runner &r,
+                      const std::string &name,
+                      const uint32_t code_page,
+                      bench::prepare_fn make_text) {
+        r.add(
+                "codepage::decode_" + name,
+                [code_page](const std::vector<uint8_t> &in) {
+                    auto &out = wide_buffer(in.size());
+                    const auto *str = reinterpret_cast<const char *>(in.data());
+                    return helper::codepage::decode(code_page, str, in.size(),
+                                                    out.data(), out.size());
+                },
+                SIZE_MAX, make_text);
+        r.add(
+                "codepage::encode_" + name,
+                [code_page](const std::vector<uint8_t> &in) {
+                    auto &out = narrow_buffer(in.size());
+                    return helper::codepage::encode(
+                            code_page,
+                            reinterpret_cast<const char16_t *>(in.data()),
+                            in.size() / sizeof(char16_t), out.data(),
+                            out.size());
+                },
+                SIZE_MAX,
+                [code_page, make_text](const std::vector<uint8_t> &in) {
+                    return to_utf16(code_page, make_text(in));
+                });
+    }
+} // namespace
+
+namespace bench {
+    void register_text(runner &r) {
+        add_codepage(r, "gbk", 936, [](const std::vector<uint8_t> &in) {
+            return make_dbcs(in, 0xB0);
+        });
+        add_codepage(r, "gb18030", 54936, [](const std::vector<uint8_t> &in) {
+            return make_dbcs(in, 0xB0);
+        });
+        add_codepage(r, "big5", 950, [](const std::vector<uint8_t> &in) {
+            return make_dbcs(in, 0xA4);
+        });
+        add_codepage(r, "win1252", 1252, [](const std::vector<uint8_t> &in) {
+            // the five bytes 1252 leaves undefined become '?'
+            std::vector<uint8_t> out(in);
+            for (auto &byte : out) {
+                if (byte == 0x81 || byte == 0x8D || byte == 0x8F ||
+                    byte == 0x90 || byte == 0x9D) {
+                    byte = '?';
+                }
+            }
+            return out;
+        });
+
+        r.add(
+                "utf::utf8_to_utf16",
+                [](const std::vector<uint8_t> &in) {
+                    auto &out = wide_buffer(in.size());
+                    return helper::utf::utf8_to_utf16(
+                            reinterpret_cast<const char *>(in.data()),
+                            in.size(), out.data(), out.size());
+                },
+                SIZE_MAX, make_utf8);
+        r.add(
+                "utf::utf16_to_utf8",
+                [](const std::vector<uint8_t> &in) {
+                    auto &out = narrow_buffer(in.size() * 2);
+                    return helper::utf::utf16_to_utf8(
+                            reinterpret_cast<const char16_t *>(in.data()),
+                            in.size() / sizeof(char16_t), out.data(),
+                            out.size());
+                },
+                SIZE_MAX,
+                [](const std::vector<uint8_t> &in) {
+                    return to_utf16(54936, make_dbcs(in, 0xB0));
+                });
+    }
+} // namespace bench
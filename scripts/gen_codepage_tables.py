@@ -0,0 +1,200 @@
+# -*- coding: utf-8 -*-
+"""Generate src/helper/codepage_tables.cpp from the Python codecs.
+
+usage: python gen_codepage_tables.py
+
+The tables back helper::codepage. Decode tables are emitted as data, the
+reverse (encode) direction is built from them at run time on first use.
+"""
+import os
+from pathlib import Path
+
+SINGLE_BYTE = [1250, 1251, 1252, 1253, 1254, 1255, 1256, 1257, 1258]
+
+LEAD_MIN, LEAD_MAX = 0x81, 0xFE
+TRAIL_MIN, TRAIL_MAX = 0x40, 0xFE
+TRAIL_COUNT = TRAIL_MAX - TRAIL_MIN + 1
+SLOT_COUNT = (LEAD_MAX - LEAD_MIN + 1) * TRAIL_COUNT
+
+HEADER = """/* clang-format off */
+/*
+ * @file codepage_tables.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+// Generated by scripts/gen_codepage_tables.py, do not edit.
+#include "codepage_tables.h"
+
+namespace YanLib::helper {
+"""
+
+
+def single_byte_table(code_page):
+    """0x80-0xFF -> UTF-16, 0 for bytes the code page leaves undefined"""
+    table = []
+    for byte in range(0x80, 0x100):
+        try:
+            table.append(ord(bytes([byte]).decode(f'cp{code_page}')))
+        except UnicodeDecodeError:
+            table.append(0)
+    return table
+
+
+def double_byte_table(codec):
+    """(lead, trail) slots -> UTF-16, 0 when unmapped"""
+    table = [0] * SLOT_COUNT
+    for lead in range(LEAD_MIN, LEAD_MAX + 1):
+        for trail in range(TRAIL_MIN, TRAIL_MAX + 1):
+            try:
+                text = bytes([lead, trail]).decode(codec)
+            except UnicodeDecodeError:
+                continue
+            if len(text) == 1 and ord(text) < 0x10000:
+                table[(lead - LEAD_MIN) * TRAIL_COUNT + trail - TRAIL_MIN] = \
+                    ord(text)
+    return table
+
+
+def one_way_codes(codec, table):
+    """codes that decode fine but are not what the encoder produces"""
+    codes = []
+    for slot, unit in enumerate(table):
+        if not unit:
+            continue
+        code = ((slot // TRAIL_COUNT + LEAD_MIN) << 8) | \
+            (slot % TRAIL_COUNT + TRAIL_MIN)
+        if chr(unit).encode(codec) != bytes([code >> 8, code & 0xFF]):
+            codes.append(code)
+    return codes
+
+
+def encode_only(codec, table):
+    """(unit, code) the encoder produces although code decodes elsewhere"""
+    pairs = []
+    for unit in range(0x80, 0x10000):
+        if 0xD800 <= unit < 0xE000:
+            continue
+        try:
+            data = chr(unit).encode(codec)
+        except UnicodeEncodeError:
+            continue
+        if len(data) != 2:
+            continue
+        slot = (data[0] - LEAD_MIN) * TRAIL_COUNT + data[1] - TRAIL_MIN
+        if table[slot] != unit:
+            pairs.append((unit, (data[0] << 8) | data[1]))
+    return pairs
+
+
+def gb18030_ranges():
+    """BMP runs that GB18030 encodes as four bytes, by linear index"""
+    ranges = []
+    prev = None
+    for unit in range(0x80, 0x10000):
+        if 0xD800 <= unit < 0xE000:
+            continue
+        data = chr(unit).encode('gb18030')
+        if len(data) != 4:
+            continue
+        linear = (((data[0] - 0x81) * 10 + data[1] - 0x30) * 126 +
+                  data[2] - 0x81) * 10 + data[3] - 0x30
+        if not prev or prev[0] + 1 != unit or prev[1] + 1 != linear:
+            ranges.append((unit, linear))
+        prev = (unit, linear)
+    return ranges
+
+
+def emit_array(out, decl, values, width=4, per_line=8):
+    out.append(f'    {decl} = {{')
+    for i in range(0, len(values), per_line):
+        row = ', '.join(f'0x{v:0{width}X}' for v in values[i:i + per_line])
+        out.append(f'            {row},')
+    out.append('    };')
+    out.append('')
+
+
+def main():
+    out = [HEADER.rstrip('\n')]
+
+    for code_page in SINGLE_BYTE:
+        emit_array(out, f'const char16_t WIN{code_page}_TABLE[128]',
+                   single_byte_table(code_page))
+
+    gb18030 = double_byte_table('gb18030')
+    gbk = double_byte_table('gbk')
+    # GBK is a subset of the GB18030 two-byte area, only a bitmap is kept
+    assert all(not u or u == gb18030[i] for i, u in enumerate(gbk))
+    mask = [0] * ((SLOT_COUNT + 7) // 8)
+    for slot, unit in enumerate(gbk):
+        if unit:
+            mask[slot // 8] |= 1 << (slot % 8)
+    emit_array(out, 'const char16_t GB18030_TABLE[DBCS_SLOTS]', gb18030)
+    emit_array(out, 'const uint8_t GBK_MASK[(DBCS_SLOTS + 7) / 8]', mask,
+               width=2, per_line=10)
+    assert not one_way_codes('gb18030', gb18030)
+    assert not one_way_codes('gbk', gbk)
+    assert not encode_only('gb18030', gb18030)
+    assert not encode_only('gbk', gbk)
+
+    ranges = gb18030_ranges()
+    out.append(f'    const gb18030_range GB18030_RANGES[{len(ranges)}] = {{')
+    for i in range(0, len(ranges), 3):
+        row = ', '.join(f'{{0x{u:04X}, {n}}}' for u, n in ranges[i:i + 3])
+        out.append(f'            {row},')
+    out.append('    };')
+    out.append('')
+    out.append('    const size_t GB18030_RANGE_COUNT =')
+    out.append('            sizeof(GB18030_RANGES) / '
+               'sizeof(GB18030_RANGES[0]);')
+    out.append('')
+
+    big5 = double_byte_table('cp950')
+    emit_array(out, 'const char16_t BIG5_TABLE[DBCS_SLOTS]', big5)
+    one_way = one_way_codes('cp950', big5)
+    emit_array(out, f'const uint16_t BIG5_ONE_WAY[{len(one_way)}]', one_way)
+    out.append('    const size_t BIG5_ONE_WAY_COUNT =')
+    out.append('            sizeof(BIG5_ONE_WAY) / sizeof(BIG5_ONE_WAY[0]);')
+    out.append('')
+    extra = encode_only('cp950', big5)
+    out.append(f'    const uint16_t BIG5_ENCODE_ONLY[{len(extra)}][2] = {{')
+    for i in range(0, len(extra), 3):
+        row = ', '.join(f'{{0x{u:04X}, 0x{c:04X}}}'
+                        for u, c in extra[i:i + 3])
+        out.append(f'            {row},')
+    out.append('    };')
+    out.append('')
+    out.append('    const size_t BIG5_ENCODE_ONLY_COUNT =')
+    out.append('            sizeof(BIG5_ENCODE_ONLY) / '
+               'sizeof(BIG5_ENCODE_ONLY[0]);')
+    out.append('} // namespace YanLib::helper')
+    out.append('')
+
+    path = Path(__file__).resolve().parent.parent / 'src' / 'helper' / \
+        'codepage_tables.cpp'
+    path.write_text('\n'.join(out), encoding='utf-8', newline='\n')
+    print(f'[+] wrote {os.path.relpath(path)}')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,169 @@
+/* clang-format off */
+/*
+ * @file executor.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+#include "task.h"
+#ifdef YANLIB_HAS_COROUTINES
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <utility>
+#include "sys/scheduler.h"
+#include "sys/timer_wheel.h"
+
+namespace YanLib::coro {
+    // Fire-and-forget coroutine; the frame frees itself at the end.
+    struct detached {
+        struct promise_type {
+            detached get_return_object() const noexcept {
+                return {};
+            }
+
+            std::suspend_never initial_suspend() const noexcept {
+                return {};
+            }
+
+            std::suspend_never final_suspend() const noexcept {
+                return {};
+            }
+
+            void return_void() const noexcept {
+            }
+
+            void unhandled_exception() const noexcept {
+                // like an exception escaping a std::thread
+                std::terminate();
+            }
+        };
+    };
+
+    // Binds coroutines to a sys::scheduler: co_await schedule() moves the
+    // coroutine onto a worker, co_await sleep_for() parks it on a timer
+    // wheel without holding a thread. Header-only like the rest of coro/,
+    // the library is built without coroutine support.
+    class executor {
+    private:
+        sys::scheduler &pool;
+        sys::timer_wheel wheel;
+        std::once_flag wheel_started = {};
+
+    public:
+        // awaiters live in the suspended coroutine's frame, so resuming
+        // allocates nothing
+        class schedule_awaiter : public sys::task {
+        private:
+            sys::scheduler &pool;
+            std::coroutine_handle<> handle = nullptr;
+
+        public:
+            explicit schedule_awaiter(sys::scheduler &pool) : pool(pool) {
+            }
+
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> h) {
+                handle = h;
+                pool.spawn(this);
+            }
+
+            void await_resume() const noexcept {
+            }
+
+            void run() override {
+                handle.resume();
+            }
+        };
+
+        class sleep_awaiter {
+        private:
+            executor &owner;
+            std::chrono::milliseconds delay;
+
+        public:
+            sleep_awaiter(executor &owner, std::chrono::milliseconds delay)
+                : owner(owner), delay(delay) {
+            }
+
+            bool await_ready() const noexcept {
+                return delay.count() <= 0;
+            }
+
+            void await_suspend(std::coroutine_handle<> h) {
+                std::call_once(owner.wheel_started,
+                               [this] { owner.wheel.start(); });
+                owner.wheel.add(delay, [h] { h.resume(); });
+            }
+
+            void await_resume() const noexcept {
+            }
+        };
+
+        executor(const executor &other) = delete;
+
+        executor(executor &&other) = delete;
+
+        executor &operator=(const executor &other) = delete;
+
+        executor &operator=(executor &&other) = delete;
+
+        explicit executor(sys::scheduler &pool) : pool(pool), wheel(&pool) {
+        }
+
+        // Coroutines still in sleep_for() are neither resumed nor
+        // destroyed: their frames belong to whoever awaits them, so wait
+        // for them to finish before the executor goes away.
+        ~executor() = default;
+
+        [[nodiscard]] schedule_awaiter schedule() const {
+            return schedule_awaiter(pool);
+        }
+
+        // resumes on a scheduler worker once delay has passed
+        [[nodiscard]] sleep_awaiter sleep_for(std::chrono::milliseconds delay) {
+            return {*this, delay};
+        }
+
+        // Starts t on the scheduler and lets it run to completion on its
+        // own; an exception escaping it terminates the process.
+        void spawn(task<void> t) {
+            [](executor &ex, task<void> t) -> detached {
+                co_await ex.schedule();
+                co_await t;
+            }(*this, std::move(t));
+        }
+
+        [[nodiscard]] sys::scheduler &scheduler() const {
+            return pool;
+        }
+    };
+} // namespace YanLib::coro
+#endif
+#endif // EXECUTOR_H
@@ -0,0 +1,251 @@
+/* clang-format off */
+/*
+ * @file io.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef CORO_IO_H
+#define CORO_IO_H
+#include "task.h"
+#if defined(YANLIB_HAS_COROUTINES) && defined(_WIN32)
+#include <WinSock2.h>
+#include <coroutine>
+#include <thread>
+#include "executor.h"
+#include "io/comp_port.h"
+#pragma comment(lib, "WS2_32.Lib")
+
+namespace YanLib::coro {
+    struct io_result {
+        uint32_t bytes = 0;
+        // Win32 error code, 0 on success
+        uint32_t error = 0;
+    };
+
+    // Awaitable overlapped I/O on a completion port. One thread waits on
+    // the port and hands each finished operation to the executor's
+    // scheduler, which resumes the coroutine that issued it. The port
+    // lives as long as the context, so handles stay attached across
+    // stop() and start().
+    class io_context {
+    private:
+        io::comp_port port{0};
+        executor &ex;
+        std::thread pump = {};
+        bool port_ready = false;
+
+        void pump_loop() {
+            while (true) {
+                uintptr_t key = 0;
+                uint32_t bytes = 0;
+                OVERLAPPED *overlapped = nullptr;
+                const bool is_ok =
+                        port.get_status(&key, &bytes, &overlapped, INFINITE);
+                if (!overlapped) {
+                    // stop() posts an empty packet; a failure without a
+                    // packet means the port is gone
+                    break;
+                }
+                auto *op = static_cast<operation *>(overlapped);
+                op->result.bytes = bytes;
+                op->result.error = is_ok ? 0 : GetLastError();
+                ex.scheduler().spawn(op);
+            }
+        }
+
+    public:
+        // OVERLAPPED first, so the pointer the port returns is the
+        // operation itself
+        class operation : public OVERLAPPED, public sys::task {
+        protected:
+            std::coroutine_handle<> handle = nullptr;
+            io_result result = {};
+
+            friend class io_context;
+
+            // starts the I/O, false with result.error set when it failed
+            // outright and no completion will be queued
+            virtual bool issue() = 0;
+
+        public:
+            operation() : OVERLAPPED() {
+            }
+
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            bool await_suspend(std::coroutine_handle<> h) {
+                handle = h;
+                // the completion may resume h on another thread before
+                // issue() returns, nothing here touches the frame after
+                return issue();
+            }
+
+            io_result await_resume() const noexcept {
+                return result;
+            }
+
+            void run() override {
+                handle.resume();
+            }
+        };
+
+        class file_operation : public operation {
+        private:
+            HANDLE file;
+            void *buffer;
+            uint32_t size;
+            bool is_write;
+
+            bool issue() override {
+                const BOOL is_ok = is_write
+                        ? WriteFile(file, buffer, size, nullptr, this)
+                        : ReadFile(file, buffer, size, nullptr, this);
+                if (!is_ok && GetLastError() != ERROR_IO_PENDING) {
+                    result.error = GetLastError();
+                    return false;
+                }
+                return true;
+            }
+
+        public:
+            file_operation(HANDLE file,
+                           void *buffer,
+                           uint32_t size,
+                           uint64_t offset,
+                           bool is_write)
+                : file(file), buffer(buffer), size(size), is_write(is_write) {
+                Offset = static_cast<DWORD>(offset);
+                OffsetHigh = static_cast<DWORD>(offset >> 32);
+            }
+        };
+
+        class socket_operation : public operation {
+        private:
+            SOCKET socket;
+            WSABUF buf;
+            bool is_send;
+
+            bool issue() override {
+                DWORD flags = 0;
+                const int rc = is_send
+                        ? WSASend(socket, &buf, 1, nullptr, 0, this, nullptr)
+                        : WSARecv(socket, &buf, 1, nullptr, &flags, this,
+                                  nullptr);
+                if (rc == SOCKET_ERROR && WSAGetLastError() != WSA_IO_PENDING) {
+                    result.error = static_cast<uint32_t>(WSAGetLastError());
+                    return false;
+                }
+                return true;
+            }
+
+        public:
+            socket_operation(SOCKET socket,
+                             void *buffer,
+                             uint32_t size,
+                             bool is_send)
+                : socket(socket),
+                  buf{size, static_cast<char *>(buffer)},
+                  is_send(is_send) {
+            }
+        };
+
+        io_context(const io_context &other) = delete;
+
+        io_context(io_context &&other) = delete;
+
+        io_context &operator=(const io_context &other) = delete;
+
+        io_context &operator=(io_context &&other) = delete;
+
+        // err_code() tells why when the port could not be created, start()
+        // and attach() then fail
+        explicit io_context(executor &ex) : ex(ex) {
+            port_ready = port.create();
+        }
+
+        // operations still in flight are left suspended, their frames are
+        // not destroyed
+        ~io_context() {
+            stop();
+        }
+
+        // false when already running or without a port
+        bool start() {
+            if (pump.joinable() || !port_ready) {
+                return false;
+            }
+            pump = std::thread(&io_context::pump_loop, this);
+            return true;
+        }
+
+        // operations still in flight stay queued on the port and resume
+        // after the next start()
+        void stop() {
+            if (pump.joinable()) {
+                port.post_status(0);
+                pump.join();
+            }
+        }
+
+        // file must have been opened with FILE_FLAG_OVERLAPPED; works
+        // before start(), a handle stays attached until it is closed
+        bool attach(HANDLE file) {
+            return port_ready && port.associate_device(file, 0);
+        }
+
+        bool attach(SOCKET socket) {
+            return port_ready && port.associate_socket(socket, 0);
+        }
+
+        [[nodiscard]] file_operation
+        read(HANDLE file, void *buffer, uint32_t size, uint64_t offset) {
+            return {file, buffer, size, offset, false};
+        }
+
+        [[nodiscard]] file_operation write(HANDLE file,
+                                           const void *buffer,
+                                           uint32_t size,
+                                           uint64_t offset) {
+            return {file, const_cast<void *>(buffer), size, offset, true};
+        }
+
+        [[nodiscard]] socket_operation
+        recv(SOCKET socket, void *buffer, uint32_t size) {
+            return {socket, buffer, size, false};
+        }
+
+        [[nodiscard]] socket_operation
+        send(SOCKET socket, const void *buffer, uint32_t size) {
+            return {socket, const_cast<void *>(buffer), size, true};
+        }
+
+        [[nodiscard]] uint32_t err_code() const {
+            return port.err_code();
+        }
+    };
+} // namespace YanLib::coro
+#endif
+#endif // CORO_IO_H
@@ -0,0 +1,302 @@
+/* clang-format off */
+/*
+ * @file task.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef TASK_H
+#define TASK_H
+// The library itself builds as C++17; everything under coro/ switches on
+// once the including translation unit compiles with coroutine support
+// (/std:c++20 or -std=c++20).
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define YANLIB_HAS_COROUTINES 1
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace YanLib::coro {
+    template <typename T = void>
+    class task;
+
+    class promise_base {
+    private:
+        // resumed when the coroutine finishes, by symmetric transfer so
+        // long co_await chains do not grow the stack
+        std::coroutine_handle<> continuation = std::noop_coroutine();
+
+        struct final_awaiter {
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            template <typename P>
+            std::coroutine_handle<>
+            await_suspend(std::coroutine_handle<P> h) const noexcept {
+                return h.promise().continuation;
+            }
+
+            void await_resume() const noexcept {
+            }
+        };
+
+        template <typename T>
+        friend class task;
+
+    protected:
+        std::exception_ptr error = nullptr;
+
+    public:
+        std::suspend_always initial_suspend() const noexcept {
+            return {};
+        }
+
+        final_awaiter final_suspend() const noexcept {
+            return {};
+        }
+
+        void unhandled_exception() noexcept {
+            error = std::current_exception();
+        }
+    };
+
+    template <typename T>
+    class task_promise : public promise_base {
+    private:
+        std::optional<T> value = std::nullopt;
+
+    public:
+        task<T> get_return_object() noexcept;
+
+        template <typename U>
+        void return_value(U &&result) {
+            value.emplace(std::forward<U>(result));
+        }
+
+        T result() {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            return std::move(*value);
+        }
+    };
+
+    template <>
+    class task_promise<void> : public promise_base {
+    public:
+        task<void> get_return_object() noexcept;
+
+        void return_void() const noexcept {
+        }
+
+        void result() const {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    };
+
+    // Lazily started coroutine: nothing runs until the task is awaited
+    // (or handed to sync_wait / executor::spawn), and the awaiting
+    // coroutine is resumed right where the task finishes.
+    template <typename T>
+    class [[nodiscard]] task {
+    public:
+        using promise_type = task_promise<T>;
+
+    private:
+        std::coroutine_handle<promise_type> handle = nullptr;
+
+        struct awaiter {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept {
+                return !handle || handle.done();
+            }
+
+            std::coroutine_handle<>
+            await_suspend(std::coroutine_handle<> awaiting) const noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume() const {
+                return handle.promise().result();
+            }
+        };
+
+        // as awaiter, but leaves the result in the promise
+        struct ready_awaiter : awaiter {
+            void await_resume() const noexcept {
+            }
+        };
+
+        [[nodiscard]] ready_awaiter when_ready() const noexcept {
+            return ready_awaiter{{handle}};
+        }
+
+        template <typename U>
+        friend U sync_wait(task<U> t);
+
+    public:
+        task(const task &other) = delete;
+
+        task &operator=(const task &other) = delete;
+
+        task() = default;
+
+        explicit task(std::coroutine_handle<promise_type> handle) noexcept
+            : handle(handle) {
+        }
+
+        task(task &&other) noexcept
+            : handle(std::exchange(other.handle, nullptr)) {
+        }
+
+        task &operator=(task &&other) noexcept {
+            if (this != &other) {
+                if (handle) {
+                    handle.destroy();
+                }
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+
+        ~task() {
+            if (handle) {
+                handle.destroy();
+            }
+        }
+
+        awaiter operator co_await() const noexcept {
+            return awaiter{handle};
+        }
+
+        [[nodiscard]] bool done() const {
+            return !handle || handle.done();
+        }
+    };
+
+    template <typename T>
+    task<T> task_promise<T>::get_return_object() noexcept {
+        return task<T>(std::coroutine_handle<task_promise>::from_promise(*this));
+    }
+
+    inline task<void> task_promise<void>::get_return_object() noexcept {
+        return task<void>(
+                std::coroutine_handle<task_promise>::from_promise(*this));
+    }
+
+    // Coroutine that runs eagerly and tells a blocked thread when it is
+    // done; the frame is freed by whoever holds it.
+    class sync_waiter {
+    public:
+        struct promise_type {
+            std::mutex mutex = {};
+            std::condition_variable cv = {};
+            bool done = false;
+
+            struct final_awaiter {
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                void await_suspend(
+                        std::coroutine_handle<promise_type> h) const noexcept {
+                    promise_type &p = h.promise();
+                    // notify under the lock, sync_wait frees the frame as
+                    // soon as it sees done
+                    std::lock_guard<std::mutex> lock(p.mutex);
+                    p.done = true;
+                    p.cv.notify_all();
+                }
+
+                void await_resume() const noexcept {
+                }
+            };
+
+            sync_waiter get_return_object() noexcept {
+                return sync_waiter(
+                        std::coroutine_handle<promise_type>::from_promise(
+                                *this));
+            }
+
+            std::suspend_never initial_suspend() const noexcept {
+                return {};
+            }
+
+            final_awaiter final_suspend() const noexcept {
+                return {};
+            }
+
+            void return_void() const noexcept {
+            }
+
+            void unhandled_exception() const noexcept {
+                // the awaited task keeps its own exception, nothing is
+                // thrown past it
+                std::terminate();
+            }
+        };
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+
+    public:
+        sync_waiter(const sync_waiter &other) = delete;
+
+        sync_waiter &operator=(const sync_waiter &other) = delete;
+
+        explicit sync_waiter(std::coroutine_handle<promise_type> handle)
+            : handle(handle) {
+        }
+
+        ~sync_waiter() {
+            handle.destroy();
+        }
+
+        void wait() const {
+            promise_type &p = handle.promise();
+            std::unique_lock<std::mutex> lock(p.mutex);
+            p.cv.wait(lock, [&p] { return p.done; });
+        }
+    };
+
+    // Blocks the calling thread until t has finished and returns its
+    // result. Not for use on a scheduler worker that t needs to run on.
+    template <typename T>
+    T sync_wait(task<T> t) {
+        [](task<T> &t) -> sync_waiter {
+            co_await t.when_ready();
+        }(t).wait();
+        return t.handle.promise().result();
+    }
+} // namespace YanLib::coro
+#endif
+#endif // TASK_H
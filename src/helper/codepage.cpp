@@ -0,0 +1,692 @@
+/* clang-format off */
+/*
+ * @file codepage.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "codepage.h"
+#include <algorithm>
+#include <array>
+#include <vector>
+#include "codepage_tables.h"
+#include "utf.h"
+
+namespace YanLib::helper {
+    namespace {
+        constexpr uint32_t INVALID = UINT32_MAX;
+        constexpr char16_t REPLACEMENT = 0xFFFD;
+        // linear four-byte index of GB18030 0x90308130, i.e. U+10000
+        constexpr uint32_t GB18030_SUPPLEMENTARY = 189000;
+        constexpr uint32_t GB18030_BMP_END = 39420;
+
+        enum class Kind { None, Sbcs, Gbk, Gb18030, Big5 };
+
+        struct codec {
+            Kind kind = Kind::None;
+            const char16_t *sbcs = nullptr;
+            size_t sbcs_index = 0;
+        };
+
+        const char16_t *const SBCS_TABLES[] = {
+                WIN1250_TABLE, WIN1251_TABLE, WIN1252_TABLE,
+                WIN1253_TABLE, WIN1254_TABLE, WIN1255_TABLE,
+                WIN1256_TABLE, WIN1257_TABLE, WIN1258_TABLE,
+        };
+
+        codec find_codec(const uint32_t code_page) {
+            if (code_page >= 1250 && code_page <= 1258) {
+                const size_t index = code_page - 1250;
+                return {Kind::Sbcs, SBCS_TABLES[index], index};
+            }
+            switch (code_page) {
+                case 936:
+                    return {Kind::Gbk};
+                case 54936:
+                    return {Kind::Gb18030};
+                case 950:
+                    return {Kind::Big5};
+                default:
+                    return {};
+            }
+        }
+
+        // UTF-16 unit -> code, two levels: the high byte picks a page of
+        // 256 entries, page 0 is the shared empty one
+        template <typename T> class reverse_table {
+        private:
+            uint16_t index[256] = {};
+            std::vector<T> pages = std::vector<T>(256);
+
+        public:
+            void set(const char16_t unit, const T value) {
+                uint16_t &page = index[unit >> 8];
+                if (!page) {
+                    page = static_cast<uint16_t>(pages.size() / 256);
+                    pages.resize(pages.size() + 256);
+                }
+                T &slot = pages[page * 256 + (unit & 0xFF)];
+                if (!slot) {
+                    slot = value;
+                }
+            }
+
+            T get(const char16_t unit) const {
+                return pages[index[unit >> 8] * 256 + (unit & 0xFF)];
+            }
+        };
+
+        uint16_t dbcs_code(const size_t slot) {
+            return static_cast<uint16_t>(
+                    ((slot / DBCS_TRAIL_COUNT + DBCS_LEAD_MIN) << 8) |
+                    (slot % DBCS_TRAIL_COUNT + DBCS_TRAIL_MIN));
+        }
+
+        const reverse_table<uint8_t> &sbcs_reverse(const size_t index) {
+            static const auto tables = [] {
+                std::array<reverse_table<uint8_t>, 9> result;
+                for (size_t i = 0; i < result.size(); ++i) {
+                    for (size_t byte = 0; byte < 128; ++byte) {
+                        if (const char16_t unit = SBCS_TABLES[i][byte]) {
+                            result[i].set(unit,
+                                          static_cast<uint8_t>(byte + 0x80));
+                        }
+                    }
+                }
+                return result;
+            }();
+            return tables[index];
+        }
+
+        const reverse_table<uint16_t> &gb18030_reverse() {
+            static const auto table = [] {
+                reverse_table<uint16_t> result;
+                for (size_t slot = 0; slot < DBCS_SLOTS; ++slot) {
+                    if (const char16_t unit = GB18030_TABLE[slot]) {
+                        result.set(unit, dbcs_code(slot));
+                    }
+                }
+                return result;
+            }();
+            return table;
+        }
+
+        const reverse_table<uint16_t> &big5_reverse() {
+            static const auto table = [] {
+                reverse_table<uint16_t> result;
+                const uint16_t *one_way_end = BIG5_ONE_WAY + BIG5_ONE_WAY_COUNT;
+                for (size_t slot = 0; slot < DBCS_SLOTS; ++slot) {
+                    const char16_t unit = BIG5_TABLE[slot];
+                    const uint16_t code = dbcs_code(slot);
+                    if (unit &&
+                        std::find(BIG5_ONE_WAY, one_way_end, code) ==
+                                one_way_end) {
+                        result.set(unit, code);
+                    }
+                }
+                for (size_t i = 0; i < BIG5_ENCODE_ONLY_COUNT; ++i) {
+                    result.set(BIG5_ENCODE_ONLY[i][0], BIG5_ENCODE_ONLY[i][1]);
+                }
+                return result;
+            }();
+            return table;
+        }
+
+        bool in_gbk(const size_t slot) {
+            return GBK_MASK[slot / 8] & (1U << (slot % 8));
+        }
+
+        struct step {
+            size_t bytes;       // 0: the input ends inside the sequence
+            uint32_t code_point; // INVALID when unmapped
+        };
+
+        uint32_t gb18030_four_byte(const uint8_t *str) {
+            const uint32_t linear =
+                    (((str[0] - 0x81U) * 10 + str[1] - 0x30U) * 126 + str[2] -
+                     0x81U) * 10 +
+                    str[3] - 0x30U;
+            if (linear < GB18030_BMP_END) {
+                const gb18030_range *end =
+                        GB18030_RANGES + GB18030_RANGE_COUNT;
+                const gb18030_range *range = std::upper_bound(
+                        GB18030_RANGES, end, linear,
+                        [](const uint32_t value, const gb18030_range &r) {
+                            return value < r.linear;
+                        });
+                --range;
+                return range->unicode + (linear - range->linear);
+            }
+            if (linear >= GB18030_SUPPLEMENTARY &&
+                linear < GB18030_SUPPLEMENTARY + 0x100000) {
+                return 0x10000 + (linear - GB18030_SUPPLEMENTARY);
+            }
+            return INVALID;
+        }
+
+        // one non-ASCII sequence at str
+        step decode_step(const codec &c, const uint8_t *str, const size_t len) {
+            const uint8_t lead = str[0];
+            if (c.kind == Kind::Sbcs) {
+                const char16_t unit = c.sbcs[lead - 0x80];
+                return {1, unit ? unit : INVALID};
+            }
+            if (c.kind == Kind::Gbk && lead == 0x80) {
+                return {1, 0x20AC};
+            }
+            if (lead < DBCS_LEAD_MIN || lead > DBCS_LEAD_MAX) {
+                return {1, INVALID};
+            }
+            if (len < 2) {
+                return {0, INVALID};
+            }
+            const uint8_t trail = str[1];
+            if (c.kind == Kind::Gb18030 && trail >= 0x30 && trail <= 0x39) {
+                if (len >= 3 && (str[2] < 0x81 || str[2] > 0xFE)) {
+                    return {1, INVALID};
+                }
+                if (len < 4) {
+                    return {0, INVALID};
+                }
+                if (str[3] < 0x30 || str[3] > 0x39) {
+                    return {1, INVALID};
+                }
+                return {4, gb18030_four_byte(str)};
+            }
+            bool valid_trail = trail >= DBCS_TRAIL_MIN &&
+                    trail <= DBCS_TRAIL_MAX && trail != 0x7F;
+            if (c.kind == Kind::Big5) {
+                valid_trail = valid_trail && (trail <= 0x7E || trail >= 0xA1);
+            }
+            if (!valid_trail) {
+                // leave the trail byte, it may start the next character
+                return {1, INVALID};
+            }
+            const size_t slot = (lead - DBCS_LEAD_MIN) * DBCS_TRAIL_COUNT +
+                    (trail - DBCS_TRAIL_MIN);
+            char16_t unit = 0;
+            if (c.kind == Kind::Big5) {
+                unit = BIG5_TABLE[slot];
+            } else if (c.kind == Kind::Gb18030 || in_gbk(slot)) {
+                unit = GB18030_TABLE[slot];
+            }
+            return {2, unit ? unit : INVALID};
+        }
+
+        // one character, returns the bytes written to out or 0 if unmapped
+        size_t encode_step(const codec &c, const uint32_t code_point,
+                           uint8_t out[4]) {
+            if (code_point < 0x10000 && c.kind == Kind::Sbcs) {
+                out[0] = sbcs_reverse(c.sbcs_index)
+                                 .get(static_cast<char16_t>(code_point));
+                return out[0] ? 1 : 0;
+            }
+            if (c.kind == Kind::Gbk && code_point == 0x20AC) {
+                out[0] = 0x80;
+                return 1;
+            }
+            uint16_t code = 0;
+            if (code_point < 0x10000) {
+                const auto unit = static_cast<char16_t>(code_point);
+                if (c.kind == Kind::Big5) {
+                    code = big5_reverse().get(unit);
+                } else if (c.kind == Kind::Gbk || c.kind == Kind::Gb18030) {
+                    code = gb18030_reverse().get(unit);
+                    if (code && c.kind == Kind::Gbk &&
+                        !in_gbk(((code >> 8) - DBCS_LEAD_MIN) *
+                                        DBCS_TRAIL_COUNT +
+                                ((code & 0xFF) - DBCS_TRAIL_MIN))) {
+                        code = 0;
+                    }
+                }
+            }
+            if (code) {
+                out[0] = static_cast<uint8_t>(code >> 8);
+                out[1] = static_cast<uint8_t>(code);
+                return 2;
+            }
+            if (c.kind != Kind::Gb18030) {
+                return 0;
+            }
+            uint32_t linear;
+            if (code_point >= 0x10000) {
+                linear = GB18030_SUPPLEMENTARY + (code_point - 0x10000);
+            } else {
+                const gb18030_range *end =
+                        GB18030_RANGES + GB18030_RANGE_COUNT;
+                const gb18030_range *range = std::upper_bound(
+                        GB18030_RANGES, end, code_point,
+                        [](const uint32_t value, const gb18030_range &r) {
+                            return value < r.unicode;
+                        });
+                --range;
+                linear = range->linear + (code_point - range->unicode);
+            }
+            out[3] = static_cast<uint8_t>(linear % 10 + 0x30);
+            linear /= 10;
+            out[2] = static_cast<uint8_t>(linear % 126 + 0x81);
+            linear /= 126;
+            out[1] = static_cast<uint8_t>(linear % 10 + 0x30);
+            out[0] = static_cast<uint8_t>(linear / 10 + 0x81);
+            return 4;
+        }
+
+        size_t put_code_point(const uint32_t code_point, char16_t *out) {
+            if (code_point < 0x10000) {
+                out[0] = static_cast<char16_t>(code_point);
+                return 1;
+            }
+            out[0] = static_cast<char16_t>(0xD7C0 + (code_point >> 10));
+            out[1] = static_cast<char16_t>(0xDC00 | (code_point & 0x3FF));
+            return 2;
+        }
+
+        // the common two-byte case, 0 if it needs the full decode_step
+        char16_t dbcs_unit(const codec &c,
+                           const uint8_t lead,
+                           const uint8_t trail) {
+            if (lead < DBCS_LEAD_MIN || lead > DBCS_LEAD_MAX ||
+                trail < DBCS_TRAIL_MIN || trail > DBCS_TRAIL_MAX ||
+                trail == 0x7F) {
+                return 0;
+            }
+            const size_t slot = (lead - DBCS_LEAD_MIN) * DBCS_TRAIL_COUNT +
+                    (trail - DBCS_TRAIL_MIN);
+            switch (c.kind) {
+                case Kind::Gbk:
+                    return in_gbk(slot) ? GB18030_TABLE[slot] : 0;
+                case Kind::Gb18030:
+                    return GB18030_TABLE[slot];
+                case Kind::Big5:
+                    return trail <= 0x7E || trail >= 0xA1 ? BIG5_TABLE[slot]
+                                                          : 0;
+                default:
+                    return 0;
+            }
+        }
+
+        // buf == nullptr only measures
+        size_t decode_impl(const codec &c,
+                           const uint8_t *str,
+                           const size_t len,
+                           char16_t *buf,
+                           const size_t buf_len) {
+            if (c.kind == Kind::Sbcs) {
+                // one unit per byte, no need to look for ASCII runs
+                if (buf && buf_len < len) {
+                    return codepage::npos;
+                }
+                for (size_t i = 0; i < len; ++i) {
+                    const uint8_t byte = str[i];
+                    const char16_t unit =
+                            byte < 0x80 ? byte : c.sbcs[byte - 0x80];
+                    if (!unit && byte) {
+                        return codepage::npos;
+                    }
+                    if (buf) {
+                        buf[i] = unit;
+                    }
+                }
+                return len;
+            }
+            size_t i = 0;
+            size_t written = 0;
+            while (i < len) {
+                const uint8_t lead = str[i];
+                if (lead < 0x80) {
+                    // short runs inline, long ones with the vectorised scan
+                    size_t ascii = 1;
+                    while (ascii < 16 && i + ascii < len &&
+                           str[i + ascii] < 0x80) {
+                        ++ascii;
+                    }
+                    if (ascii == 16) {
+                        ascii += utf::ascii_length(
+                                reinterpret_cast<const char *>(str + i + 16),
+                                len - i - 16);
+                    }
+                    if (buf) {
+                        if (buf_len - written < ascii) {
+                            return codepage::npos;
+                        }
+                        if (ascii < 16) {
+                            std::copy(str + i, str + i + ascii, buf + written);
+                        } else {
+                            // ASCII is valid UTF-8, a vectorised widening copy
+                            utf::utf8_to_utf16(
+                                    reinterpret_cast<const char *>(str + i),
+                                    ascii, buf + written, ascii);
+                        }
+                    }
+                    i += ascii;
+                    written += ascii;
+                    continue;
+                }
+                const char16_t unit =
+                        i + 1 < len ? dbcs_unit(c, lead, str[i + 1]) : 0;
+                if (unit) {
+                    if (buf) {
+                        if (written == buf_len) {
+                            return codepage::npos;
+                        }
+                        buf[written] = unit;
+                    }
+                    i += 2;
+                    ++written;
+                    continue;
+                }
+                const step s = decode_step(c, str + i, len - i);
+                if (!s.bytes || s.code_point == INVALID) {
+                    return codepage::npos;
+                }
+                char16_t units[2];
+                const size_t count = put_code_point(s.code_point, units);
+                if (buf) {
+                    if (buf_len - written < count) {
+                        return codepage::npos;
+                    }
+                    std::copy(units, units + count, buf + written);
+                }
+                i += s.bytes;
+                written += count;
+            }
+            return written;
+        }
+
+        size_t encode_impl(const codec &c,
+                           const char16_t *str,
+                           const size_t len,
+                           uint8_t *buf,
+                           const size_t buf_len) {
+            if (c.kind == Kind::Sbcs) {
+                const reverse_table<uint8_t> &table =
+                        sbcs_reverse(c.sbcs_index);
+                if (buf && buf_len < len) {
+                    return codepage::npos;
+                }
+                for (size_t i = 0; i < len; ++i) {
+                    const char16_t unit = str[i];
+                    const uint8_t byte = unit < 0x80
+                            ? static_cast<uint8_t>(unit)
+                            : table.get(unit);
+                    if (!byte && unit) {
+                        return codepage::npos;
+                    }
+                    if (buf) {
+                        buf[i] = byte;
+                    }
+                }
+                return len;
+            }
+            size_t i = 0;
+            size_t written = 0;
+            while (i < len) {
+                if (str[i] < 0x80) {
+                    size_t ascii = 1;
+                    while (ascii < 16 && i + ascii < len &&
+                           str[i + ascii] < 0x80) {
+                        ++ascii;
+                    }
+                    if (ascii == 16) {
+                        ascii += utf::ascii_length(str + i + 16, len - i - 16);
+                    }
+                    if (buf) {
+                        if (buf_len - written < ascii) {
+                            return codepage::npos;
+                        }
+                        if (ascii < 16) {
+                            for (size_t j = 0; j < ascii; ++j) {
+                                buf[written + j] =
+                                        static_cast<uint8_t>(str[i + j]);
+                            }
+                        } else {
+                            utf::utf16_to_utf8(str + i, ascii,
+                                               reinterpret_cast<char *>(buf) +
+                                                       written,
+                                               ascii);
+                        }
+                    }
+                    i += ascii;
+                    written += ascii;
+                    continue;
+                }
+                uint32_t code_point = str[i];
+                size_t used = 1;
+                if (code_point >= 0xD800 && code_point <= 0xDFFF) {
+                    if (code_point > 0xDBFF || i + 1 >= len ||
+                        str[i + 1] < 0xDC00 || str[i + 1] > 0xDFFF) {
+                        return codepage::npos;
+                    }
+                    code_point = 0x10000 + ((code_point - 0xD800) << 10) +
+                            (str[i + 1] - 0xDC00);
+                    used = 2;
+                }
+                uint8_t bytes[4];
+                const size_t count = encode_step(c, code_point, bytes);
+                if (!count) {
+                    return codepage::npos;
+                }
+                if (buf) {
+                    if (buf_len - written < count) {
+                        return codepage::npos;
+                    }
+                    std::copy(bytes, bytes + count, buf + written);
+                }
+                i += used;
+                written += count;
+            }
+            return written;
+        }
+    } // namespace
+
+    bool codepage::is_supported(const uint32_t code_page) {
+        return find_codec(code_page).kind != Kind::None;
+    }
+
+    size_t codepage::decode_length(const uint32_t code_page,
+                                   const char *str,
+                                   const size_t len) {
+        const codec c = find_codec(code_page);
+        if (c.kind == Kind::None || (!str && len)) {
+            return npos;
+        }
+        return decode_impl(c, reinterpret_cast<const uint8_t *>(str), len,
+                           nullptr, 0);
+    }
+
+    size_t codepage::decode(const uint32_t code_page,
+                            const char *str,
+                            const size_t len,
+                            char16_t *buf,
+                            const size_t buf_len) {
+        const codec c = find_codec(code_page);
+        if (c.kind == Kind::None || (!str && len) || !buf) {
+            return npos;
+        }
+        return decode_impl(c, reinterpret_cast<const uint8_t *>(str), len, buf,
+                           buf_len);
+    }
+
+    size_t codepage::encode_length(const uint32_t code_page,
+                                   const char16_t *str,
+                                   const size_t len) {
+        const codec c = find_codec(code_page);
+        if (c.kind == Kind::None || (!str && len)) {
+            return npos;
+        }
+        return encode_impl(c, str, len, nullptr, 0);
+    }
+
+    size_t codepage::encode(const uint32_t code_page,
+                            const char16_t *str,
+                            const size_t len,
+                            char *buf,
+                            const size_t buf_len) {
+        const codec c = find_codec(code_page);
+        if (c.kind == Kind::None || (!str && len) || !buf) {
+            return npos;
+        }
+        return encode_impl(c, str, len, reinterpret_cast<uint8_t *>(buf),
+                           buf_len);
+    }
+
+#if WCHAR_MAX <= 0xFFFF
+    size_t codepage::decode(const uint32_t code_page,
+                            const char *str,
+                            const size_t len,
+                            wchar_t *buf,
+                            const size_t buf_len) {
+        return decode(code_page, str, len, reinterpret_cast<char16_t *>(buf),
+                      buf_len);
+    }
+
+    size_t codepage::encode_length(const uint32_t code_page,
+                                   const wchar_t *str,
+                                   const size_t len) {
+        return encode_length(code_page,
+                             reinterpret_cast<const char16_t *>(str), len);
+    }
+
+    size_t codepage::encode(const uint32_t code_page,
+                            const wchar_t *str,
+                            const size_t len,
+                            char *buf,
+                            const size_t buf_len) {
+        return encode(code_page, reinterpret_cast<const char16_t *>(str), len,
+                      buf, buf_len);
+    }
+#endif
+
+    codepage_decoder::codepage_decoder(const uint32_t code_page)
+        : code_page(code_page) {
+    }
+
+    bool codepage_decoder::is_ok() const {
+        return codepage::is_supported(code_page);
+    }
+
+    size_t codepage_decoder::drain(char16_t *buf,
+                                   const size_t buf_len,
+                                   const bool flush) {
+        const codec c = find_codec(code_page);
+        size_t written = 0;
+        while (pending_len) {
+            step s = {1, pending[0]};
+            if (pending[0] >= 0x80) {
+                s = decode_step(c, pending, pending_len);
+            }
+            if (!s.bytes) {
+                if (!flush) {
+                    break;
+                }
+                // truncated at the end of the input
+                s = {pending_len, INVALID};
+            }
+            char16_t units[2] = {REPLACEMENT};
+            const size_t count = s.code_point == INVALID
+                    ? 1
+                    : put_code_point(s.code_point, units);
+            if (buf_len - written < count) {
+                break;
+            }
+            std::copy(units, units + count, buf + written);
+            written += count;
+            pending_len -= s.bytes;
+            std::copy(pending + s.bytes, pending + s.bytes + pending_len,
+                      pending);
+        }
+        return written;
+    }
+
+    size_t codepage_decoder::decode(const char *str,
+                                    const size_t len,
+                                    char16_t *buf,
+                                    const size_t buf_len,
+                                    size_t *consumed) {
+        const codec c = find_codec(code_page);
+        const auto *src = reinterpret_cast<const uint8_t *>(str);
+        size_t i = 0;
+        size_t written = 0;
+        if (consumed) {
+            *consumed = 0;
+        }
+        if (c.kind == Kind::None || !buf || (!str && len)) {
+            return 0;
+        }
+        // complete a sequence held back from the previous chunk first
+        while (pending_len) {
+            written += drain(buf + written, buf_len - written, false);
+            if (!pending_len || i == len || pending_len == sizeof(pending)) {
+                break;
+            }
+            pending[pending_len++] = src[i++];
+        }
+        while (i < len && !pending_len) {
+            const size_t room = buf_len - written;
+            const size_t ascii = std::min(
+                    utf::ascii_length(str + i, len - i), room);
+            if (ascii) {
+                utf::utf8_to_utf16(str + i, ascii, buf + written, ascii);
+                i += ascii;
+                written += ascii;
+                continue;
+            }
+            if (src[i] < 0x80) {
+                break; // buf is full
+            }
+            const step s = decode_step(c, src + i, len - i);
+            if (!s.bytes) {
+                // cut off at the end of the chunk, keep it for the next one
+                pending_len = len - i;
+                std::copy(src + i, src + len, pending);
+                i = len;
+                break;
+            }
+            char16_t units[2] = {REPLACEMENT};
+            const size_t count = s.code_point == INVALID
+                    ? 1
+                    : put_code_point(s.code_point, units);
+            if (room < count) {
+                break;
+            }
+            std::copy(units, units + count, buf + written);
+            i += s.bytes;
+            written += count;
+        }
+        if (consumed) {
+            *consumed = i;
+        }
+        return written;
+    }
+
+    size_t codepage_decoder::finish(char16_t *buf, const size_t buf_len) {
+        if (!buf) {
+            return 0;
+        }
+        return drain(buf, buf_len, true);
+    }
+
+    void codepage_decoder::reset() {
+        pending_len = 0;
+    }
+} // namespace YanLib::helper
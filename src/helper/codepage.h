@@ -0,0 +1,139 @@
+/* clang-format off */
+/*
+ * @file codepage.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef CODEPAGE_H
+#define CODEPAGE_H
+#include <cstddef>
+#include <cstdint>
+#include <cwchar>
+
+namespace YanLib::helper {
+    // Table-driven transcoder for the code pages that legacy Chinese and
+    // Windows files use most: GBK (936), GB18030 (54936), Big5 (950) and
+    // WIN1250-WIN1258. Code pages are the numeric CodePage values. It does
+    // not call the OS, so it works the same on every platform.
+    class codepage {
+    public:
+        static constexpr size_t npos = SIZE_MAX;
+
+        codepage(const codepage &other) = delete;
+
+        codepage(codepage &&other) = delete;
+
+        codepage &operator=(const codepage &other) = delete;
+
+        codepage &operator=(codepage &&other) = delete;
+
+        codepage() = delete;
+
+        ~codepage() = delete;
+
+        static bool is_supported(uint32_t code_page);
+
+        // The one-shot functions are strict: they return npos if the input
+        // holds a byte sequence or character that code_page does not map,
+        // or if buf_len is too small. No terminating NUL is written.
+        static size_t
+        decode_length(uint32_t code_page, const char *str, size_t len);
+
+        static size_t decode(uint32_t code_page,
+                             const char *str,
+                             size_t len,
+                             char16_t *buf,
+                             size_t buf_len);
+
+        static size_t
+        encode_length(uint32_t code_page, const char16_t *str, size_t len);
+
+        static size_t encode(uint32_t code_page,
+                             const char16_t *str,
+                             size_t len,
+                             char *buf,
+                             size_t buf_len);
+
+#if WCHAR_MAX <= 0xFFFF
+        static size_t decode(uint32_t code_page,
+                             const char *str,
+                             size_t len,
+                             wchar_t *buf,
+                             size_t buf_len);
+
+        static size_t
+        encode_length(uint32_t code_page, const wchar_t *str, size_t len);
+
+        static size_t encode(uint32_t code_page,
+                             const wchar_t *str,
+                             size_t len,
+                             char *buf,
+                             size_t buf_len);
+#endif
+    };
+
+    // Streaming decoder for input that arrives in chunks. A multi-byte
+    // sequence cut off at the end of a chunk is held back and completed by
+    // the next call; invalid or unmapped input becomes U+FFFD.
+    class codepage_decoder {
+    private:
+        uint32_t code_page = 0;
+        uint8_t pending[4] = {};
+        size_t pending_len = 0;
+
+        size_t drain(char16_t *buf, size_t buf_len, bool flush);
+
+    public:
+        codepage_decoder(const codepage_decoder &other) = delete;
+
+        codepage_decoder(codepage_decoder &&other) = delete;
+
+        codepage_decoder &operator=(const codepage_decoder &other) = delete;
+
+        codepage_decoder &operator=(codepage_decoder &&other) = delete;
+
+        codepage_decoder() = delete;
+
+        explicit codepage_decoder(uint32_t code_page);
+
+        ~codepage_decoder() = default;
+
+        [[nodiscard]] bool is_ok() const;
+
+        // Returns the units written to buf. Stops early when buf is full,
+        // consumed then tells how much of str was taken (held-back bytes
+        // count as taken). buf_len must be at least 2.
+        size_t decode(const char *str,
+                      size_t len,
+                      char16_t *buf,
+                      size_t buf_len,
+                      size_t *consumed = nullptr);
+
+        // end of input: emits whatever is still held back
+        size_t finish(char16_t *buf, size_t buf_len);
+
+        void reset();
+    };
+} // namespace YanLib::helper
+#endif // CODEPAGE_H
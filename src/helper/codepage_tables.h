@@ -0,0 +1,79 @@
+/* clang-format off */
+/*
+ * @file codepage_tables.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef CODEPAGE_TABLES_H
+#define CODEPAGE_TABLES_H
+#include <cstddef>
+#include <cstdint>
+
+namespace YanLib::helper {
+    // The two-byte area shared by GBK, GB18030 and Big5: lead 0x81-0xFE,
+    // trail 0x40-0xFE, one UTF-16 unit per slot and 0 where unmapped.
+    constexpr uint32_t DBCS_LEAD_MIN = 0x81;
+    constexpr uint32_t DBCS_LEAD_MAX = 0xFE;
+    constexpr uint32_t DBCS_TRAIL_MIN = 0x40;
+    constexpr uint32_t DBCS_TRAIL_MAX = 0xFE;
+    constexpr size_t DBCS_TRAIL_COUNT = DBCS_TRAIL_MAX - DBCS_TRAIL_MIN + 1;
+    constexpr size_t DBCS_SLOTS =
+            (DBCS_LEAD_MAX - DBCS_LEAD_MIN + 1) * DBCS_TRAIL_COUNT;
+
+    // a run of BMP characters that GB18030 encodes with four bytes, starting
+    // at unicode and at the linear four-byte index linear
+    struct gb18030_range {
+        uint16_t unicode;
+        uint32_t linear;
+    };
+
+    // 0x80-0xFF of the Windows single-byte code pages, 0 where undefined
+    extern const char16_t WIN1250_TABLE[128];
+    extern const char16_t WIN1251_TABLE[128];
+    extern const char16_t WIN1252_TABLE[128];
+    extern const char16_t WIN1253_TABLE[128];
+    extern const char16_t WIN1254_TABLE[128];
+    extern const char16_t WIN1255_TABLE[128];
+    extern const char16_t WIN1256_TABLE[128];
+    extern const char16_t WIN1257_TABLE[128];
+    extern const char16_t WIN1258_TABLE[128];
+
+    extern const char16_t GB18030_TABLE[DBCS_SLOTS];
+    // GBK (code page 936) is a subset of the GB18030 two-byte area, a set
+    // bit marks a slot that GBK defines as well
+    extern const uint8_t GBK_MASK[(DBCS_SLOTS + 7) / 8];
+    extern const gb18030_range GB18030_RANGES[];
+    extern const size_t GB18030_RANGE_COUNT;
+
+    extern const char16_t BIG5_TABLE[DBCS_SLOTS];
+    // Big5 codes that decode, but are not produced by the encoder because
+    // the character has a preferred code elsewhere
+    extern const uint16_t BIG5_ONE_WAY[];
+    extern const size_t BIG5_ONE_WAY_COUNT;
+    // {unit, code} pairs the encoder uses although code decodes to another
+    // character (best-fit mappings of code page 950)
+    extern const uint16_t BIG5_ENCODE_ONLY[][2];
+    extern const size_t BIG5_ENCODE_ONLY_COUNT;
+} // namespace YanLib::helper
+#endif // CODEPAGE_TABLES_H
@@ -26,40 +26,367 @@
  */
 /* clang-format on */
 #include "convert.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <cwchar>
+#include "codepage.h"
+#include "utf.h"
 
 namespace YanLib::helper {
+    namespace {
+        // code pages that map 0x00-0x7F straight onto U+0000-U+007F, so a
+        // pure ASCII string can be widened/narrowed without the OS converter
+        bool is_ascii_compatible(const CodePage code_page) {
+            switch (code_page) {
+                case CodePage::A_CP:
+                case CodePage::OEM_CP:
+                case CodePage::MAC_CP:
+                case CodePage::THREAD_A_CP:
+                case CodePage::UTF8:
+                case CodePage::GB2312:
+                case CodePage::GB18030:
+                case CodePage::BIG5:
+                case CodePage::WIN1250:
+                case CodePage::WIN1251:
+                case CodePage::WIN1252:
+                case CodePage::WIN1253:
+                case CodePage::WIN1254:
+                case CodePage::WIN1255:
+                case CodePage::WIN1256:
+                case CodePage::WIN1257:
+                case CodePage::WIN1258:
+                case CodePage::ISO88591:
+                case CodePage::ISO88592:
+                case CodePage::ISO88593:
+                case CodePage::ISO88594:
+                case CodePage::ISO88595:
+                case CodePage::ISO88596:
+                case CodePage::ISO88597:
+                case CodePage::ISO88598:
+                case CodePage::ISO88599:
+                case CodePage::ISO885913:
+                case CodePage::ISO885915:
+                case CodePage::IBM437:
+                case CodePage::IBM850:
+                case CodePage::IBM852:
+                case CodePage::IBM855:
+                case CodePage::IBM857:
+                case CodePage::IBM00858:
+                case CodePage::IBM866:
+                case CodePage::EUC_JP:
+                case CodePage::JOHAB:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+#if WCHAR_MAX > 0xFFFF
+        // wchar_t holds UTF-32 here, which helper::utf does not cover;
+        // strict like it, npos on malformed input
+        size_t utf8_to_wide(const char *str,
+                            const size_t len,
+                            wchar_t *buf,
+                            const size_t buf_len) {
+            const auto *s = reinterpret_cast<const uint8_t *>(str);
+            size_t out = 0;
+            for (size_t i = 0; i < len;) {
+                uint32_t cp = s[i];
+                size_t n = 0;
+                uint32_t min = 0;
+                if (cp < 0x80) {
+                    n = 1;
+                } else if ((cp & 0xE0) == 0xC0) {
+                    n = 2;
+                    cp &= 0x1F;
+                    min = 0x80;
+                } else if ((cp & 0xF0) == 0xE0) {
+                    n = 3;
+                    cp &= 0x0F;
+                    min = 0x800;
+                } else if ((cp & 0xF8) == 0xF0) {
+                    n = 4;
+                    cp &= 0x07;
+                    min = 0x10000;
+                } else {
+                    return utf::npos;
+                }
+                if (len - i < n) {
+                    return utf::npos;
+                }
+                for (size_t k = 1; k < n; ++k) {
+                    if ((s[i + k] & 0xC0) != 0x80) {
+                        return utf::npos;
+                    }
+                    cp = cp << 6 | (s[i + k] & 0x3F);
+                }
+                if (cp < min || cp > 0x10FFFF ||
+                    (cp >= 0xD800 && cp < 0xE000)) {
+                    return utf::npos;
+                }
+                if (buf_len) {
+                    if (out == buf_len) {
+                        return utf::npos;
+                    }
+                    buf[out] = static_cast<wchar_t>(cp);
+                }
+                ++out;
+                i += n;
+            }
+            return out;
+        }
+
+        size_t wide_to_utf8(const wchar_t *wstr,
+                            const size_t len,
+                            char *buf,
+                            const size_t buf_len) {
+            size_t out = 0;
+            for (size_t i = 0; i < len; ++i) {
+                const auto cp = static_cast<uint32_t>(wstr[i]);
+                if (cp > 0x10FFFF || (cp >= 0xD800 && cp < 0xE000)) {
+                    return utf::npos;
+                }
+                uint8_t bytes[4];
+                size_t n = 0;
+                if (cp < 0x80) {
+                    bytes[n++] = static_cast<uint8_t>(cp);
+                } else if (cp < 0x800) {
+                    bytes[n++] = static_cast<uint8_t>(0xC0 | cp >> 6);
+                    bytes[n++] = static_cast<uint8_t>(0x80 | (cp & 0x3F));
+                } else if (cp < 0x10000) {
+                    bytes[n++] = static_cast<uint8_t>(0xE0 | cp >> 12);
+                    bytes[n++] = static_cast<uint8_t>(0x80 | (cp >> 6 & 0x3F));
+                    bytes[n++] = static_cast<uint8_t>(0x80 | (cp & 0x3F));
+                } else {
+                    bytes[n++] = static_cast<uint8_t>(0xF0 | cp >> 18);
+                    bytes[n++] = static_cast<uint8_t>(0x80 | (cp >> 12 & 0x3F));
+                    bytes[n++] = static_cast<uint8_t>(0x80 | (cp >> 6 & 0x3F));
+                    bytes[n++] = static_cast<uint8_t>(0x80 | (cp & 0x3F));
+                }
+                if (buf_len) {
+                    if (buf_len - out < n) {
+                        return utf::npos;
+                    }
+                    memcpy(buf + out, bytes, n);
+                }
+                out += n;
+            }
+            return out;
+        }
+#endif
+    } // namespace
+
     std::wstring convert::str_to_wstr(const std::string &str,
                                       CodePage code_page) {
-        const int32_t len =
-                MultiByteToWideChar(static_cast<uint32_t>(code_page), 0,
-                                    str.data(), -1, nullptr, 0);
-        if (len <= 0)
+        // the converter used to run on the NUL-terminated string
+        const size_t size = std::min(str.size(), str.find('\0'));
+        const size_t len = str_to_wstr(str.data(), size, nullptr, 0, code_page);
+        if (!len) {
+            return {};
+        }
+        std::wstring wstr(len, L'\0');
+        if (str_to_wstr(str.data(), size, wstr.data(), len, code_page) != len) {
             return {};
-        std::wstring wstr(len, 0);
-        MultiByteToWideChar(static_cast<uint32_t>(code_page), 0, str.data(), -1,
-                            &wstr[0], len);
-        wstr.resize(len - 1);
-        wstr.shrink_to_fit();
+        }
         return wstr;
     }
 
     std::string convert::wstr_to_str(const std::wstring &wstr,
                                      CodePage code_page) {
-        const int32_t len =
-                WideCharToMultiByte(static_cast<uint32_t>(code_page), 0,
-                                    wstr.data(), -1, nullptr, 0, nullptr,
-                                    nullptr);
-        if (len <= 0)
+        const size_t size = std::min(wstr.size(), wstr.find(L'\0'));
+        const size_t len =
+                wstr_to_str(wstr.data(), size, nullptr, 0, code_page);
+        if (!len) {
+            return {};
+        }
+        std::string str(len, '\0');
+        if (wstr_to_str(wstr.data(), size, str.data(), len, code_page) != len) {
             return {};
-        std::string str(len, 0);
-        WideCharToMultiByte(static_cast<uint32_t>(code_page), 0, wstr.data(),
-                            -1, &str[0], len, nullptr, nullptr);
-        str.resize(len - 1);
-        str.shrink_to_fit();
+        }
         return str;
     }
 
+    size_t convert::str_to_wstr(const char *str,
+                                const size_t len,
+                                wchar_t *buf,
+                                const size_t buf_len,
+                                CodePage code_page) {
+        if (!str || !len || (!buf && buf_len)) {
+            return 0;
+        }
+#if WCHAR_MAX <= 0xFFFF
+        if (is_ascii_compatible(code_page) &&
+            utf::ascii_length(str, len) == len) {
+            if (!buf_len) {
+                return len;
+            }
+            return buf_len < len ? 0 : utf::utf8_to_utf16(str, len, buf, len);
+        }
+        if (code_page == CodePage::UTF8) {
+            // malformed input falls through, the OS substitutes U+FFFD
+            const size_t result = buf_len
+                    ? utf::utf8_to_utf16(str, len, buf, buf_len)
+                    : utf::utf16_length(str, len);
+            if (result != utf::npos) {
+                return result;
+            }
+        }
+        if (const auto cp = static_cast<uint32_t>(code_page);
+            codepage::is_supported(cp)) {
+            // strict, whatever the tables do not map is left to the OS
+            const size_t result = buf_len
+                    ? codepage::decode(cp, str, len, buf, buf_len)
+                    : codepage::decode_length(cp, str, len);
+            if (result != codepage::npos) {
+                return result;
+            }
+        }
+#else
+        if (code_page == CodePage::UTF8 ||
+            (is_ascii_compatible(code_page) &&
+             utf::ascii_length(str, len) == len)) {
+            const size_t result = utf8_to_wide(str, len, buf, buf_len);
+            if (result != utf::npos) {
+                return result;
+            }
+        }
+#endif
+#ifdef _WIN32
+        if (len > INT_MAX || buf_len > INT_MAX) {
+            return 0;
+        }
+        const int32_t result =
+                MultiByteToWideChar(static_cast<uint32_t>(code_page), 0, str,
+                                    static_cast<int32_t>(len), buf,
+                                    static_cast<int32_t>(buf_len));
+        return result > 0 ? result : 0;
+#else
+        return 0;
+#endif
+    }
+
+    size_t convert::wstr_to_str(const wchar_t *wstr,
+                                const size_t len,
+                                char *buf,
+                                const size_t buf_len,
+                                CodePage code_page) {
+        if (!wstr || !len || (!buf && buf_len)) {
+            return 0;
+        }
+#if WCHAR_MAX <= 0xFFFF
+        if (is_ascii_compatible(code_page) &&
+            utf::ascii_length(wstr, len) == len) {
+            if (!buf_len) {
+                return len;
+            }
+            return buf_len < len ? 0 : utf::utf16_to_utf8(wstr, len, buf, len);
+        }
+        if (code_page == CodePage::UTF8) {
+            const size_t result = buf_len
+                    ? utf::utf16_to_utf8(wstr, len, buf, buf_len)
+                    : utf::utf8_length(wstr, len);
+            if (result != utf::npos) {
+                return result;
+            }
+        }
+        if (const auto cp = static_cast<uint32_t>(code_page);
+            codepage::is_supported(cp)) {
+            const size_t result = buf_len
+                    ? codepage::encode(cp, wstr, len, buf, buf_len)
+                    : codepage::encode_length(cp, wstr, len);
+            if (result != codepage::npos) {
+                return result;
+            }
+        }
+#else
+        // every ASCII-compatible code page agrees with UTF-8 on ASCII
+        bool ascii = true;
+        for (size_t i = 0; i < len && ascii; ++i) {
+            ascii = static_cast<uint32_t>(wstr[i]) < 0x80;
+        }
+        if (code_page == CodePage::UTF8 ||
+            (ascii && is_ascii_compatible(code_page))) {
+            const size_t result = wide_to_utf8(wstr, len, buf, buf_len);
+            if (result != utf::npos) {
+                return result;
+            }
+        }
+#endif
+#ifdef _WIN32
+        if (len > INT_MAX || buf_len > INT_MAX) {
+            return 0;
+        }
+        const int32_t result =
+                WideCharToMultiByte(static_cast<uint32_t>(code_page), 0, wstr,
+                                    static_cast<int32_t>(len), buf,
+                                    static_cast<int32_t>(buf_len), nullptr,
+                                    nullptr);
+        return result > 0 ? result : 0;
+#else
+        return 0;
+#endif
+    }
+
+    bool convert::str_to_wstr(const char *str,
+                              small_str<wchar_t> &wstr,
+                              CodePage code_page) {
+        wstr.clear();
+        if (!str) {
+            return false;
+        }
+        const size_t size = strlen(str);
+        if (!size) {
+            return true;
+        }
+        // try the inline buffer first and only measure when it was too small
+        size_t len =
+                str_to_wstr(str, size, wstr.data(), wstr.capacity(), code_page);
+        if (!len) {
+            len = str_to_wstr(str, size, nullptr, 0, code_page);
+            if (!len || len <= wstr.capacity()) {
+                return false;
+            }
+            len = str_to_wstr(str, size, wstr.reserve(len), len, code_page);
+            if (!len) {
+                return false;
+            }
+        }
+        wstr.resize(len);
+        return true;
+    }
+
+    bool convert::wstr_to_str(const wchar_t *wstr,
+                              small_str<char> &str,
+                              CodePage code_page) {
+        str.clear();
+        if (!wstr) {
+            return false;
+        }
+        const size_t size = wcslen(wstr);
+        if (!size) {
+            return true;
+        }
+        size_t len =
+                wstr_to_str(wstr, size, str.data(), str.capacity(), code_page);
+        if (!len) {
+            len = wstr_to_str(wstr, size, nullptr, 0, code_page);
+            if (!len || len <= str.capacity()) {
+                return false;
+            }
+            len = wstr_to_str(wstr, size, str.reserve(len), len, code_page);
+            if (!len) {
+                return false;
+            }
+        }
+        str.resize(len);
+        return true;
+    }
+
     std::string convert::err_string(const uint32_t error_code) {
+#ifndef _WIN32
+        return strerror(static_cast<int>(error_code));
+#else
         std::string result;
         HLOCAL hlocal = nullptr;
         constexpr uint32_t system_locale =
@@ -92,9 +419,13 @@ namespace YanLib::helper {
             LocalFree(hlocal);
         }
         return result;
+#endif
     }
 
     std::wstring convert::err_wstring(const uint32_t error_code) {
+#ifndef _WIN32
+        return str_to_wstr(err_string(error_code), CodePage::UTF8);
+#else
         std::wstring result;
         HLOCAL hlocal = nullptr;
         constexpr uint32_t system_locale =
@@ -127,5 +458,6 @@ namespace YanLib::helper {
             LocalFree(hlocal);
         }
         return result;
+#endif
     }
 } // namespace YanLib::helper
@@ -27,9 +27,14 @@
 /* clang-format on */
 #ifndef CONVERT_H
 #define CONVERT_H
+#ifdef _WIN32
 #include <Windows.h>
+#endif
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include "helper.h"
+#include "small_str.h"
 namespace YanLib::helper {
     class convert {
     public:
@@ -51,6 +56,32 @@ namespace YanLib::helper {
         static std::string wstr_to_str(const std::wstring &wstr,
                                        CodePage code_page = curr_code_page());
 
+        // into-buffer variants: the result is not NUL-terminated, 0 means
+        // failure and buf_len == 0 asks for the required length
+        static size_t str_to_wstr(const char *str,
+                                  size_t len,
+                                  wchar_t *buf,
+                                  size_t buf_len,
+                                  CodePage code_page = curr_code_page());
+
+        static size_t wstr_to_str(const wchar_t *wstr,
+                                  size_t len,
+                                  char *buf,
+                                  size_t buf_len,
+                                  CodePage code_page = curr_code_page());
+
+        // NUL-terminated result in a small_str, which only goes to the heap
+        // when it does not fit the inline buffer
+        static bool str_to_wstr(const char *str,
+                                small_str<wchar_t> &wstr,
+                                CodePage code_page = curr_code_page());
+
+        static bool wstr_to_str(const wchar_t *wstr,
+                                small_str<char> &str,
+                                CodePage code_page = curr_code_page());
+
+        // Off Windows only ASCII and UTF-8 convert, wchar_t holding UTF-32
+        // there, and error codes are errno values.
         static std::string err_string(uint32_t error_code);
 
         static std::wstring err_wstring(uint32_t error_code);
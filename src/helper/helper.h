@@ -27,7 +27,9 @@
 /* clang-format on */
 #ifndef HELPER_H
 #define HELPER_H
+#ifdef _WIN32
 #include <WinUser.h>
+#endif
 #include <cstdint>
 namespace YanLib::helper {
     enum class CodePage : uint32_t {
@@ -140,8 +142,13 @@ namespace YanLib::helper {
         EUC_JP = 20932,           // Japanese EUC
     };
 
+    // elsewhere text is taken to be UTF-8
     inline CodePage curr_code_page() {
+#ifdef _WIN32
         return static_cast<CodePage>(GetKBCodePage());
+#else
+        return CodePage::UTF8;
+#endif
     }
 } // namespace YanLib::helper
 #endif // HELPER_H
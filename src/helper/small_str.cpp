@@ -0,0 +1,157 @@
+/* clang-format off */
+/*
+ * @file small_str.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "small_str.h"
+#include <cstring>
+#include <string>
+
+namespace YanLib::helper {
+    template <typename T> small_str<T>::small_str() {
+        stack_buf[0] = T();
+    }
+
+    template <typename T> small_str<T>::small_str(const T *str) {
+        stack_buf[0] = T();
+        append(str);
+    }
+
+    template <typename T>
+    small_str<T>::small_str(const T *str, const size_t size) {
+        stack_buf[0] = T();
+        append(str, size);
+    }
+
+    template <typename T> small_str<T>::~small_str() {
+        delete[] heap_buf;
+    }
+
+    template <typename T> T *small_str<T>::reserve(const size_t size) {
+        if (size <= cap) {
+            return ptr;
+        }
+        // grow geometrically so repeated appends stay linear
+        size_t new_cap = cap * 2;
+        if (new_cap < size) {
+            new_cap = size;
+        }
+        T *buf = new T[new_cap + 1];
+        memcpy(buf, ptr, (len + 1) * sizeof(T));
+        delete[] heap_buf;
+        heap_buf = buf;
+        ptr = buf;
+        cap = new_cap;
+        return ptr;
+    }
+
+    template <typename T> void small_str<T>::resize(const size_t size) {
+        len = size <= cap ? size : cap;
+        ptr[len] = T();
+    }
+
+    template <typename T>
+    small_str<T> &small_str<T>::assign(const T *str, const size_t size) {
+        len = 0;
+        ptr[0] = T();
+        return append(str, size);
+    }
+
+    template <typename T>
+    small_str<T> &small_str<T>::append(const T *str, const size_t size) {
+        if (!str || !size) {
+            return *this;
+        }
+        reserve(len + size);
+        memcpy(ptr + len, str, size * sizeof(T));
+        len += size;
+        ptr[len] = T();
+        return *this;
+    }
+
+    template <typename T> small_str<T> &small_str<T>::append(const T *str) {
+        if (!str) {
+            return *this;
+        }
+        return append(str, std::char_traits<T>::length(str));
+    }
+
+    template <typename T> void small_str<T>::push_back(const T ch) {
+        reserve(len + 1);
+        ptr[len++] = ch;
+        ptr[len] = T();
+    }
+
+    template <typename T> void small_str<T>::pop_back() {
+        if (len) {
+            ptr[--len] = T();
+        }
+    }
+
+    template <typename T> void small_str<T>::clear() {
+        len = 0;
+        ptr[0] = T();
+    }
+
+    template <typename T> T *small_str<T>::data() {
+        return ptr;
+    }
+
+    template <typename T> const T *small_str<T>::data() const {
+        return ptr;
+    }
+
+    template <typename T> size_t small_str<T>::size() const {
+        return len;
+    }
+
+    template <typename T> size_t small_str<T>::capacity() const {
+        return cap;
+    }
+
+    template <typename T> bool small_str<T>::empty() const {
+        return len == 0;
+    }
+
+    template <typename T> bool small_str<T>::is_heap() const {
+        return heap_buf != nullptr;
+    }
+
+    template <typename T> T &small_str<T>::back() {
+        return ptr[len - 1];
+    }
+
+    template <typename T> T &small_str<T>::operator[](const size_t index) {
+        return ptr[index];
+    }
+
+    template <typename T>
+    const T &small_str<T>::operator[](const size_t index) const {
+        return ptr[index];
+    }
+
+    template class small_str<char>;
+    template class small_str<wchar_t>;
+} // namespace YanLib::helper
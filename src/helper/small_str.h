@@ -0,0 +1,101 @@
+/* clang-format off */
+/*
+ * @file small_str.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef SMALL_STR_H
+#define SMALL_STR_H
+#include <cstddef>
+
+namespace YanLib::helper {
+    // NUL-terminated string that keeps up to inline_size - 1 characters in
+    // an inline buffer and only goes to the heap for longer contents. Meant
+    // for short-lived paths and names handed to the Win32 API.
+    template <typename T> class small_str {
+    public:
+        static constexpr size_t inline_size = 512;
+
+    private:
+        T stack_buf[inline_size];
+        T *heap_buf = nullptr;
+        T *ptr = stack_buf;
+        size_t len = 0;
+        size_t cap = inline_size - 1;
+
+    public:
+        small_str(const small_str &other) = delete;
+
+        small_str(small_str &&other) = delete;
+
+        small_str &operator=(const small_str &other) = delete;
+
+        small_str &operator=(small_str &&other) = delete;
+
+        small_str();
+
+        explicit small_str(const T *str);
+
+        small_str(const T *str, size_t size);
+
+        ~small_str();
+
+        // makes room for size characters plus the NUL, keeping the contents
+        T *reserve(size_t size);
+
+        // size must not exceed capacity(); terminates the string at size
+        void resize(size_t size);
+
+        small_str &assign(const T *str, size_t size);
+
+        small_str &append(const T *str, size_t size);
+
+        small_str &append(const T *str);
+
+        void push_back(T ch);
+
+        void pop_back();
+
+        void clear();
+
+        [[nodiscard]] T *data();
+
+        [[nodiscard]] const T *data() const;
+
+        [[nodiscard]] size_t size() const;
+
+        [[nodiscard]] size_t capacity() const;
+
+        [[nodiscard]] bool empty() const;
+
+        [[nodiscard]] bool is_heap() const;
+
+        [[nodiscard]] T &back();
+
+        T &operator[](size_t index);
+
+        const T &operator[](size_t index) const;
+    };
+} // namespace YanLib::helper
+#endif // SMALL_STR_H
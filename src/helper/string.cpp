@@ -26,38 +26,162 @@
  */
 /* clang-format on */
 #include "string.h"
-#include <algorithm>
+#include <cwchar>
 #include <cwctype>
+#if (defined(__SSE2__) || defined(_M_X64) ||                                   \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2)) &&                              \
+        WCHAR_MAX <= 0xFFFF
+#define STRING_USE_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace YanLib::helper {
-    bool string::strstri(const std::wstring &text, const std::wstring &substr) {
-        if (substr.empty())
-            return false;
-        if (text.empty())
-            return false;
+    namespace {
+        wchar_t fold(const wchar_t ch) {
+            if (ch < 0x80) {
+                return static_cast<wchar_t>(
+                        ch >= L'A' && ch <= L'Z' ? ch + 0x20 : ch);
+            }
+            return static_cast<wchar_t>(std::towlower(ch));
+        }
+
+#ifdef STRING_USE_SSE2
+        // ASCII 'A'-'Z' -> 'a'-'z', every other unit is left alone
+        __m128i fold8(const __m128i v) {
+            const __m128i upper =
+                    _mm_and_si128(_mm_cmpgt_epi16(v, _mm_set1_epi16('A' - 1)),
+                                  _mm_cmplt_epi16(v, _mm_set1_epi16('Z' + 1)));
+            return _mm_add_epi16(v,
+                                 _mm_and_si128(upper, _mm_set1_epi16(0x20)));
+        }
 
-        auto case_insensitive_compare = [](const wchar_t a,
-                                           const wchar_t b) -> bool {
-            return std::towlower(a) == std::towlower(b);
-        };
-        const auto it = std::search(text.begin(), text.end(), substr.begin(),
-                                    substr.end(), case_insensitive_compare);
-        return it != text.end();
+        // units above 0x7F may fold to anything, so they never rule a
+        // position out
+        __m128i non_ascii8(const __m128i v) {
+            const __m128i high = _mm_and_si128(
+                    v, _mm_set1_epi16(static_cast<short>(0xFF80)));
+            return _mm_xor_si128(_mm_cmpeq_epi16(high, _mm_setzero_si128()),
+                                 _mm_set1_epi16(-1));
+        }
+#endif
+    } // namespace
+
+    istr_needle::istr_needle(const wchar_t *substr) {
+        compile(substr, substr ? wcslen(substr) : 0);
     }
 
-    bool string::strstri(const wchar_t *text, const wchar_t *substr) {
-        if (!text || !substr || wcslen(text) == 0 || wcslen(substr) == 0)
-            return false;
+    istr_needle::istr_needle(const std::wstring &substr) {
+        compile(substr.data(), substr.size());
+    }
+
+    void istr_needle::compile(const wchar_t *substr, const size_t len) {
+        folded.reserve(len);
+        for (size_t i = 0; i < len; ++i) {
+            const wchar_t ch = fold(substr[i]);
+            ascii = ascii && ch < 0x80;
+            folded.push_back(ch);
+        }
+        const size_t max_shift = len < 255 ? len : 255;
+        for (auto &value : shift) {
+            value = static_cast<uint8_t>(max_shift);
+        }
+        for (size_t i = 0; i + 1 < len; ++i) {
+            const size_t distance = len - 1 - i;
+            uint8_t &value = shift[folded[i] & 0xFF];
+            if (distance < value) {
+                value = static_cast<uint8_t>(distance);
+            }
+        }
+    }
+
+    bool istr_needle::equal_at(const wchar_t *text) const {
+        for (size_t i = 0; i < folded.size(); ++i) {
+            if (fold(text[i]) != folded[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t istr_needle::find(const wchar_t *text, const size_t len) const {
+        const size_t m = folded.size();
+        if (!text || !m || len < m) {
+            return npos;
+        }
+        const wchar_t last = folded[m - 1];
+        size_t i = 0;
+#ifdef STRING_USE_SSE2
+        // first/last unit filter, eight candidate positions per step
+        if (ascii && m <= 64) {
+            const __m128i first_v = _mm_set1_epi16(
+                    static_cast<short>(folded[0]));
+            const __m128i last_v = _mm_set1_epi16(static_cast<short>(last));
+            for (; i + m - 1 + 8 <= len; i += 8) {
+                const __m128i head = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i *>(text + i));
+                const __m128i tail = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i *>(text + i + m - 1));
+                const __m128i hit = _mm_and_si128(
+                        _mm_or_si128(_mm_cmpeq_epi16(fold8(head), first_v),
+                                     non_ascii8(head)),
+                        _mm_or_si128(_mm_cmpeq_epi16(fold8(tail), last_v),
+                                     non_ascii8(tail)));
+                const uint32_t mask = _mm_movemask_epi8(hit);
+                if (!mask) {
+                    continue;
+                }
+                for (size_t j = 0; j < 8; ++j) {
+                    if (mask & (3U << (j * 2)) && equal_at(text + i + j)) {
+                        return i + j;
+                    }
+                }
+            }
+            for (; i + m <= len; ++i) {
+                if (equal_at(text + i)) {
+                    return i;
+                }
+            }
+            return npos;
+        }
+#endif
+        // Boyer-Moore-Horspool on the folded units
+        while (i + m <= len) {
+            const wchar_t ch = fold(text[i + m - 1]);
+            if (ch == last && equal_at(text + i)) {
+                return i;
+            }
+            i += shift[ch & 0xFF];
+        }
+        return npos;
+    }
+
+    bool istr_needle::is_in(const wchar_t *text) const {
+        return text && find(text, wcslen(text)) != npos;
+    }
 
-        auto case_insensitive_compare = [](const wchar_t a,
-                                           const wchar_t b) -> bool {
-            return std::towlower(a) == std::towlower(b);
-        };
+    bool istr_needle::is_in(const std::wstring &text) const {
+        return find(text.data(), text.size()) != npos;
+    }
 
-        const wchar_t *result =
-                std::search(text, text + wcslen(text), substr,
-                            substr + wcslen(substr), case_insensitive_compare);
+    size_t istr_needle::size() const {
+        return folded.size();
+    }
+
+    bool istr_needle::empty() const {
+        return folded.empty();
+    }
 
-        return *result ? true : false;
+    bool string::strstri(const std::wstring &text, const std::wstring &substr) {
+        if (substr.empty() || text.empty()) {
+            return false;
+        }
+        return istr_needle(substr).is_in(text);
+    }
+
+    bool string::strstri(const wchar_t *text, const wchar_t *substr) {
+        if (!text || !substr || !*text || !*substr) {
+            return false;
+        }
+        return istr_needle(substr).is_in(text);
     }
 } // namespace YanLib::helper
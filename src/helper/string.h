@@ -27,9 +27,56 @@
 /* clang-format on */
 #ifndef STRING_H
 #define STRING_H
+#include <cstdint>
 #include <string>
+#include "small_str.h"
 
 namespace YanLib::helper {
+    // Case-insensitive needle, folded and indexed once so that it can be
+    // matched against many texts, e.g. every entry of a process snapshot.
+    // Folding follows std::towlower, ASCII letters are folded inline.
+    class istr_needle {
+    private:
+        small_str<wchar_t> folded;
+        bool ascii = true;
+        // Horspool shift per folded character, bucketed by its low byte
+        uint8_t shift[256] = {};
+
+        void compile(const wchar_t *substr, size_t len);
+
+        [[nodiscard]] bool equal_at(const wchar_t *text) const;
+
+    public:
+        static constexpr size_t npos = SIZE_MAX;
+
+        istr_needle(const istr_needle &other) = delete;
+
+        istr_needle(istr_needle &&other) = delete;
+
+        istr_needle &operator=(const istr_needle &other) = delete;
+
+        istr_needle &operator=(istr_needle &&other) = delete;
+
+        istr_needle() = delete;
+
+        explicit istr_needle(const wchar_t *substr);
+
+        explicit istr_needle(const std::wstring &substr);
+
+        ~istr_needle() = default;
+
+        // offset of the first match in text[0, len), npos if there is none
+        [[nodiscard]] size_t find(const wchar_t *text, size_t len) const;
+
+        [[nodiscard]] bool is_in(const wchar_t *text) const;
+
+        [[nodiscard]] bool is_in(const std::wstring &text) const;
+
+        [[nodiscard]] size_t size() const;
+
+        [[nodiscard]] bool empty() const;
+    };
+
     class string {
     public:
         string(const string &other) = delete;
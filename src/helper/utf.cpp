@@ -0,0 +1,442 @@
+/* clang-format off */
+/*
+ * @file utf.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "utf.h"
+#include <cstring>
+#include <type_traits>
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UTF_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace YanLib::helper {
+    namespace {
+#ifndef UTF_USE_SSE2
+        constexpr uint64_t ASCII_MASK8 = 0x8080808080808080ULL;
+#endif
+
+        size_t ascii_length8(const uint8_t *str, const size_t len) {
+            size_t i = 0;
+#ifdef UTF_USE_SSE2
+            for (; i + 16 <= len; i += 16) {
+                const __m128i v = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i *>(str + i));
+                if (_mm_movemask_epi8(v)) {
+                    break;
+                }
+            }
+#else
+            for (; i + 8 <= len; i += 8) {
+                uint64_t word;
+                memcpy(&word, str + i, sizeof(word));
+                if (word & ASCII_MASK8) {
+                    break;
+                }
+            }
+#endif
+            while (i < len && str[i] < 0x80) {
+                ++i;
+            }
+            return i;
+        }
+
+        template <typename U>
+        size_t ascii_length16(const U *str, const size_t len) {
+            static_assert(sizeof(U) == 2, "UTF-16 code unit expected");
+            size_t i = 0;
+#ifdef UTF_USE_SSE2
+            const __m128i high = _mm_set1_epi16(static_cast<short>(0xFF80));
+            const __m128i zero = _mm_setzero_si128();
+            for (; i + 8 <= len; i += 8) {
+                const __m128i v = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i *>(str + i));
+                const __m128i is_ascii =
+                        _mm_cmpeq_epi16(_mm_and_si128(v, high), zero);
+                if (_mm_movemask_epi8(is_ascii) != 0xFFFF) {
+                    break;
+                }
+            }
+#endif
+            while (i < len && static_cast<uint16_t>(str[i]) < 0x80) {
+                ++i;
+            }
+            return i;
+        }
+
+        // decodes the non-ASCII sequence at str, returns its length in bytes
+        // or 0 when it is malformed or truncated
+        size_t decode_utf8(const uint8_t *str,
+                           const size_t avail,
+                           uint32_t &code_point) {
+            const uint8_t b0 = str[0];
+            if (b0 < 0xC2) {
+                // stray continuation byte or overlong two-byte form
+                return 0;
+            }
+            if (b0 < 0xE0) {
+                if (avail < 2 || (str[1] & 0xC0) != 0x80) {
+                    return 0;
+                }
+                code_point = (b0 & 0x1Fu) << 6 | (str[1] & 0x3Fu);
+                return 2;
+            }
+            if (b0 < 0xF0) {
+                if (avail < 3) {
+                    return 0;
+                }
+                const uint8_t lo = b0 == 0xE0 ? 0xA0 : 0x80;
+                const uint8_t hi = b0 == 0xED ? 0x9F : 0xBF;
+                if (str[1] < lo || str[1] > hi || (str[2] & 0xC0) != 0x80) {
+                    return 0;
+                }
+                code_point = (b0 & 0x0Fu) << 12 | (str[1] & 0x3Fu) << 6 |
+                        (str[2] & 0x3Fu);
+                return 3;
+            }
+            if (b0 < 0xF5) {
+                if (avail < 4) {
+                    return 0;
+                }
+                const uint8_t lo = b0 == 0xF0 ? 0x90 : 0x80;
+                const uint8_t hi = b0 == 0xF4 ? 0x8F : 0xBF;
+                if (str[1] < lo || str[1] > hi || (str[2] & 0xC0) != 0x80 ||
+                    (str[3] & 0xC0) != 0x80) {
+                    return 0;
+                }
+                code_point = (b0 & 0x07u) << 18 | (str[1] & 0x3Fu) << 12 |
+                        (str[2] & 0x3Fu) << 6 | (str[3] & 0x3Fu);
+                return 4;
+            }
+            return 0;
+        }
+
+        size_t utf16_length_impl(const uint8_t *str, const size_t len) {
+            size_t i = 0;
+            size_t units = 0;
+            while (i < len) {
+                const size_t ascii = ascii_length8(str + i, len - i);
+                i += ascii;
+                units += ascii;
+                if (i >= len) {
+                    break;
+                }
+                uint32_t code_point = 0;
+                const size_t n = decode_utf8(str + i, len - i, code_point);
+                if (!n) {
+                    return utf::npos;
+                }
+                i += n;
+                units += code_point >= 0x10000 ? 2 : 1;
+            }
+            return units;
+        }
+
+        template <typename U>
+        size_t utf8_to_utf16_impl(const uint8_t *str,
+                                  const size_t len,
+                                  U *buf,
+                                  const size_t buf_len) {
+            size_t i = 0;
+            size_t o = 0;
+            while (i < len) {
+#ifdef UTF_USE_SSE2
+                const __m128i zero = _mm_setzero_si128();
+                while (i + 16 <= len && o + 16 <= buf_len) {
+                    const __m128i v = _mm_loadu_si128(
+                            reinterpret_cast<const __m128i *>(str + i));
+                    if (_mm_movemask_epi8(v)) {
+                        break;
+                    }
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(buf + o),
+                                     _mm_unpacklo_epi8(v, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(buf + o + 8),
+                                     _mm_unpackhi_epi8(v, zero));
+                    i += 16;
+                    o += 16;
+                }
+#else
+                while (i + 8 <= len && o + 8 <= buf_len) {
+                    uint64_t word;
+                    memcpy(&word, str + i, sizeof(word));
+                    if (word & ASCII_MASK8) {
+                        break;
+                    }
+                    for (size_t k = 0; k < 8; ++k) {
+                        buf[o + k] = static_cast<U>(str[i + k]);
+                    }
+                    i += 8;
+                    o += 8;
+                }
+#endif
+                if (i >= len) {
+                    break;
+                }
+                if (str[i] < 0x80) {
+                    if (o >= buf_len) {
+                        return utf::npos;
+                    }
+                    buf[o++] = static_cast<U>(str[i++]);
+                    continue;
+                }
+                uint32_t code_point = 0;
+                const size_t n = decode_utf8(str + i, len - i, code_point);
+                if (!n) {
+                    return utf::npos;
+                }
+                if (code_point < 0x10000) {
+                    if (o >= buf_len) {
+                        return utf::npos;
+                    }
+                    buf[o++] = static_cast<U>(code_point);
+                } else {
+                    if (o + 2 > buf_len) {
+                        return utf::npos;
+                    }
+                    code_point -= 0x10000;
+                    buf[o++] = static_cast<U>(0xD800 + (code_point >> 10));
+                    buf[o++] = static_cast<U>(0xDC00 + (code_point & 0x3FF));
+                }
+                i += n;
+            }
+            return o;
+        }
+
+        template <typename U>
+        size_t utf8_length_impl(const U *str, const size_t len) {
+            size_t i = 0;
+            size_t bytes = 0;
+            while (i < len) {
+                const size_t ascii = ascii_length16(str + i, len - i);
+                i += ascii;
+                bytes += ascii;
+                if (i >= len) {
+                    break;
+                }
+                const auto c = static_cast<uint16_t>(str[i]);
+                if (c < 0x800) {
+                    bytes += 2;
+                    ++i;
+                } else if (c >= 0xD800 && c <= 0xDBFF) {
+                    if (i + 1 >= len) {
+                        return utf::npos;
+                    }
+                    const auto next = static_cast<uint16_t>(str[i + 1]);
+                    if (next < 0xDC00 || next > 0xDFFF) {
+                        return utf::npos;
+                    }
+                    bytes += 4;
+                    i += 2;
+                } else if (c >= 0xDC00 && c <= 0xDFFF) {
+                    return utf::npos;
+                } else {
+                    bytes += 3;
+                    ++i;
+                }
+            }
+            return bytes;
+        }
+
+        template <typename U>
+        size_t utf16_to_utf8_impl(const U *str,
+                                  const size_t len,
+                                  char *buf,
+                                  const size_t buf_len) {
+            size_t i = 0;
+            size_t o = 0;
+            while (i < len) {
+#ifdef UTF_USE_SSE2
+                const __m128i high =
+                        _mm_set1_epi16(static_cast<short>(0xFF80));
+                const __m128i zero = _mm_setzero_si128();
+                while (i + 8 <= len && o + 8 <= buf_len) {
+                    const __m128i v = _mm_loadu_si128(
+                            reinterpret_cast<const __m128i *>(str + i));
+                    const __m128i is_ascii =
+                            _mm_cmpeq_epi16(_mm_and_si128(v, high), zero);
+                    if (_mm_movemask_epi8(is_ascii) != 0xFFFF) {
+                        break;
+                    }
+                    _mm_storel_epi64(reinterpret_cast<__m128i *>(buf + o),
+                                     _mm_packus_epi16(v, v));
+                    i += 8;
+                    o += 8;
+                }
+                if (i >= len) {
+                    break;
+                }
+#endif
+                const auto c = static_cast<uint16_t>(str[i]);
+                if (c < 0x80) {
+                    if (o >= buf_len) {
+                        return utf::npos;
+                    }
+                    buf[o++] = static_cast<char>(c);
+                    ++i;
+                } else if (c < 0x800) {
+                    if (o + 2 > buf_len) {
+                        return utf::npos;
+                    }
+                    buf[o++] = static_cast<char>(0xC0 | (c >> 6));
+                    buf[o++] = static_cast<char>(0x80 | (c & 0x3F));
+                    ++i;
+                } else if (c >= 0xD800 && c <= 0xDBFF) {
+                    if (i + 1 >= len) {
+                        return utf::npos;
+                    }
+                    const auto next = static_cast<uint16_t>(str[i + 1]);
+                    if (next < 0xDC00 || next > 0xDFFF) {
+                        return utf::npos;
+                    }
+                    if (o + 4 > buf_len) {
+                        return utf::npos;
+                    }
+                    const uint32_t code_point =
+                            0x10000 + ((c - 0xD800u) << 10) + (next - 0xDC00u);
+                    buf[o++] = static_cast<char>(0xF0 | (code_point >> 18));
+                    buf[o++] = static_cast<char>(0x80 |
+                                                 ((code_point >> 12) & 0x3F));
+                    buf[o++] = static_cast<char>(0x80 |
+                                                 ((code_point >> 6) & 0x3F));
+                    buf[o++] = static_cast<char>(0x80 | (code_point & 0x3F));
+                    i += 2;
+                } else if (c >= 0xDC00 && c <= 0xDFFF) {
+                    return utf::npos;
+                } else {
+                    if (o + 3 > buf_len) {
+                        return utf::npos;
+                    }
+                    buf[o++] = static_cast<char>(0xE0 | (c >> 12));
+                    buf[o++] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                    buf[o++] = static_cast<char>(0x80 | (c & 0x3F));
+                    ++i;
+                }
+            }
+            return o;
+        }
+
+        const uint8_t *as_bytes(const char *str) {
+            return reinterpret_cast<const uint8_t *>(str);
+        }
+    } // namespace
+
+    size_t utf::ascii_length(const char *str, const size_t len) {
+        if (!str) {
+            return 0;
+        }
+        return ascii_length8(as_bytes(str), len);
+    }
+
+    size_t utf::ascii_length(const char16_t *str, const size_t len) {
+        if (!str) {
+            return 0;
+        }
+        return ascii_length16(str, len);
+    }
+
+    bool utf::validate_utf8(const char *str, const size_t len) {
+        return utf16_length(str, len) != npos;
+    }
+
+    bool utf::validate_utf16(const char16_t *str, const size_t len) {
+        return utf8_length(str, len) != npos;
+    }
+
+    size_t utf::utf16_length(const char *str, const size_t len) {
+        if (!str) {
+            return len ? npos : 0;
+        }
+        return utf16_length_impl(as_bytes(str), len);
+    }
+
+    size_t utf::utf8_length(const char16_t *str, const size_t len) {
+        if (!str) {
+            return len ? npos : 0;
+        }
+        return utf8_length_impl(str, len);
+    }
+
+    size_t utf::utf8_to_utf16(const char *str,
+                              const size_t len,
+                              char16_t *buf,
+                              const size_t buf_len) {
+        if (!str || (!buf && buf_len)) {
+            return len ? npos : 0;
+        }
+        return utf8_to_utf16_impl(as_bytes(str), len, buf, buf_len);
+    }
+
+    size_t utf::utf16_to_utf8(const char16_t *str,
+                              const size_t len,
+                              char *buf,
+                              const size_t buf_len) {
+        if (!str || (!buf && buf_len)) {
+            return len ? npos : 0;
+        }
+        return utf16_to_utf8_impl(str, len, buf, buf_len);
+    }
+
+#if WCHAR_MAX <= 0xFFFF
+    size_t utf::ascii_length(const wchar_t *str, const size_t len) {
+        if (!str) {
+            return 0;
+        }
+        return ascii_length16(str, len);
+    }
+
+    bool utf::validate_utf16(const wchar_t *str, const size_t len) {
+        return utf8_length(str, len) != npos;
+    }
+
+    size_t utf::utf8_length(const wchar_t *str, const size_t len) {
+        if (!str) {
+            return len ? npos : 0;
+        }
+        return utf8_length_impl(str, len);
+    }
+
+    size_t utf::utf8_to_utf16(const char *str,
+                              const size_t len,
+                              wchar_t *buf,
+                              const size_t buf_len) {
+        if (!str || (!buf && buf_len)) {
+            return len ? npos : 0;
+        }
+        return utf8_to_utf16_impl(as_bytes(str), len, buf, buf_len);
+    }
+
+    size_t utf::utf16_to_utf8(const wchar_t *str,
+                              const size_t len,
+                              char *buf,
+                              const size_t buf_len) {
+        if (!str || (!buf && buf_len)) {
+            return len ? npos : 0;
+        }
+        return utf16_to_utf8_impl(str, len, buf, buf_len);
+    }
+#endif
+} // namespace YanLib::helper
@@ -0,0 +1,102 @@
+/* clang-format off */
+/*
+ * @file utf.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef UTF_H
+#define UTF_H
+#include <cstddef>
+#include <cstdint>
+#include <cwchar>
+
+namespace YanLib::helper {
+    // Table-free UTF-8 <-> UTF-16 transcoder. It does not depend on the OS
+    // converter: ASCII runs are handled 16 bytes at a time with SSE2 and the
+    // rest goes through a strict scalar decoder (no overlongs, no surrogate
+    // code points, nothing above U+10FFFF, no unpaired UTF-16 surrogates).
+    // Lengths are in code units and never include a terminating NUL.
+    class utf {
+    public:
+        static constexpr size_t npos = SIZE_MAX;
+
+        utf(const utf &other) = delete;
+
+        utf(utf &&other) = delete;
+
+        utf &operator=(const utf &other) = delete;
+
+        utf &operator=(utf &&other) = delete;
+
+        utf() = delete;
+
+        ~utf() = delete;
+
+        // number of leading bytes/units below 0x80
+        static size_t ascii_length(const char *str, size_t len);
+
+        static size_t ascii_length(const char16_t *str, size_t len);
+
+        static bool validate_utf8(const char *str, size_t len);
+
+        static bool validate_utf16(const char16_t *str, size_t len);
+
+        // exact UTF-16 length of a UTF-8 string, npos if it is malformed
+        static size_t utf16_length(const char *str, size_t len);
+
+        // exact UTF-8 length of a UTF-16 string, npos if it is malformed
+        static size_t utf8_length(const char16_t *str, size_t len);
+
+        // returns the units written, npos if the input is malformed or the
+        // buffer is too small (buf is left partially written in that case)
+        static size_t utf8_to_utf16(const char *str,
+                                    size_t len,
+                                    char16_t *buf,
+                                    size_t buf_len);
+
+        static size_t utf16_to_utf8(const char16_t *str,
+                                    size_t len,
+                                    char *buf,
+                                    size_t buf_len);
+
+#if WCHAR_MAX <= 0xFFFF
+        static size_t ascii_length(const wchar_t *str, size_t len);
+
+        static bool validate_utf16(const wchar_t *str, size_t len);
+
+        static size_t utf8_length(const wchar_t *str, size_t len);
+
+        static size_t utf8_to_utf16(const char *str,
+                                    size_t len,
+                                    wchar_t *buf,
+                                    size_t buf_len);
+
+        static size_t utf16_to_utf8(const wchar_t *str,
+                                    size_t len,
+                                    char *buf,
+                                    size_t buf_len);
+#endif
+    };
+} // namespace YanLib::helper
+#endif // UTF_H
@@ -31,6 +31,25 @@
 #pragma comment(lib, "ShLwApi.Lib")
 
 namespace YanLib::io {
+    namespace {
+        // "<path_name>\*.*" with '/' turned into '\', built in place so
+        // short directory names never hit the heap
+        template <typename T>
+        void make_search_path(const T *path_name, helper::small_str<T> &path) {
+            path.assign(path_name, std::char_traits<T>::length(path_name));
+            for (size_t i = 0; i < path.size(); ++i) {
+                if (path[i] == T('/')) {
+                    path[i] = T('\\');
+                }
+            }
+            if (!path.empty() && path.back() == T('\\')) {
+                path.pop_back();
+            }
+            const T pattern[] = {T('\\'), T('*'), T('.'), T('*')};
+            path.append(pattern, 4);
+        }
+    } // namespace
+
     void fs::remove_tail_slash(std::string &path) {
         std::transform(path.begin(), path.end(), path.begin(),
                        [](const char ch) {
@@ -369,15 +388,15 @@ namespace YanLib::io {
         const auto volume_info_wide = std::make_unique<VolumeInfoW>();
         memset(volume_info_wide.get(), 0, sizeof(VolumeInfoW));
         if (get_volume_info(volume_info_wide.get())) {
-            const auto volume_name =
-                    helper::convert::wstr_to_str(volume_info_wide->volume_name,
-                                                 code_page);
-            const auto file_system_name = helper::convert::wstr_to_str(
-                    volume_info_wide->file_system_name, code_page);
-            memcpy_s(volume_info->volume_name, MAX_PATH, volume_name.data(),
-                     volume_name.size());
-            memcpy_s(volume_info->file_system_name, MAX_PATH,
-                     file_system_name.data(), file_system_name.size());
+            // the buffers hold MAX_PATH + 1, memset left the NUL in place
+            helper::convert::wstr_to_str(
+                    volume_info_wide->volume_name,
+                    wcsnlen_s(volume_info_wide->volume_name, MAX_PATH),
+                    volume_info->volume_name, MAX_PATH, code_page);
+            helper::convert::wstr_to_str(
+                    volume_info_wide->file_system_name,
+                    wcsnlen_s(volume_info_wide->file_system_name, MAX_PATH),
+                    volume_info->file_system_name, MAX_PATH, code_page);
             volume_info->serial_number = volume_info_wide->serial_number;
             volume_info->file_system_flag = volume_info_wide->file_system_flag;
             return true;
@@ -1283,9 +1302,9 @@ namespace YanLib::io {
 
     std::vector<WIN32_FIND_STREAM_DATA>
     fs_util::ls_stream_data(const char *file_name, helper::CodePage code_page) {
-        const std::wstring result =
-                helper::convert::str_to_wstr(file_name, code_page);
-        if (result.empty()) {
+        helper::small_str<wchar_t> result;
+        if (!helper::convert::str_to_wstr(file_name, result, code_page) ||
+            result.empty()) {
             return {};
         }
         return ls_stream_data(result.data());
@@ -1513,9 +1532,8 @@ namespace YanLib::io {
 
     std::vector<WIN32_FIND_DATAA> fs_util::ls_detail(const char *path_name) {
         std::vector<WIN32_FIND_DATAA> result;
-        std::string path(path_name);
-        remove_tail_slash(path);
-        path.append("\\*.*");
+        helper::small_str<char> path;
+        make_search_path(path_name, path);
         WIN32_FIND_DATAA find_data;
         HANDLE find_handle = FindFirstFileA(path.data(), &find_data);
         if (find_handle == INVALID_HANDLE_VALUE) {
@@ -1536,9 +1554,8 @@ namespace YanLib::io {
 
     std::vector<WIN32_FIND_DATAW> fs_util::ls_detail(const wchar_t *path_name) {
         std::vector<WIN32_FIND_DATAW> result;
-        std::wstring path(path_name);
-        remove_tail_slash(path);
-        path.append(L"\\*.*");
+        helper::small_str<wchar_t> path;
+        make_search_path(path_name, path);
         WIN32_FIND_DATAW find_data;
         HANDLE find_handle = FindFirstFileW(path.data(), &find_data);
         if (find_handle == INVALID_HANDLE_VALUE) {
@@ -1559,13 +1576,10 @@ namespace YanLib::io {
 
     std::vector<std::string> fs_util::ls(const char *path_name) {
         std::vector<std::string> result;
-        std::string path(path_name);
+        helper::small_str<char> path;
         WIN32_FIND_DATAA find_data;
 
-        remove_tail_slash(path);
-
-        std::string base_path = path;
-        path.append("\\*.*");
+        make_search_path(path_name, path);
 
         HANDLE find_handle = FindFirstFileA(path.data(), &find_data);
         if (find_handle == INVALID_HANDLE_VALUE) {
@@ -1586,13 +1600,10 @@ namespace YanLib::io {
 
     std::vector<std::wstring> fs_util::ls(const wchar_t *path_name) {
         std::vector<std::wstring> result;
-        std::wstring path(path_name);
+        helper::small_str<wchar_t> path;
         WIN32_FIND_DATAW find_data;
 
-        remove_tail_slash(path);
-
-        std::wstring base_path = path;
-        path.append(L"\\*.*");
+        make_search_path(path_name, path);
 
         HANDLE find_handle = FindFirstFileW(path.data(), &find_data);
         if (find_handle == INVALID_HANDLE_VALUE) {
@@ -1613,13 +1624,12 @@ namespace YanLib::io {
 
     std::vector<std::string> fs_util::ls_full_path(const char *path_name) {
         std::vector<std::string> result;
-        std::string path(path_name);
+        helper::small_str<char> path;
         WIN32_FIND_DATAA find_data;
 
-        remove_tail_slash(path);
-
-        const std::string base_path = path;
-        path.append("\\*.*");
+        make_search_path(path_name, path);
+        // length of "<base>\", the part in front of "*.*"
+        const size_t base_size = path.size() - 3;
 
         HANDLE find_handle = FindFirstFileA(path.data(), &find_data);
         if (find_handle == INVALID_HANDLE_VALUE) {
@@ -1629,7 +1639,8 @@ namespace YanLib::io {
         do {
             if (strcmp(find_data.cFileName, ".") != 0 &&
                 strcmp(find_data.cFileName, "..") != 0) {
-                result.push_back(base_path + "\\" + find_data.cFileName);
+                result.emplace_back(path.data(), base_size);
+                result.back().append(find_data.cFileName);
             }
         } while (FindNextFileA(find_handle, &find_data));
         if (!FindClose(find_handle)) {
@@ -1640,13 +1651,12 @@ namespace YanLib::io {
 
     std::vector<std::wstring> fs_util::ls_full_path(const wchar_t *path_name) {
         std::vector<std::wstring> result;
-        std::wstring path(path_name);
+        helper::small_str<wchar_t> path;
         WIN32_FIND_DATAW find_data;
 
-        remove_tail_slash(path);
-
-        const std::wstring base_path = path;
-        path.append(L"\\*.*");
+        make_search_path(path_name, path);
+        // length of "<base>\", the part in front of "*.*"
+        const size_t base_size = path.size() - 3;
 
         HANDLE find_handle = FindFirstFileW(path.data(), &find_data);
         if (find_handle == INVALID_HANDLE_VALUE) {
@@ -1656,7 +1666,8 @@ namespace YanLib::io {
         do {
             if (wcscmp(find_data.cFileName, L".") != 0 &&
                 wcscmp(find_data.cFileName, L"..") != 0) {
-                result.push_back(base_path + L"\\" + find_data.cFileName);
+                result.emplace_back(path.data(), base_size);
+                result.back().append(find_data.cFileName);
             }
         } while (FindNextFileW(find_handle, &find_data));
         if (!FindClose(find_handle)) {
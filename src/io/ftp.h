@@ -33,14 +33,14 @@
 #include <string>
 #include <vector>
 #include "helper/convert.h"
-#include "sync/rwlock.h"
+#include "sync/futex_rwlock.h"
 #pragma comment(lib, "wininet.Lib")
 
 namespace YanLib::io {
     class ftp {
     private:
         std::vector<HINTERNET> file_handles = {};
-        sync::rwlock rwlock = {};
+        sync::futex_rwlock rwlock = {};
         HINTERNET internet_handle = nullptr;
         HINTERNET session_read_handle = nullptr;
         HINTERNET session_upload_handle = nullptr;
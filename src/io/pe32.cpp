@@ -30,9 +30,10 @@
 #include <memory>
 
 namespace YanLib::io {
-    pe32::pe32(const char *file_name) {
+    pe32::pe32(const char *file_name, const mem::MapMode mode)
+        : map_mode(mode) {
         do {
-            mmap_handle = mmap.create(file_name);
+            mmap_handle = mmap.create(file_name, mode);
             if (!mmap_handle) {
                 error_code = mmap.err_code();
                 break;
@@ -41,10 +42,10 @@ namespace YanLib::io {
         } while (false);
     }
 
-    pe32::pe32(const wchar_t *file_name) {
+    pe32::pe32(const wchar_t *file_name, const mem::MapMode mode)
+        : map_mode(mode) {
         do {
-            const wchar_t *temp = nullptr;
-            mmap_handle = mmap.create(file_name, temp);
+            mmap_handle = mmap.create(file_name, mode);
             if (!mmap_handle) {
                 error_code = mmap.err_code();
                 break;
@@ -53,10 +54,10 @@ namespace YanLib::io {
         } while (false);
     }
 
-    pe32::pe32(HANDLE file_handle) {
+    pe32::pe32(HANDLE file_handle, const mem::MapMode mode)
+        : map_mode(mode) {
         do {
-            const char *temp = nullptr;
-            mmap_handle = mmap.create(file_handle, temp);
+            mmap_handle = mmap.create(file_handle, mode);
             if (!mmap_handle) {
                 error_code = mmap.err_code();
                 break;
@@ -67,7 +68,7 @@ namespace YanLib::io {
 
     void pe32::init() {
         do {
-            addr = mmap.mmap_file(mmap_handle);
+            addr = mmap.mmap_file(mmap_handle, map_mode);
             if (!addr) {
                 error_code = mmap.err_code();
                 break;
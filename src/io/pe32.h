@@ -36,6 +36,7 @@ namespace YanLib::io {
     private:
         mem::mmap mmap = {};
         HANDLE mmap_handle = nullptr;
+        mem::MapMode map_mode = mem::MapMode::ReadWrite;
         void *addr = nullptr;
         IMAGE_DOS_HEADER *_dos_header = nullptr;
         IMAGE_NT_HEADERS32 *_nt_headers = nullptr;
@@ -80,11 +81,17 @@ namespace YanLib::io {
 
         pe32() = delete;
 
-        explicit pe32(const char *file_name);
+        // The default maps the file read-write and set_* write through to
+        // it. CopyOnWrite opens the file for reading only and set_* edit a
+        // private copy; ReadOnly makes set_* fail.
+        explicit pe32(const char *file_name,
+                      mem::MapMode mode = mem::MapMode::ReadWrite);
 
-        explicit pe32(const wchar_t *file_name);
+        explicit pe32(const wchar_t *file_name,
+                      mem::MapMode mode = mem::MapMode::ReadWrite);
 
-        explicit pe32(HANDLE file_handle);
+        explicit pe32(HANDLE file_handle,
+                      mem::MapMode mode = mem::MapMode::ReadWrite);
 
         ~pe32() = default;
 
@@ -30,7 +30,7 @@
 #include <WinSock2.h>
 #include <string>
 #include <vector>
-#include "sync/rwlock.h"
+#include "sync/futex_rwlock.h"
 #pragma comment(lib, "WS2_32.Lib")
 namespace YanLib::io {
     class tcp_server {
@@ -40,7 +40,7 @@ namespace YanLib::io {
         SOCKET server_socket = INVALID_SOCKET;
         volatile bool init_done = false;
         int32_t error_code = {};
-        sync::rwlock rwlock = {};
+        sync::futex_rwlock rwlock = {};
         std::vector<SOCKET> client_sockets = {};
 
         tcp_server() = default;
@@ -27,15 +27,43 @@
 /* clang-format on */
 #include "allocate.h"
 #include <Windows.h>
+#include <algorithm>
+#include <cstring>
 #include "helper/convert.h"
+#include "large_page.h"
 
 namespace YanLib::mem {
-    allocate::~allocate() {
-        for (auto &mem : mem_list) {
-            if (mem) {
-                VirtualFree(mem, 0, MEM_RELEASE);
-                mem = nullptr;
+    namespace {
+        // set in the tracked reserved size, which is a page multiple
+        constexpr uintptr_t LARGE_PAGE_FLAG = 1;
+
+        size_t page_size() {
+            static const size_t size = [] {
+                SYSTEM_INFO info = {};
+                GetSystemInfo(&info);
+                return static_cast<size_t>(info.dwPageSize);
+            }();
+            return size;
+        }
+
+        size_t round_up(const size_t size, const size_t align) {
+            return (size + align - 1) & ~(align - 1);
+        }
+
+        // bytes committed from addr on, the block is committed front to back
+        size_t committed_size(void *addr) {
+            MEMORY_BASIC_INFORMATION info = {};
+            if (!VirtualQuery(addr, &info, sizeof(info)) ||
+                info.State != MEM_COMMIT) {
+                return 0;
             }
+            return info.RegionSize;
+        }
+    } // namespace
+
+    allocate::~allocate() {
+        for (const auto &[mem, size] : mem_list.drain()) {
+            VirtualFree(const_cast<void *>(mem), 0, MEM_RELEASE);
         }
     }
 
@@ -46,22 +74,40 @@ namespace YanLib::mem {
             error_code = GetLastError();
             return nullptr;
         }
-        rwlock.write_lock();
-        mem_list.push_back(address);
-        rwlock.write_unlock();
+        mem_list.insert(address, round_up(size, page_size()));
         return address;
     }
 
+    void *allocate::malloc_large_page(const size_t size, const bool fallback) {
+        // the privilege check is cached, a failed one costs nothing later
+        if (size && large_page::enable()) {
+            const size_t length = large_page::round_up(size);
+            void *address = VirtualAlloc(
+                    nullptr, length,
+                    MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                    PAGE_READWRITE);
+            if (address) {
+                mem_list.insert(address, length | LARGE_PAGE_FLAG);
+                large_bytes.fetch_add(length, std::memory_order_relaxed);
+                return address;
+            }
+            // no physically contiguous memory left, or a quota
+            error_code = GetLastError();
+        } else {
+            error_code = large_page::err_code();
+        }
+        return fallback ? malloc(size) : nullptr;
+    }
+
     bool allocate::free(void *addr) {
         if (!addr) {
             return false;
         }
-        rwlock.write_lock();
-        if (const auto it = std::find(mem_list.begin(), mem_list.end(), addr);
-            it != mem_list.end()) {
-            *it = nullptr;
+        if (uintptr_t reserved = 0;
+            mem_list.erase(addr, &reserved) && (reserved & LARGE_PAGE_FLAG)) {
+            large_bytes.fetch_sub(reserved & ~LARGE_PAGE_FLAG,
+                                  std::memory_order_relaxed);
         }
-        rwlock.write_unlock();
         if (!VirtualFree(addr, 0, MEM_RELEASE)) {
             error_code = GetLastError();
             return false;
@@ -77,9 +123,7 @@ namespace YanLib::mem {
             error_code = GetLastError();
             return nullptr;
         }
-        rwlock.write_lock();
-        mem_list.push_back(address);
-        rwlock.write_unlock();
+        mem_list.insert(address, round_up(size, page_size()));
         return address;
     }
 
@@ -87,12 +131,7 @@ namespace YanLib::mem {
         if (!addr) {
             return false;
         }
-        rwlock.write_lock();
-        if (const auto it = std::find(mem_list.begin(), mem_list.end(), addr);
-            it != mem_list.end()) {
-            *it = nullptr;
-        }
-        rwlock.write_unlock();
+        // the range stays reserved, so it stays tracked until free()
         if (!VirtualFree(addr, size, MEM_DECOMMIT)) {
             error_code = GetLastError();
             return false;
@@ -102,8 +141,73 @@ namespace YanLib::mem {
     }
 
     void *allocate::realloc(void *old_addr, size_t new_size) {
+        if (!old_addr) {
+            return malloc(new_size);
+        }
+        if (!new_size) {
+            free(old_addr);
+            return nullptr;
+        }
+        uintptr_t reserved = 0;
+        if (!mem_list.find(old_addr, &reserved)) {
+            error_code = ERROR_INVALID_ADDRESS;
+            return nullptr;
+        }
+        if (reserved & LARGE_PAGE_FLAG) {
+            // large pages are committed whole and never partly decommitted
+            reserved &= ~LARGE_PAGE_FLAG;
+            if (new_size <= reserved) {
+                return old_addr;
+            }
+            void *address =
+                    malloc_large_page(std::max(new_size, reserved * 2));
+            if (!address) {
+                return nullptr;
+            }
+            memcpy(address, old_addr, reserved);
+            free(old_addr);
+            return address;
+        }
+        const size_t committed = committed_size(old_addr);
+        const size_t needed = round_up(new_size, page_size());
+        if (needed <= reserved) {
+            // grow or shrink inside the reservation, nothing moves
+            if (needed > committed &&
+                !VirtualAlloc(static_cast<uint8_t *>(old_addr) + committed,
+                              needed - committed, MEM_COMMIT,
+                              PAGE_READWRITE)) {
+                error_code = GetLastError();
+                return nullptr;
+            }
+            if (needed < committed) {
+                VirtualFree(static_cast<uint8_t *>(old_addr) + needed,
+                            committed - needed, MEM_DECOMMIT);
+            }
+            return old_addr;
+        }
+        // Reservations cannot be extended, move to one twice as large so a
+        // buffer that keeps growing only moves O(log n) times.
+        const size_t new_reserved =
+                round_up(std::max(needed, reserved * 2), page_size());
+        void *address = VirtualAlloc(nullptr, new_reserved, MEM_RESERVE,
+                                     PAGE_READWRITE);
+        if (!address) {
+            error_code = GetLastError();
+            return nullptr;
+        }
+        if (!VirtualAlloc(address, needed, MEM_COMMIT, PAGE_READWRITE)) {
+            error_code = GetLastError();
+            VirtualFree(address, 0, MEM_RELEASE);
+            return nullptr;
+        }
+        memcpy(address, old_addr, std::min(committed, needed));
+        mem_list.insert(address, new_reserved);
         free(old_addr);
-        return malloc(new_size);
+        return address;
+    }
+
+    size_t allocate::large_page_bytes() const {
+        return large_bytes.load(std::memory_order_relaxed);
     }
 
     uint32_t allocate::err_code() const {
@@ -27,15 +27,15 @@
 /* clang-format on */
 #ifndef ALLOCATE_H
 #define ALLOCATE_H
+#include <atomic>
 #include <string>
-#include <vector>
-#include "sync/rwlock.h"
+#include "registry.h"
 
 namespace YanLib::mem {
     class allocate {
     private:
-        std::vector<void *> mem_list = {};
-        sync::rwlock rwlock = {};
+        registry mem_list = {};
+        std::atomic<size_t> large_bytes{0};
         uint32_t error_code = 0;
 
     public:
@@ -55,12 +55,24 @@ namespace YanLib::mem {
 
         bool free(void *addr);
 
+        // Commits size rounded up to whole large pages. With fallback set a
+        // missing privilege or fragmented memory yields normal pages instead
+        // of nullptr; large_page_bytes() tells how much did land on large
+        // pages.
+        void *malloc_large_page(size_t size, bool fallback = true);
+
         void *malloc_reserve(size_t size);
 
         bool free_reserve(void *addr, size_t size = 0);
 
+        // Resizes a block from malloc or malloc_reserve, keeping its contents.
+        // Pages are committed or decommitted inside the reservation in place;
+        // past it the block moves to a reservation twice the size. A block
+        // from malloc_reserve(max) thus grows up to max without copying.
         void *realloc(void *old_addr, size_t new_size);
 
+        [[nodiscard]] size_t large_page_bytes() const;
+
         [[nodiscard]] uint32_t err_code() const;
 
         [[nodiscard]] std::string err_string() const;
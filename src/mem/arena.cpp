@@ -0,0 +1,230 @@
+/* clang-format off */
+/*
+ * @file arena.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "arena.h"
+#include <cstdlib>
+#include <new>
+
+namespace YanLib::mem {
+    namespace {
+        constexpr size_t HEADER_ALIGN = alignof(std::max_align_t);
+
+        uint8_t *align_up(uint8_t *ptr, const size_t align) {
+            const auto value = reinterpret_cast<uintptr_t>(ptr);
+            return reinterpret_cast<uint8_t *>((value + align - 1) &
+                                               ~(uintptr_t{align} - 1));
+        }
+    } // namespace
+
+    uint8_t *arena::begin_of(block *b) {
+        return align_up(reinterpret_cast<uint8_t *>(b + 1), HEADER_ALIGN);
+    }
+
+    arena::arena(const size_t block_size) : block_size(block_size) {
+    }
+
+    arena::arena(const size_t block_size,
+                 std::pmr::memory_resource *upstream)
+        : block_size(block_size), upstream(upstream) {
+    }
+
+    arena::arena(void *buffer,
+                 const size_t buffer_size,
+                 const size_t block_size)
+        : block_size(block_size) {
+        auto *start = align_up(static_cast<uint8_t *>(buffer), alignof(block));
+        const size_t skip = start - static_cast<uint8_t *>(buffer);
+        if (!buffer || buffer_size < skip + sizeof(block) + HEADER_ALIGN) {
+            return;
+        }
+        head = new (start) block{nullptr, buffer_size - skip, false};
+        current = head;
+        cursor = begin_of(head);
+        limit = start + head->size;
+    }
+
+    arena::~arena() {
+        release();
+    }
+
+    void arena::free_block(block *b) {
+        if (upstream) {
+            upstream->deallocate(b, b->size, HEADER_ALIGN);
+        } else {
+            std::free(b);
+        }
+    }
+
+    void *arena::malloc(const size_t size, const size_t align) {
+        // align must be a power of two, as for operator new
+        uint8_t *ptr = align_up(cursor, align);
+        if (ptr && ptr <= limit && size <= static_cast<size_t>(limit - ptr)) {
+            cursor = ptr + size;
+            return ptr;
+        }
+        return malloc_slow(size, align);
+    }
+
+    void *arena::malloc_slow(const size_t size, const size_t align) {
+        const size_t overhead = sizeof(block) + HEADER_ALIGN + align;
+        if (size > SIZE_MAX - overhead) {
+            return nullptr;
+        }
+        const size_t needed = size + overhead;
+        // move on to a block left over from before a rewind if it fits,
+        // otherwise put a fresh one in its place
+        block *prev = current;
+        block *next = current ? current->next : head;
+        while (next && next->size < needed) {
+            block *after = next->next;
+            if (next->owned) {
+                free_block(next);
+                (prev ? prev->next : head) = after;
+            } else {
+                prev = next;
+            }
+            next = after;
+        }
+        if (!next) {
+            const size_t length = needed > block_size ? needed : block_size;
+            void *memory = nullptr;
+            if (!upstream) {
+                memory = std::malloc(length);
+            } else {
+                try {
+                    memory = upstream->allocate(length, HEADER_ALIGN);
+                } catch (const std::bad_alloc &) {
+                    memory = nullptr;
+                }
+            }
+            if (!memory) {
+                return nullptr;
+            }
+            next = new (memory) block{nullptr, length, true};
+            if (prev) {
+                next->next = prev->next;
+                prev->next = next;
+            } else {
+                next->next = head;
+                head = next;
+            }
+        }
+        current = next;
+        cursor = begin_of(next);
+        limit = reinterpret_cast<uint8_t *>(next) + next->size;
+        uint8_t *ptr = align_up(cursor, align);
+        cursor = ptr + size;
+        return ptr;
+    }
+
+    arena::marker arena::mark() const {
+        return {current, cursor};
+    }
+
+    void arena::rewind(const marker &m) {
+        if (!m.current) {
+            reset();
+            return;
+        }
+        current = m.current;
+        cursor = m.cursor;
+        limit = reinterpret_cast<uint8_t *>(current) + current->size;
+    }
+
+    void arena::reset() {
+        current = head;
+        cursor = head ? begin_of(head) : nullptr;
+        limit = head ? reinterpret_cast<uint8_t *>(head) + head->size
+                     : nullptr;
+    }
+
+    void arena::release() {
+        block *keep = nullptr;
+        for (block *b = head; b;) {
+            block *next = b->next;
+            if (b->owned) {
+                free_block(b);
+            } else {
+                b->next = nullptr;
+                keep = b;
+            }
+            b = next;
+        }
+        head = keep;
+        reset();
+    }
+
+    size_t arena::used() const {
+        size_t total = 0;
+        for (block *b = head; b; b = b->next) {
+            if (b == current) {
+                return total + (cursor - begin_of(b));
+            }
+            total += reinterpret_cast<uint8_t *>(b) + b->size - begin_of(b);
+        }
+        return total;
+    }
+
+    size_t arena::reserved() const {
+        size_t total = 0;
+        for (block *b = head; b; b = b->next) {
+            total += b->size;
+        }
+        return total;
+    }
+
+    arena_scope::arena_scope(arena &owner) : owner(owner), saved(owner.mark()) {
+    }
+
+    arena_scope::~arena_scope() {
+        owner.rewind(saved);
+    }
+
+    arena_resource::arena_resource(arena &owner) : owner(owner) {
+    }
+
+    void *arena_resource::do_allocate(const size_t bytes,
+                                      const size_t alignment) {
+        void *ptr = owner.malloc(bytes, alignment);
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    void arena_resource::do_deallocate(void *, size_t, size_t) {
+    }
+
+    bool arena_resource::do_is_equal(
+            const std::pmr::memory_resource &other) const noexcept {
+        return this == &other;
+    }
+
+    arena &arena_resource::get_arena() const {
+        return owner;
+    }
+} // namespace YanLib::mem
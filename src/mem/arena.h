@@ -0,0 +1,156 @@
+/* clang-format off */
+/*
+ * @file arena.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef ARENA_H
+#define ARENA_H
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace YanLib::mem {
+    // Monotonic bump allocator over a chain of blocks. Individual frees do
+    // nothing; rewind() and reset() give the memory back in O(1) and keep
+    // the blocks, so a loop that resets the arena per request stops touching
+    // the system allocator once it is warm. Not thread-safe.
+    class arena {
+    private:
+        struct block {
+            block *next;
+            size_t size;
+            bool owned;
+        };
+
+        block *head = nullptr;
+        block *current = nullptr;
+        uint8_t *cursor = nullptr;
+        uint8_t *limit = nullptr;
+        size_t block_size;
+        std::pmr::memory_resource *upstream = nullptr;
+
+        static uint8_t *begin_of(block *b);
+
+        void free_block(block *b);
+
+        void *malloc_slow(size_t size, size_t align);
+
+    public:
+        static constexpr size_t default_block_size = 64 * 1024;
+
+        struct marker {
+            block *current;
+            uint8_t *cursor;
+        };
+
+        arena(const arena &other) = delete;
+
+        arena(arena &&other) = delete;
+
+        arena &operator=(const arena &other) = delete;
+
+        arena &operator=(arena &&other) = delete;
+
+        explicit arena(size_t block_size = default_block_size);
+
+        // blocks come from upstream instead of malloc, e.g. a numa_resource
+        arena(size_t block_size, std::pmr::memory_resource *upstream);
+
+        // buffer becomes the first block and is never freed by the arena
+        arena(void *buffer,
+              size_t buffer_size,
+              size_t block_size = default_block_size);
+
+        ~arena();
+
+        void *malloc(size_t size, size_t align = alignof(std::max_align_t));
+
+        [[nodiscard]] marker mark() const;
+
+        // frees everything allocated after m was taken
+        void rewind(const marker &m);
+
+        void reset();
+
+        // returns the blocks to the system, except a caller's buffer
+        void release();
+
+        // bytes handed out since the last reset, alignment padding included
+        [[nodiscard]] size_t used() const;
+
+        [[nodiscard]] size_t reserved() const;
+    };
+
+    // Rewinds the arena to where it was when the scope was opened.
+    class arena_scope {
+    private:
+        arena &owner;
+        arena::marker saved;
+
+    public:
+        arena_scope(const arena_scope &other) = delete;
+
+        arena_scope(arena_scope &&other) = delete;
+
+        arena_scope &operator=(const arena_scope &other) = delete;
+
+        arena_scope &operator=(arena_scope &&other) = delete;
+
+        explicit arena_scope(arena &owner);
+
+        ~arena_scope();
+    };
+
+    // std::pmr adapter, e.g. std::pmr::vector<int> v(&resource)
+    class arena_resource : public std::pmr::memory_resource {
+    private:
+        arena &owner;
+
+    protected:
+        void *do_allocate(size_t bytes, size_t alignment) override;
+
+        void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+
+        [[nodiscard]] bool
+        do_is_equal(const std::pmr::memory_resource &other) const noexcept
+                override;
+
+    public:
+        arena_resource(const arena_resource &other) = delete;
+
+        arena_resource(arena_resource &&other) = delete;
+
+        arena_resource &operator=(const arena_resource &other) = delete;
+
+        arena_resource &operator=(arena_resource &&other) = delete;
+
+        explicit arena_resource(arena &owner);
+
+        ~arena_resource() override = default;
+
+        [[nodiscard]] arena &get_arena() const;
+    };
+} // namespace YanLib::mem
+#endif // ARENA_H
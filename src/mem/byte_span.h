@@ -0,0 +1,86 @@
+/* clang-format off */
+/*
+ * @file byte_span.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef BYTE_SPAN_H
+#define BYTE_SPAN_H
+#include <cstddef>
+#include <cstdint>
+
+namespace YanLib::mem {
+    // Read-only view of mapped bytes, std::span<const uint8_t> for C++17.
+    class byte_span {
+    private:
+        const uint8_t *ptr = nullptr;
+        size_t len = 0;
+
+    public:
+        static constexpr size_t npos = SIZE_MAX;
+
+        constexpr byte_span() = default;
+
+        constexpr byte_span(const uint8_t *data, const size_t size)
+            : ptr(data), len(size) {
+        }
+
+        [[nodiscard]] constexpr const uint8_t *data() const {
+            return ptr;
+        }
+
+        [[nodiscard]] constexpr size_t size() const {
+            return len;
+        }
+
+        [[nodiscard]] constexpr bool empty() const {
+            return len == 0;
+        }
+
+        [[nodiscard]] constexpr const uint8_t *begin() const {
+            return ptr;
+        }
+
+        [[nodiscard]] constexpr const uint8_t *end() const {
+            return ptr + len;
+        }
+
+        constexpr const uint8_t &operator[](const size_t index) const {
+            return ptr[index];
+        }
+
+        // clamped to the span, like std::string_view::substr
+        [[nodiscard]] constexpr byte_span subspan(const size_t offset,
+                                                  size_t count = npos) const {
+            if (offset >= len) {
+                return {ptr + len, 0};
+            }
+            if (count > len - offset) {
+                count = len - offset;
+            }
+            return {ptr + offset, count};
+        }
+    };
+} // namespace YanLib::mem
+#endif // BYTE_SPAN_H
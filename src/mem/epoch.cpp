@@ -0,0 +1,311 @@
+/* clang-format off */
+/*
+ * @file epoch.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "epoch.h"
+#include <algorithm>
+#include <thread>
+#include <unordered_set>
+
+namespace YanLib::mem {
+    struct alignas(64) epoch_domain::participant {
+        std::thread::id thread = {};
+        // epoch << 1 | 1 while pinned, 0 otherwise
+        std::atomic<uint64_t> state{0};
+        uint32_t nesting = 0;
+        uint32_t since_collect = 0;
+        std::vector<retired> garbage = {};
+        // batch buffer kept between collects, so they do not allocate
+        std::vector<retired> spare = {};
+
+        // for the thread-exit hook, which is not a member
+        static void leave(epoch_domain *domain, participant *p) {
+            domain->detach(p);
+        }
+    };
+
+    namespace {
+        constexpr size_t TLS_SLOTS = 4;
+
+        std::atomic<uint64_t> g_next_id{1};
+
+        // domains still alive, so exiting threads only touch those
+        std::mutex &live_mutex() {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        std::unordered_set<uint64_t> &live_domains() {
+            static std::unordered_set<uint64_t> domains;
+            return domains;
+        }
+
+        struct tls_slot {
+            uint64_t id;
+            epoch_domain *domain;
+            epoch_domain::participant *self;
+        };
+
+        struct tls_participants {
+            // lookup cache, a domain may be evicted by a newer one
+            tls_slot slots[TLS_SLOTS] = {};
+            size_t next = 0;
+            // every record this thread registered, evicted or not
+            std::vector<tls_slot> owned = {};
+
+            ~tls_participants() {
+                std::lock_guard lock(live_mutex());
+                for (const auto &slot : owned) {
+                    if (live_domains().count(slot.id)) {
+                        epoch_domain::participant::leave(slot.domain,
+                                                         slot.self);
+                    }
+                }
+            }
+
+            void forget(const uint64_t id) {
+                for (auto &slot : slots) {
+                    if (slot.id == id) {
+                        slot = {};
+                    }
+                }
+                owned.erase(std::remove_if(owned.begin(), owned.end(),
+                                           [id](const tls_slot &slot) {
+                                               return slot.id == id;
+                                           }),
+                            owned.end());
+            }
+        };
+
+        thread_local tls_participants t_participants;
+
+        // moves the entries epoch allows to free from list to out; list
+        // keeps its order
+        void take_safe(std::vector<epoch_domain::retired> &list,
+                       const uint64_t epoch,
+                       std::vector<epoch_domain::retired> &out) {
+            size_t kept = 0;
+            for (const auto &r : list) {
+                if (r.epoch + 2 > epoch) {
+                    list[kept++] = r;
+                } else {
+                    out.push_back(r);
+                }
+            }
+            list.resize(kept);
+        }
+
+        // runs outside any lock: a reclaim function may retire again
+        size_t release(const std::vector<epoch_domain::retired> &batch) {
+            for (const auto &r : batch) {
+                r.reclaim(r.obj, r.ctx);
+            }
+            return batch.size();
+        }
+    } // namespace
+
+    epoch_domain::epoch_domain()
+        : id(g_next_id.fetch_add(1, std::memory_order_relaxed)) {
+        std::lock_guard lock(live_mutex());
+        live_domains().insert(id);
+    }
+
+    epoch_domain::~epoch_domain() {
+        {
+            std::lock_guard lock(live_mutex());
+            live_domains().erase(id);
+        }
+        t_participants.forget(id);
+        std::vector<retired> rest;
+        {
+            std::lock_guard lock(mutex);
+            rest.swap(orphans);
+            for (const auto p : participants) {
+                rest.insert(rest.end(), p->garbage.begin(), p->garbage.end());
+                delete p;
+            }
+            participants.clear();
+        }
+        release(rest);
+    }
+
+    epoch_domain::participant *epoch_domain::local() {
+        for (const auto &slot : t_participants.slots) {
+            if (slot.id == id) {
+                return slot.self;
+            }
+        }
+        // the slot may have gone to another domain, reuse the record this
+        // thread already has before registering a new one
+        const std::thread::id self = std::this_thread::get_id();
+        participant *p = nullptr;
+        {
+            std::lock_guard lock(mutex);
+            for (const auto q : participants) {
+                if (q->thread == self) {
+                    p = q;
+                    break;
+                }
+            }
+            if (!p) {
+                p = new participant;
+                p->thread = self;
+                participants.push_back(p);
+                t_participants.owned.push_back({id, this, p});
+            }
+        }
+        const size_t i = t_participants.next;
+        t_participants.next = (i + 1) % TLS_SLOTS;
+        // an evicted record stays registered, is found again above and is
+        // still detached when the thread exits
+        t_participants.slots[i] = {id, this, p};
+        return p;
+    }
+
+    void epoch_domain::detach(participant *p) {
+        std::lock_guard lock(mutex);
+        const auto it = std::find(participants.begin(), participants.end(), p);
+        if (it == participants.end()) {
+            return;
+        }
+        participants.erase(it);
+        orphans.insert(orphans.end(), p->garbage.begin(), p->garbage.end());
+        delete p;
+    }
+
+    void epoch_domain::pin() {
+        participant *p = local();
+        if (p->nesting++) {
+            return;
+        }
+        p->state.store(global_epoch.load(std::memory_order_relaxed) << 1 | 1,
+                       std::memory_order_relaxed);
+        // loads of shared pointers stay below the pin, paired with the
+        // fence in try_advance()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void epoch_domain::unpin() {
+        participant *p = local();
+        if (--p->nesting == 0) {
+            p->state.store(0, std::memory_order_release);
+        }
+    }
+
+    bool epoch_domain::pinned() {
+        return local()->nesting != 0;
+    }
+
+    bool epoch_domain::try_advance() {
+        const uint64_t current = global_epoch.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        {
+            std::lock_guard lock(mutex);
+            for (const auto p : participants) {
+                // acquire, so what a reader did before unpinning happens
+                // before the frees this advance allows
+                const uint64_t state = p->state.load(std::memory_order_acquire);
+                if ((state & 1) && state >> 1 != current) {
+                    return false;
+                }
+            }
+        }
+        uint64_t expected = current;
+        global_epoch.compare_exchange_strong(expected, current + 1,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_relaxed);
+        return true;
+    }
+
+    void epoch_domain::retire(void *obj, const reclaim_fn reclaim, void *ctx) {
+        participant *p = local();
+        // tag after the unlink: a thread pinned in an earlier epoch may
+        // still hold obj, one pinned from this epoch on may too
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        p->garbage.push_back(
+                {obj, reclaim, ctx,
+                 global_epoch.load(std::memory_order_relaxed)});
+        garbage_count.fetch_add(1, std::memory_order_relaxed);
+        if (++p->since_collect < batch_size) {
+            return;
+        }
+        p->since_collect = 0;
+        collect();
+        // a stalled reader holds the epoch back; wait rather than let the
+        // garbage grow, unless this thread is the one holding it
+        while (p->garbage.size() > garbage_limit && !p->nesting) {
+            std::this_thread::yield();
+            collect();
+        }
+    }
+
+    size_t epoch_domain::collect() {
+        try_advance();
+        const uint64_t epoch = global_epoch.load(std::memory_order_acquire);
+        participant *p = local();
+        // taken out while in use, a reclaim function may collect again
+        std::vector<retired> batch;
+        batch.swap(p->spare);
+        take_safe(p->garbage, epoch, batch);
+        {
+            std::lock_guard lock(mutex);
+            if (!orphans.empty()) {
+                take_safe(orphans, epoch, batch);
+            }
+        }
+        garbage_count.fetch_sub(batch.size(), std::memory_order_relaxed);
+        const size_t freed = release(batch);
+        batch.clear();
+        p->spare.swap(batch);
+        return freed;
+    }
+
+    void epoch_domain::unregister_thread() {
+        t_participants.forget(id);
+        const std::thread::id self = std::this_thread::get_id();
+        participant *p = nullptr;
+        {
+            std::lock_guard lock(mutex);
+            for (const auto q : participants) {
+                if (q->thread == self) {
+                    p = q;
+                    break;
+                }
+            }
+        }
+        if (p) {
+            detach(p);
+        }
+    }
+
+    uint64_t epoch_domain::epoch() const {
+        return global_epoch.load(std::memory_order_relaxed);
+    }
+
+    size_t epoch_domain::pending() const {
+        return garbage_count.load(std::memory_order_relaxed);
+    }
+} // namespace YanLib::mem
@@ -0,0 +1,161 @@
+/* clang-format off */
+/*
+ * @file epoch.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef EPOCH_H
+#define EPOCH_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "object_pool.h"
+
+namespace YanLib::mem {
+    // Epoch-based reclamation for lock-free structures. Threads pin the
+    // domain around each access (epoch_guard) and retire() nodes once they
+    // are unlinked; a node is freed only after every thread that was pinned
+    // when it was retired has unpinned. The global epoch moves on only when
+    // all pinned threads have seen the current one, so a node retired in
+    // epoch e is safe once the epoch reaches e + 2. Threads register on
+    // first use and leave their garbage to the domain when they exit.
+    class epoch_domain {
+    public:
+        using reclaim_fn = void (*)(void *obj, void *ctx);
+
+        // retires between attempts to advance the epoch and free a batch
+        static constexpr uint32_t batch_size = 64;
+        // garbage a thread may hold before retire() waits for stalled
+        // readers instead, when it is not pinned itself
+        static constexpr size_t garbage_limit = 4096;
+
+        struct participant;
+
+        struct retired {
+            void *obj;
+            reclaim_fn reclaim;
+            void *ctx;
+            uint64_t epoch;
+        };
+
+    private:
+        uint64_t id;
+        std::atomic<uint64_t> global_epoch{0};
+        std::atomic<size_t> garbage_count{0};
+        std::mutex mutex = {};
+        std::vector<participant *> participants = {};
+        // garbage of threads that exited, freed by later collect() calls
+        std::vector<retired> orphans = {};
+
+        participant *local();
+
+        bool try_advance();
+
+        // unregisters p, its garbage goes to orphans
+        void detach(participant *p);
+
+    public:
+        epoch_domain(const epoch_domain &other) = delete;
+
+        epoch_domain(epoch_domain &&other) = delete;
+
+        epoch_domain &operator=(const epoch_domain &other) = delete;
+
+        epoch_domain &operator=(epoch_domain &&other) = delete;
+
+        epoch_domain();
+
+        // frees all remaining garbage, no thread may still be pinned
+        ~epoch_domain();
+
+        // nests
+        void pin();
+
+        void unpin();
+
+        [[nodiscard]] bool pinned();
+
+        // obj must already be unreachable for threads that pin from now
+        // on; reclaim(obj, ctx) runs on whichever thread frees the batch
+        void retire(void *obj, reclaim_fn reclaim, void *ctx = nullptr);
+
+        template <typename T> void retire(T *obj);
+
+        // the pool must outlive the domain or a final collect()
+        template <typename T> void retire(T *obj, object_pool<T> &pool);
+
+        // advances the epoch if it can and frees what is safe, returns
+        // the number of objects freed
+        size_t collect();
+
+        // hands the calling thread's garbage to the domain, the thread
+        // registers again on its next use
+        void unregister_thread();
+
+        [[nodiscard]] uint64_t epoch() const;
+
+        // retired and not freed yet, all threads
+        [[nodiscard]] size_t pending() const;
+    };
+
+    class epoch_guard {
+    private:
+        epoch_domain &domain;
+
+    public:
+        epoch_guard(const epoch_guard &other) = delete;
+
+        epoch_guard(epoch_guard &&other) = delete;
+
+        epoch_guard &operator=(const epoch_guard &other) = delete;
+
+        epoch_guard &operator=(epoch_guard &&other) = delete;
+
+        explicit epoch_guard(epoch_domain &domain) : domain(domain) {
+            domain.pin();
+        }
+
+        ~epoch_guard() {
+            domain.unpin();
+        }
+    };
+
+    template <typename T> void epoch_domain::retire(T *obj) {
+        retire(obj, [](void *p, void *) { delete static_cast<T *>(p); });
+    }
+
+    template <typename T>
+    void epoch_domain::retire(T *obj, object_pool<T> &pool) {
+        retire(
+                obj,
+                [](void *p, void *ctx) {
+                    static_cast<object_pool<T> *>(ctx)->destroy(
+                            static_cast<T *>(p));
+                },
+                &pool);
+    }
+} // namespace YanLib::mem
+#endif // EPOCH_H
@@ -0,0 +1,166 @@
+/* clang-format off */
+/*
+ * @file hazard.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "hazard.h"
+#include <algorithm>
+#include <vector>
+
+namespace YanLib::mem {
+    hazard_domain::~hazard_domain() {
+        retired *r = retired_head.exchange(nullptr, std::memory_order_acquire);
+        while (r) {
+            retired *next = r->next;
+            r->reclaim(r->obj, r->ctx);
+            records.destroy(r);
+            r = next;
+            // a reclaim function may retire again
+            if (!r) {
+                r = retired_head.exchange(nullptr, std::memory_order_acquire);
+            }
+        }
+        slot *s = slots.load(std::memory_order_acquire);
+        while (s) {
+            slot *next = s->next;
+            delete s;
+            s = next;
+        }
+    }
+
+    hazard_domain::slot *hazard_domain::acquire_slot() {
+        for (slot *s = slots.load(std::memory_order_acquire); s;
+             s = s->next) {
+            bool used = false;
+            if (!s->used.load(std::memory_order_relaxed) &&
+                s->used.compare_exchange_strong(used, true,
+                                                std::memory_order_acquire)) {
+                return s;
+            }
+        }
+        auto *s = new slot;
+        s->used.store(true, std::memory_order_relaxed);
+        slot *head = slots.load(std::memory_order_relaxed);
+        do {
+            s->next = head;
+        } while (!slots.compare_exchange_weak(head, s,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+        slot_count.fetch_add(1, std::memory_order_relaxed);
+        return s;
+    }
+
+    void hazard_domain::release_slot(slot *s) {
+        s->ptr.store(nullptr, std::memory_order_release);
+        s->used.store(false, std::memory_order_release);
+    }
+
+    void hazard_domain::push_retired(retired *first, retired *last) {
+        retired *head = retired_head.load(std::memory_order_relaxed);
+        do {
+            last->next = head;
+        } while (!retired_head.compare_exchange_weak(
+                head, first, std::memory_order_release,
+                std::memory_order_relaxed));
+    }
+
+    void hazard_domain::retire(void *obj,
+                               const reclaim_fn reclaim,
+                               void *ctx) {
+        retired *r = records.create(retired{obj, reclaim, ctx, nullptr});
+        push_retired(r, r);
+        const size_t count =
+                retired_count.fetch_add(1, std::memory_order_relaxed) + 1;
+        const size_t threshold = std::max(
+                batch_size, 2 * slot_count.load(std::memory_order_relaxed));
+        if (count >= threshold) {
+            scan();
+        }
+    }
+
+    size_t hazard_domain::scan() {
+        // each scan owns the list it took, scans may run side by side
+        retired *list = retired_head.exchange(nullptr, std::memory_order_acquire);
+        if (!list) {
+            return 0;
+        }
+        // the unlinks before retire() are visible before the slots are
+        // read, paired with the fence in protect()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::vector<void *> hazards;
+        for (slot *s = slots.load(std::memory_order_acquire); s;
+             s = s->next) {
+            if (void *ptr = s->ptr.load(std::memory_order_acquire)) {
+                hazards.push_back(ptr);
+            }
+        }
+        std::sort(hazards.begin(), hazards.end());
+        retired *keep = nullptr;
+        retired *keep_last = nullptr;
+        size_t freed = 0;
+        while (list) {
+            retired *next = list->next;
+            if (std::binary_search(hazards.begin(), hazards.end(),
+                                   list->obj)) {
+                list->next = keep;
+                if (!keep) {
+                    keep_last = list;
+                }
+                keep = list;
+            } else {
+                // may retire again, that goes to the shared list
+                list->reclaim(list->obj, list->ctx);
+                records.destroy(list);
+                ++freed;
+            }
+            list = next;
+        }
+        retired_count.fetch_sub(freed, std::memory_order_relaxed);
+        if (keep) {
+            push_retired(keep, keep_last);
+        }
+        return freed;
+    }
+
+    size_t hazard_domain::collect() {
+        return scan();
+    }
+
+    size_t hazard_domain::pending() const {
+        return retired_count.load(std::memory_order_relaxed);
+    }
+
+    hazard_pointer::hazard_pointer(hazard_domain &domain)
+        : domain(domain), own(domain.acquire_slot()) {
+    }
+
+    hazard_pointer::~hazard_pointer() {
+        domain.release_slot(own);
+    }
+
+    void hazard_pointer::reset() {
+        own->ptr.store(nullptr, std::memory_order_release);
+    }
+} // namespace YanLib::mem
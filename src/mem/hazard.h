@@ -0,0 +1,162 @@
+/* clang-format off */
+/*
+ * @file hazard.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef HAZARD_H
+#define HAZARD_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "object_pool.h"
+
+namespace YanLib::mem {
+    // Hazard pointers, for references held long enough (across a blocking
+    // call, for a whole request) that pinning an epoch_domain would hold
+    // reclamation back for everyone. A reader publishes the pointer it is
+    // about to use in a slot of its own; retired nodes are freed in
+    // batches, skipping any that a slot still names, so garbage stays
+    // below about twice the slot count plus one batch.
+    class hazard_domain {
+    public:
+        using reclaim_fn = void (*)(void *obj, void *ctx);
+
+        static constexpr size_t batch_size = 64;
+
+        struct alignas(64) slot {
+            std::atomic<void *> ptr{nullptr};
+            std::atomic<bool> used{false};
+            slot *next = nullptr;
+        };
+
+    private:
+        struct retired {
+            void *obj;
+            reclaim_fn reclaim;
+            void *ctx;
+            retired *next;
+        };
+
+        // retire() runs often, its records come from a pool
+        object_pool<retired> records{batch_size};
+        std::atomic<slot *> slots{nullptr};
+        std::atomic<size_t> slot_count{0};
+        std::atomic<retired *> retired_head{nullptr};
+        std::atomic<size_t> retired_count{0};
+
+        void push_retired(retired *first, retired *last);
+
+        size_t scan();
+
+    public:
+        hazard_domain(const hazard_domain &other) = delete;
+
+        hazard_domain(hazard_domain &&other) = delete;
+
+        hazard_domain &operator=(const hazard_domain &other) = delete;
+
+        hazard_domain &operator=(hazard_domain &&other) = delete;
+
+        hazard_domain() = default;
+
+        // frees all remaining garbage, no hazard_pointer may be alive
+        ~hazard_domain();
+
+        // slots are reused, never freed before the domain
+        slot *acquire_slot();
+
+        void release_slot(slot *s);
+
+        // obj must already be unreachable from the shared structure
+        void retire(void *obj, reclaim_fn reclaim, void *ctx = nullptr);
+
+        template <typename T> void retire(T *obj);
+
+        // the pool must outlive the domain or a final collect()
+        template <typename T> void retire(T *obj, object_pool<T> &pool);
+
+        // frees every retired object no slot protects, returns how many
+        size_t collect();
+
+        [[nodiscard]] size_t pending() const;
+    };
+
+    class hazard_pointer {
+    private:
+        hazard_domain &domain;
+        hazard_domain::slot *own;
+
+    public:
+        hazard_pointer(const hazard_pointer &other) = delete;
+
+        hazard_pointer(hazard_pointer &&other) = delete;
+
+        hazard_pointer &operator=(const hazard_pointer &other) = delete;
+
+        hazard_pointer &operator=(hazard_pointer &&other) = delete;
+
+        explicit hazard_pointer(hazard_domain &domain);
+
+        ~hazard_pointer();
+
+        // loads src and keeps the result from being freed until reset()
+        // or the next protect(); the pointer may be null
+        template <typename T> T *protect(const std::atomic<T *> &src);
+
+        void reset();
+    };
+
+    template <typename T> void hazard_domain::retire(T *obj) {
+        retire(obj, [](void *p, void *) { delete static_cast<T *>(p); });
+    }
+
+    template <typename T>
+    void hazard_domain::retire(T *obj, object_pool<T> &pool) {
+        retire(
+                obj,
+                [](void *p, void *ctx) {
+                    static_cast<object_pool<T> *>(ctx)->destroy(
+                            static_cast<T *>(p));
+                },
+                &pool);
+    }
+
+    template <typename T>
+    T *hazard_pointer::protect(const std::atomic<T *> &src) {
+        T *ptr = src.load(std::memory_order_relaxed);
+        while (true) {
+            own->ptr.store(ptr, std::memory_order_relaxed);
+            // the slot store is visible before src is read again, paired
+            // with the fence in scan()
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            T *again = src.load(std::memory_order_acquire);
+            if (again == ptr) {
+                return ptr;
+            }
+            ptr = again;
+        }
+    }
+} // namespace YanLib::mem
+#endif // HAZARD_H
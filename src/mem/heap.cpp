@@ -30,13 +30,9 @@
 
 namespace YanLib::mem {
     heap::~heap() {
-        if (!mem_list.empty()) {
-            for (auto &[heap_handle, mem] : mem_list) {
-                if (heap_handle && mem) {
-                    HeapFree(heap_handle, 0, mem);
-                    mem = nullptr;
-                }
-            }
+        for (const auto &[mem, heap_handle] : mem_list.drain()) {
+            HeapFree(reinterpret_cast<HANDLE>(heap_handle), 0,
+                     const_cast<void *>(mem));
         }
         if (!heap_handles.empty()) {
             for (auto &heap_handle : heap_handles) {
@@ -81,9 +77,7 @@ namespace YanLib::mem {
         if (!addr) {
             return nullptr;
         }
-        mem_rwlock.write_lock();
-        mem_list.emplace_back(heap_handle, addr);
-        mem_rwlock.write_unlock();
+        mem_list.insert(addr, reinterpret_cast<uintptr_t>(heap_handle));
         return addr;
     }
 
@@ -93,9 +87,9 @@ namespace YanLib::mem {
         if (!address) {
             return nullptr;
         }
-        mem_rwlock.write_lock();
-        mem_list.emplace_back(heap_handle, address);
-        mem_rwlock.write_unlock();
+        // the old block is gone, whether or not it moved
+        mem_list.erase(addr);
+        mem_list.insert(address, reinterpret_cast<uintptr_t>(heap_handle));
         return address;
     }
 
@@ -103,13 +97,7 @@ namespace YanLib::mem {
         if (!heap_handle || !addr) {
             return false;
         }
-        mem_rwlock.write_lock();
-        const auto it = std::find(mem_list.begin(), mem_list.end(),
-                                  std::make_pair(heap_handle, addr));
-        if (it != mem_list.end()) {
-            *it = std::make_pair(nullptr, nullptr);
-        }
-        mem_rwlock.write_unlock();
+        mem_list.erase(addr);
         if (!HeapFree(heap_handle, 0, addr)) {
             error_code = GetLastError();
             return false;
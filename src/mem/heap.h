@@ -31,14 +31,15 @@
 #include <winnt.h>
 #include <string>
 #include <vector>
-#include "sync/rwlock.h"
+#include "sync/futex_rwlock.h"
+#include "registry.h"
 
 namespace YanLib::mem {
     class heap {
         std::vector<HANDLE> heap_handles = {};
-        std::vector<std::pair<HANDLE, void *>> mem_list = {};
-        sync::rwlock heap_rwlock = {};
-        sync::rwlock mem_rwlock = {};
+        // block -> owning heap handle
+        registry mem_list = {};
+        sync::futex_rwlock heap_rwlock = {};
         uint32_t error_code = 0;
 
     public:
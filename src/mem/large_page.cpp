@@ -0,0 +1,87 @@
+/* clang-format off */
+/*
+ * @file large_page.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "large_page.h"
+#include <Windows.h>
+#include "helper/autoclean.h"
+
+namespace YanLib::mem {
+    namespace {
+        uint32_t g_error_code = 0;
+    } // namespace
+
+    size_t large_page::size() {
+        static const size_t minimum = GetLargePageMinimum();
+        return minimum;
+    }
+
+    bool large_page::enable() {
+        static const bool enabled = [] {
+            if (!size()) {
+                g_error_code = ERROR_NOT_SUPPORTED;
+                return false;
+            }
+            helper::autoclean<HANDLE> token_handle(nullptr);
+            if (!OpenProcessToken(GetCurrentProcess(),
+                                  TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY,
+                                  token_handle)) {
+                g_error_code = GetLastError();
+                return false;
+            }
+            TOKEN_PRIVILEGES tp;
+            tp.PrivilegeCount = 1;
+            if (!LookupPrivilegeValueW(nullptr, SE_LOCK_MEMORY_NAME,
+                                       &tp.Privileges[0].Luid)) {
+                g_error_code = GetLastError();
+                return false;
+            }
+            tp.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+            // succeeds with ERROR_NOT_ALL_ASSIGNED when the account lacks
+            // the privilege
+            if (!AdjustTokenPrivileges(token_handle, FALSE, &tp, sizeof(tp),
+                                       nullptr, nullptr) ||
+                GetLastError() != ERROR_SUCCESS) {
+                g_error_code = GetLastError();
+                return false;
+            }
+            return true;
+        }();
+        return enabled;
+    }
+
+    size_t large_page::round_up(const size_t bytes) {
+        const size_t page = size();
+        if (!page) {
+            return bytes;
+        }
+        return (bytes + page - 1) / page * page;
+    }
+
+    uint32_t large_page::err_code() {
+        return g_error_code;
+    }
+} // namespace YanLib::mem
@@ -0,0 +1,52 @@
+/* clang-format off */
+/*
+ * @file large_page.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef LARGE_PAGE_H
+#define LARGE_PAGE_H
+#include <cstddef>
+#include <cstdint>
+
+namespace YanLib::mem {
+    // Large pages need SeLockMemoryPrivilege in the process token and a
+    // size that is a multiple of the large page minimum.
+    class large_page {
+    public:
+        large_page() = delete;
+
+        // large page minimum in bytes, 0 when the system has none
+        [[nodiscard]] static size_t size();
+
+        // enables SeLockMemoryPrivilege once, later calls return the result
+        static bool enable();
+
+        [[nodiscard]] static size_t round_up(size_t bytes);
+
+        // error of the failed enable(), 0 after success
+        [[nodiscard]] static uint32_t err_code();
+    };
+} // namespace YanLib::mem
+#endif // LARGE_PAGE_H
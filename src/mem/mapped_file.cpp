@@ -0,0 +1,400 @@
+/* clang-format off */
+/*
+ * @file mapped_file.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "mapped_file.h"
+#ifdef _WIN32
+#include <Windows.h>
+#include "helper/convert.h"
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace YanLib::mem {
+    namespace {
+        uint32_t last_error() {
+#ifdef _WIN32
+            return GetLastError();
+#else
+            return static_cast<uint32_t>(errno);
+#endif
+        }
+
+#ifdef _WIN32
+        uint32_t page_protect(const MapMode mode) {
+            switch (mode) {
+                case MapMode::ReadWrite:
+                    return PAGE_READWRITE;
+                case MapMode::CopyOnWrite:
+                    return PAGE_WRITECOPY;
+                default:
+                    return PAGE_READONLY;
+            }
+        }
+
+        uint32_t view_access(const MapMode mode) {
+            switch (mode) {
+                case MapMode::ReadWrite:
+                    return FILE_MAP_READ | FILE_MAP_WRITE;
+                case MapMode::CopyOnWrite:
+                    return FILE_MAP_COPY;
+                default:
+                    return FILE_MAP_READ;
+            }
+        }
+#endif
+    } // namespace
+
+    mapped_file::~mapped_file() {
+        close();
+    }
+
+    bool mapped_file::open_mapping() {
+#ifdef _WIN32
+        LARGE_INTEGER length = {};
+        if (!GetFileSizeEx(file_handle, &length)) {
+            error_code = GetLastError();
+            close();
+            return false;
+        }
+        file_size = static_cast<uint64_t>(length.QuadPart);
+        // an empty file cannot be mapped, it simply has no bytes to view
+        if (!file_size) {
+            return true;
+        }
+        mapping_handle = CreateFileMappingW(file_handle, nullptr,
+                                            page_protect(map_mode), 0, 0,
+                                            nullptr);
+        if (!mapping_handle) {
+            error_code = GetLastError();
+            close();
+            return false;
+        }
+        return true;
+#else
+        struct stat st = {};
+        if (fstat(fd, &st) != 0) {
+            error_code = last_error();
+            close();
+            return false;
+        }
+        file_size = static_cast<uint64_t>(st.st_size);
+        return true;
+#endif
+    }
+
+    bool mapped_file::open(const char *path, const MapMode mode) {
+        close();
+        if (!path) {
+            return false;
+        }
+        map_mode = mode;
+#ifdef _WIN32
+        const uint32_t access = mode == MapMode::ReadWrite
+                ? GENERIC_READ | GENERIC_WRITE
+                : GENERIC_READ;
+        HANDLE handle = CreateFileA(
+                path, access,
+                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            error_code = GetLastError();
+            return false;
+        }
+        file_handle = handle;
+#else
+        fd = ::open(path, mode == MapMode::ReadWrite ? O_RDWR : O_RDONLY);
+        if (fd < 0) {
+            error_code = last_error();
+            return false;
+        }
+#endif
+        return open_mapping();
+    }
+
+#ifdef _WIN32
+    bool mapped_file::open(const wchar_t *path, const MapMode mode) {
+        close();
+        if (!path) {
+            return false;
+        }
+        map_mode = mode;
+        const uint32_t access = mode == MapMode::ReadWrite
+                ? GENERIC_READ | GENERIC_WRITE
+                : GENERIC_READ;
+        HANDLE handle = CreateFileW(
+                path, access,
+                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            error_code = GetLastError();
+            return false;
+        }
+        file_handle = handle;
+        return open_mapping();
+    }
+#endif
+
+    void mapped_file::close() {
+#ifdef _WIN32
+        if (mapping_handle) {
+            CloseHandle(mapping_handle);
+            mapping_handle = nullptr;
+        }
+        if (file_handle) {
+            CloseHandle(file_handle);
+            file_handle = nullptr;
+        }
+#else
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+#endif
+        file_size = 0;
+    }
+
+    bool mapped_file::is_open() const {
+#ifdef _WIN32
+        return file_handle != nullptr;
+#else
+        return fd >= 0;
+#endif
+    }
+
+    uint64_t mapped_file::size() const {
+        return file_size;
+    }
+
+    MapMode mapped_file::mode() const {
+        return map_mode;
+    }
+
+    size_t mapped_file::granularity() {
+#ifdef _WIN32
+        static const size_t value = [] {
+            SYSTEM_INFO info = {};
+            GetSystemInfo(&info);
+            return static_cast<size_t>(info.dwAllocationGranularity);
+        }();
+#else
+        static const size_t value = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+        return value;
+    }
+
+    uint32_t mapped_file::err_code() const {
+        return error_code;
+    }
+
+    std::string mapped_file::err_string() const {
+#ifdef _WIN32
+        std::string result = helper::convert::err_string(error_code);
+#else
+        std::string result = std::strerror(static_cast<int>(error_code));
+#endif
+        return result;
+    }
+
+    mapped_view::mapped_view(mapped_file &file, const size_t window_size)
+        : file(file), window_size(window_size) {
+    }
+
+    mapped_view::~mapped_view() {
+        unmap();
+    }
+
+    bool mapped_view::remap(const uint64_t offset, const size_t length) {
+        unmap();
+        const uint64_t align = mapped_file::granularity();
+        uint64_t start = window_size ? offset / align * align : 0;
+        uint64_t end = window_size ? start + window_size : file.file_size;
+        if (end < offset + length) {
+            end = offset + length;
+        }
+        if (end > file.file_size) {
+            end = file.file_size;
+        }
+        if (end - start > SIZE_MAX) {
+            // a whole-file view of a huge file on a 32-bit build
+#ifdef _WIN32
+            error_code = ERROR_NOT_ENOUGH_MEMORY;
+#else
+            error_code = ENOMEM;
+#endif
+            return false;
+        }
+        const auto size = static_cast<size_t>(end - start);
+#ifdef _WIN32
+        void *addr = MapViewOfFile(file.mapping_handle,
+                                   view_access(file.map_mode),
+                                   static_cast<uint32_t>(start >> 32),
+                                   static_cast<uint32_t>(start), size);
+        if (!addr) {
+            error_code = GetLastError();
+            return false;
+        }
+#else
+        const int prot = file.map_mode == MapMode::ReadOnly
+                ? PROT_READ
+                : PROT_READ | PROT_WRITE;
+        const int flags = file.map_mode == MapMode::CopyOnWrite
+                ? MAP_PRIVATE
+                : MAP_SHARED;
+        void *addr = ::mmap(nullptr, size, prot, flags, file.fd,
+                            static_cast<off_t>(start));
+        if (addr == MAP_FAILED) {
+            error_code = last_error();
+            return false;
+        }
+#endif
+        base = static_cast<uint8_t *>(addr);
+        base_size = size;
+        base_offset = start;
+        return true;
+    }
+
+    byte_span mapped_view::bytes(const uint64_t offset, const size_t length) {
+        if (!length || offset > file.file_size ||
+            length > file.file_size - offset) {
+            return {};
+        }
+        if (!base || offset < base_offset ||
+            offset + length > base_offset + base_size) {
+            if (!remap(offset, length)) {
+                return {};
+            }
+        }
+        return {base + (offset - base_offset), length};
+    }
+
+    uint8_t *mapped_view::data(const uint64_t offset, const size_t length) {
+        if (file.map_mode == MapMode::ReadOnly) {
+            return nullptr;
+        }
+        return const_cast<uint8_t *>(bytes(offset, length).data());
+    }
+
+    bool mapped_view::advise(const MapAdvice advice) {
+        if (!base) {
+            return false;
+        }
+#ifdef _WIN32
+        switch (advice) {
+            case MapAdvice::Sequential:
+            case MapAdvice::WillNeed: {
+                WIN32_MEMORY_RANGE_ENTRY entry = {base, base_size};
+                if (!PrefetchVirtualMemory(GetCurrentProcess(), 1, &entry,
+                                           0)) {
+                    error_code = GetLastError();
+                    return false;
+                }
+                return true;
+            }
+            case MapAdvice::DontNeed:
+                // unlocking pages that are not locked trims them from the
+                // working set, which is all that can be done for a view
+                VirtualUnlock(base, base_size);
+                return true;
+            default:
+                // no per-range policy on Windows, read-ahead follows access
+                return true;
+        }
+#else
+        int value = MADV_NORMAL;
+        switch (advice) {
+            case MapAdvice::Sequential:
+                value = MADV_SEQUENTIAL;
+                break;
+            case MapAdvice::Random:
+                value = MADV_RANDOM;
+                break;
+            case MapAdvice::WillNeed:
+                value = MADV_WILLNEED;
+                break;
+            case MapAdvice::DontNeed:
+                value = MADV_DONTNEED;
+                break;
+            default:
+                break;
+        }
+        if (madvise(base, base_size, value) != 0) {
+            error_code = last_error();
+            return false;
+        }
+        return true;
+#endif
+    }
+
+    bool mapped_view::flush() {
+        if (!base) {
+            return false;
+        }
+#ifdef _WIN32
+        if (!FlushViewOfFile(base, base_size)) {
+            error_code = GetLastError();
+            return false;
+        }
+#else
+        if (msync(base, base_size, MS_SYNC) != 0) {
+            error_code = last_error();
+            return false;
+        }
+#endif
+        return true;
+    }
+
+    void mapped_view::unmap() {
+        if (!base) {
+            return;
+        }
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+#else
+        munmap(base, base_size);
+#endif
+        base = nullptr;
+        base_size = 0;
+        base_offset = 0;
+    }
+
+    uint64_t mapped_view::window_offset() const {
+        return base_offset;
+    }
+
+    size_t mapped_view::window_bytes() const {
+        return base_size;
+    }
+
+    uint32_t mapped_view::err_code() const {
+        return error_code;
+    }
+} // namespace YanLib::mem
@@ -0,0 +1,155 @@
+/* clang-format off */
+/*
+ * @file mapped_file.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+#include <cstdint>
+#include <string>
+#include "byte_span.h"
+
+namespace YanLib::mem {
+    // CopyOnWrite opens the file read-only; written pages become private
+    // to the view and are dropped with it, the file never changes.
+    enum class MapMode : uint8_t {
+        ReadOnly,
+        ReadWrite,
+        CopyOnWrite,
+    };
+
+    enum class MapAdvice : uint8_t {
+        Normal,
+        Sequential,
+        Random,
+        WillNeed,
+        DontNeed,
+    };
+
+    // A file opened for mapping, on Win32 and POSIX alike. The bytes are
+    // reached through one or more mapped_view windows.
+    class mapped_file {
+    private:
+#ifdef _WIN32
+        void *file_handle = nullptr;
+        void *mapping_handle = nullptr;
+#else
+        int fd = -1;
+#endif
+        MapMode map_mode = MapMode::ReadOnly;
+        uint64_t file_size = 0;
+        uint32_t error_code = 0;
+
+        bool open_mapping();
+
+        friend class mapped_view;
+
+    public:
+        mapped_file(const mapped_file &other) = delete;
+
+        mapped_file(mapped_file &&other) = delete;
+
+        mapped_file &operator=(const mapped_file &other) = delete;
+
+        mapped_file &operator=(mapped_file &&other) = delete;
+
+        mapped_file() = default;
+
+        ~mapped_file();
+
+        bool open(const char *path, MapMode mode = MapMode::ReadOnly);
+
+#ifdef _WIN32
+        bool open(const wchar_t *path, MapMode mode = MapMode::ReadOnly);
+#endif
+
+        void close();
+
+        [[nodiscard]] bool is_open() const;
+
+        [[nodiscard]] uint64_t size() const;
+
+        [[nodiscard]] MapMode mode() const;
+
+        // view offsets are aligned down to this
+        [[nodiscard]] static size_t granularity();
+
+        [[nodiscard]] uint32_t err_code() const;
+
+        [[nodiscard]] std::string err_string() const;
+    };
+
+    // A window onto a mapped_file that slides along as other ranges are
+    // asked for, so files larger than the address space budget can be
+    // walked through a fixed amount of it.
+    class mapped_view {
+    private:
+        mapped_file &file;
+        size_t window_size;
+        uint8_t *base = nullptr;
+        size_t base_size = 0;
+        uint64_t base_offset = 0;
+        uint32_t error_code = 0;
+
+        bool remap(uint64_t offset, size_t length);
+
+    public:
+        mapped_view(const mapped_view &other) = delete;
+
+        mapped_view(mapped_view &&other) = delete;
+
+        mapped_view &operator=(const mapped_view &other) = delete;
+
+        mapped_view &operator=(mapped_view &&other) = delete;
+
+        // window_size 0 maps the whole file on first use
+        explicit mapped_view(mapped_file &file, size_t window_size = 0);
+
+        ~mapped_view();
+
+        // Bytes [offset, offset + length) of the file, remapping when they
+        // are not inside the window. Valid until the next remap; empty past
+        // the end of the file or on error.
+        byte_span bytes(uint64_t offset, size_t length);
+
+        // as bytes(), nullptr for a ReadOnly file; with CopyOnWrite the
+        // edits last only until the window moves
+        uint8_t *data(uint64_t offset, size_t length);
+
+        // hint for the current window (madvise, PrefetchVirtualMemory)
+        bool advise(MapAdvice advice);
+
+        bool flush();
+
+        void unmap();
+
+        [[nodiscard]] uint64_t window_offset() const;
+
+        [[nodiscard]] size_t window_bytes() const;
+
+        [[nodiscard]] uint32_t err_code() const;
+    };
+} // namespace YanLib::mem
+#endif // MAPPED_FILE_H
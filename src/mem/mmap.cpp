@@ -26,17 +26,50 @@
  */
 /* clang-format on */
 #include "mmap.h"
+#include <cstring>
 #include "helper/convert.h"
+#include "large_page.h"
 
 namespace YanLib::mem {
-    mmap::~mmap() {
-        for (auto &addr : addr_list) {
-            if (addr) {
-                UnmapViewOfFile(addr);
-                addr = nullptr;
+    namespace {
+        // GENERIC_WRITE only when the section can write through to the file
+        uint32_t file_access(const MemoryProtect protect) {
+            const uint32_t page = static_cast<uint32_t>(protect) & 0xFF;
+            return page == PAGE_READWRITE || page == PAGE_EXECUTE_READWRITE
+                    ? GENERIC_READ | GENERIC_WRITE
+                    : GENERIC_READ;
+        }
+
+        MemoryProtect page_protect(const MapMode mode) {
+            switch (mode) {
+                case MapMode::ReadWrite:
+                    return MemoryProtect::ReadWrite;
+                case MapMode::CopyOnWrite:
+                    return MemoryProtect::WriteCopy;
+                default:
+                    return MemoryProtect::ReadOnly;
+            }
+        }
+
+        MemoryAccess view_access(const MapMode mode) {
+            switch (mode) {
+                case MapMode::ReadWrite:
+                    return MemoryAccess::Read | MemoryAccess::Write;
+                case MapMode::CopyOnWrite:
+                    return MemoryAccess::Copy;
+                default:
+                    return MemoryAccess::Read;
             }
         }
-        addr_list.clear();
+
+        constexpr uint32_t SHARE_ALL =
+                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE;
+    } // namespace
+
+    mmap::~mmap() {
+        for (const auto &[addr, value] : addr_list.drain()) {
+            UnmapViewOfFile(addr);
+        }
         for (auto &mmap_handle : mmap_handles) {
             CloseHandle(mmap_handle);
             mmap_handle = nullptr;
@@ -56,7 +89,7 @@ namespace YanLib::mem {
                         const uint32_t max_high,
                         const uint32_t max_low) {
         HANDLE file_handle =
-                CreateFileA(file_name, GENERIC_READ | GENERIC_WRITE,
+                CreateFileA(file_name, file_access(protect),
                             FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
         if (file_handle == INVALID_HANDLE_VALUE) {
@@ -73,6 +106,7 @@ namespace YanLib::mem {
             error_code = GetLastError();
             return nullptr;
         }
+        remember_size(mmap_handle, file_handle, max_high, max_low);
         mmap_rwlock.write_lock();
         mmap_handles.push_back(mmap_handle);
         mmap_rwlock.write_unlock();
@@ -86,7 +120,7 @@ namespace YanLib::mem {
                         const uint32_t max_high,
                         const uint32_t max_low) {
         HANDLE file_handle =
-                CreateFileW(file_name, GENERIC_READ | GENERIC_WRITE,
+                CreateFileW(file_name, file_access(protect),
                             FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
         if (file_handle == INVALID_HANDLE_VALUE) {
@@ -103,6 +137,7 @@ namespace YanLib::mem {
             error_code = GetLastError();
             return nullptr;
         }
+        remember_size(mmap_handle, file_handle, max_high, max_low);
         mmap_rwlock.write_lock();
         mmap_handles.push_back(mmap_handle);
         mmap_rwlock.write_unlock();
@@ -122,6 +157,7 @@ namespace YanLib::mem {
             error_code = GetLastError();
             return nullptr;
         }
+        remember_size(mmap_handle, file_handle, max_high, max_low);
         mmap_rwlock.write_lock();
         mmap_handles.push_back(mmap_handle);
         mmap_rwlock.write_unlock();
@@ -141,6 +177,142 @@ namespace YanLib::mem {
             error_code = GetLastError();
             return nullptr;
         }
+        remember_size(mmap_handle, file_handle, max_high, max_low);
+        mmap_rwlock.write_lock();
+        mmap_handles.push_back(mmap_handle);
+        mmap_rwlock.write_unlock();
+        return mmap_handle;
+    }
+
+    HANDLE mmap::create(const char *file_name,
+                        const MapMode mode,
+                        const char *mmap_name,
+                        SECURITY_ATTRIBUTES *sa) {
+        const MemoryProtect protect = page_protect(mode);
+        HANDLE file_handle =
+                CreateFileA(file_name, file_access(protect), SHARE_ALL,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+        if (file_handle == INVALID_HANDLE_VALUE) {
+            error_code = GetLastError();
+            return nullptr;
+        }
+        file_rwlock.write_lock();
+        file_handles.push_back(file_handle);
+        file_rwlock.write_unlock();
+        return create(file_handle, mmap_name, sa, protect);
+    }
+
+    HANDLE mmap::create(const wchar_t *file_name,
+                        const MapMode mode,
+                        const wchar_t *mmap_name,
+                        SECURITY_ATTRIBUTES *sa) {
+        const MemoryProtect protect = page_protect(mode);
+        HANDLE file_handle =
+                CreateFileW(file_name, file_access(protect), SHARE_ALL,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+        if (file_handle == INVALID_HANDLE_VALUE) {
+            error_code = GetLastError();
+            return nullptr;
+        }
+        file_rwlock.write_lock();
+        file_handles.push_back(file_handle);
+        file_rwlock.write_unlock();
+        return create(file_handle, mmap_name, sa, protect);
+    }
+
+    HANDLE mmap::create(HANDLE file_handle,
+                        const MapMode mode,
+                        const char *mmap_name,
+                        SECURITY_ATTRIBUTES *sa) {
+        return create(file_handle, mmap_name, sa, page_protect(mode));
+    }
+
+    HANDLE mmap::create_anonymous(const char *mmap_name,
+                                  const uint64_t size,
+                                  const bool large_pages,
+                                  SECURITY_ATTRIBUTES *sa) {
+        HANDLE mmap_handle = nullptr;
+        if (large_pages && large_page::enable()) {
+            const uint64_t length = large_page::round_up(size);
+            mmap_handle = CreateFileMappingA(
+                    INVALID_HANDLE_VALUE, sa,
+                    PAGE_READWRITE | SEC_COMMIT | SEC_LARGE_PAGES,
+                    static_cast<uint32_t>(length >> 32),
+                    static_cast<uint32_t>(length), mmap_name);
+            if (mmap_handle) {
+                remember_size(mmap_handle, INVALID_HANDLE_VALUE,
+                              static_cast<uint32_t>(length >> 32),
+                              static_cast<uint32_t>(length));
+                large_handles.insert(mmap_handle);
+            } else {
+                error_code = GetLastError();
+            }
+        } else if (large_pages) {
+            error_code = large_page::err_code();
+        }
+        if (!mmap_handle) {
+            mmap_handle = CreateFileMappingA(INVALID_HANDLE_VALUE, sa,
+                                             PAGE_READWRITE,
+                                             static_cast<uint32_t>(size >> 32),
+                                             static_cast<uint32_t>(size),
+                                             mmap_name);
+            if (mmap_handle) {
+                remember_size(mmap_handle, INVALID_HANDLE_VALUE,
+                              static_cast<uint32_t>(size >> 32),
+                              static_cast<uint32_t>(size));
+            }
+        }
+        if (!mmap_handle) {
+            error_code = GetLastError();
+            return nullptr;
+        }
+        mmap_rwlock.write_lock();
+        mmap_handles.push_back(mmap_handle);
+        mmap_rwlock.write_unlock();
+        return mmap_handle;
+    }
+
+    HANDLE mmap::create_anonymous(const wchar_t *mmap_name,
+                                  const uint64_t size,
+                                  const bool large_pages,
+                                  SECURITY_ATTRIBUTES *sa) {
+        HANDLE mmap_handle = nullptr;
+        if (large_pages && large_page::enable()) {
+            const uint64_t length = large_page::round_up(size);
+            mmap_handle = CreateFileMappingW(
+                    INVALID_HANDLE_VALUE, sa,
+                    PAGE_READWRITE | SEC_COMMIT | SEC_LARGE_PAGES,
+                    static_cast<uint32_t>(length >> 32),
+                    static_cast<uint32_t>(length), mmap_name);
+            if (mmap_handle) {
+                remember_size(mmap_handle, INVALID_HANDLE_VALUE,
+                              static_cast<uint32_t>(length >> 32),
+                              static_cast<uint32_t>(length));
+                large_handles.insert(mmap_handle);
+            } else {
+                error_code = GetLastError();
+            }
+        } else if (large_pages) {
+            error_code = large_page::err_code();
+        }
+        if (!mmap_handle) {
+            mmap_handle = CreateFileMappingW(INVALID_HANDLE_VALUE, sa,
+                                             PAGE_READWRITE,
+                                             static_cast<uint32_t>(size >> 32),
+                                             static_cast<uint32_t>(size),
+                                             mmap_name);
+            if (mmap_handle) {
+                remember_size(mmap_handle, INVALID_HANDLE_VALUE,
+                              static_cast<uint32_t>(size >> 32),
+                              static_cast<uint32_t>(size));
+            }
+        }
+        if (!mmap_handle) {
+            error_code = GetLastError();
+            return nullptr;
+        }
         mmap_rwlock.write_lock();
         mmap_handles.push_back(mmap_handle);
         mmap_rwlock.write_unlock();
@@ -186,29 +358,72 @@ namespace YanLib::mem {
                           const uint32_t offset_high,
                           const uint32_t offset_low,
                           const SIZE_T size) {
-        void *address =
-                MapViewOfFile(mmap_handle, static_cast<uint32_t>(access),
-                              offset_high, offset_low, size);
+        return mmap_file(mmap_handle,
+                         static_cast<uint64_t>(offset_high) << 32 | offset_low,
+                         size, access);
+    }
+
+    void *mmap::mmap_file(HANDLE mmap_handle,
+                          const uint64_t offset,
+                          const size_t size,
+                          MemoryAccess access) {
+        const auto offset_high = static_cast<uint32_t>(offset >> 32);
+        const auto offset_low = static_cast<uint32_t>(offset);
+        const bool large = large_handles.find(mmap_handle);
+        void *address = nullptr;
+        if (large) {
+            // views of a large-page section must say so (Windows 10 1703+),
+            // older systems reject the flag and map large pages anyway
+            address = MapViewOfFile(
+                    mmap_handle,
+                    static_cast<uint32_t>(access | MemoryAccess::LargePages),
+                    offset_high, offset_low, size);
+        }
+        if (!address) {
+            address = MapViewOfFile(mmap_handle, static_cast<uint32_t>(access),
+                                    offset_high, offset_low, size);
+        }
         if (!address) {
             error_code = GetLastError();
             return nullptr;
         }
-        addr_rwlock.write_lock();
-        addr_list.push_back(address);
-        addr_rwlock.write_unlock();
+        uint64_t bytes = size;
+        if (uintptr_t section_size = 0;
+            !bytes && section_sizes.find(mmap_handle, &section_size)) {
+            // the rest of the section, not the page-rounded region
+            bytes = section_size - offset;
+        } else if (!bytes) {
+            // a section opened by name has no size to ask for, so the
+            // view may run up to the end of its last page
+            MEMORY_BASIC_INFORMATION info = {};
+            VirtualQuery(address, &info, sizeof(info));
+            bytes = info.RegionSize;
+        }
+        const bool writable = static_cast<uint32_t>(access) &
+                (FILE_MAP_WRITE | FILE_MAP_COPY);
+        addr_list.insert(address,
+                         bytes << 2 | (writable ? 2 : 0) | (large ? 1 : 0));
+        if (large) {
+            large_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
         return address;
     }
 
+    void *mmap::mmap_file(HANDLE mmap_handle,
+                          const MapMode mode,
+                          const uint64_t offset,
+                          const size_t size) {
+        return mmap_file(mmap_handle, offset, size, view_access(mode));
+    }
+
     bool mmap::unmap_file(const void *addr) {
         if (!addr) {
             return false;
         }
-        addr_rwlock.write_lock();
-        if (const auto it = std::find(addr_list.begin(), addr_list.end(), addr);
-            it != addr_list.end()) {
-            *it = nullptr;
+        if (uintptr_t value = 0;
+            addr_list.erase(addr, &value) && (value & 1)) {
+            large_bytes.fetch_sub(value >> 2, std::memory_order_relaxed);
         }
-        addr_rwlock.write_unlock();
         if (!UnmapViewOfFile(addr)) {
             error_code = GetLastError();
             return false;
@@ -216,14 +431,65 @@ namespace YanLib::mem {
         return true;
     }
 
+    byte_span mmap::view(const void *addr) const {
+        uintptr_t value = 0;
+        if (!addr || !addr_list.find(addr, &value)) {
+            return {};
+        }
+        return {static_cast<const uint8_t *>(addr),
+                static_cast<size_t>(value >> 2)};
+    }
+
+    void mmap::remember_size(HANDLE mmap_handle,
+                             HANDLE file_handle,
+                             const uint32_t max_high,
+                             const uint32_t max_low) {
+        // a named section that already existed keeps its own size
+        if (GetLastError() == ERROR_ALREADY_EXISTS) {
+            return;
+        }
+        // a zero maximum makes the section exactly as large as the file
+        uint64_t size = static_cast<uint64_t>(max_high) << 32 | max_low;
+        if (!size) {
+            LARGE_INTEGER file_size = {};
+            if (!GetFileSizeEx(file_handle, &file_size)) {
+                return;
+            }
+            size = static_cast<uint64_t>(file_size.QuadPart);
+        }
+        section_sizes.insert(mmap_handle, static_cast<uintptr_t>(size));
+    }
+
+    bool mmap::in_view(const void *addr,
+                       const uint64_t offset,
+                       const int64_t size,
+                       const bool for_write) const {
+        if (!addr || size < 0) {
+            return false;
+        }
+        // addr may point anywhere inside a view, find the view it belongs to
+        MEMORY_BASIC_INFORMATION info = {};
+        uintptr_t value = 0;
+        if (!VirtualQuery(addr, &info, sizeof(info)) ||
+            !addr_list.find(info.AllocationBase, &value) ||
+            (for_write && !(value & 2))) {
+            return false;
+        }
+        const uint64_t start = static_cast<const uint8_t *>(addr) -
+                static_cast<const uint8_t *>(info.AllocationBase);
+        const uint64_t view_size = value >> 2;
+        return start <= view_size && offset <= view_size - start &&
+                static_cast<uint64_t>(size) <= view_size - start - offset;
+    }
+
     bool mmap::read(void *addr,
                     uint8_t *buf,
                     const int64_t size,
                     const uint64_t offset) const {
-        if (!buf || !addr) {
+        if (!buf || !in_view(addr, offset, size)) {
             return false;
         }
-        memcpy_s(buf, size, static_cast<uint8_t *>(addr) + offset, size);
+        memcpy(buf, static_cast<uint8_t *>(addr) + offset, size);
         return true;
     }
 
@@ -231,14 +497,18 @@ namespace YanLib::mem {
                      const uint8_t *buf,
                      const int64_t size,
                      const uint64_t offset) const {
-        if (!buf || !addr) {
+        if (!buf || !in_view(addr, offset, size, true)) {
             return false;
         }
-        memcpy_s(static_cast<uint8_t *>(addr) + offset, size, buf, size);
+        memcpy(static_cast<uint8_t *>(addr) + offset, buf, size);
         FlushViewOfFile(addr, 0);
         return true;
     }
 
+    size_t mmap::large_page_bytes() const {
+        return large_bytes.load(std::memory_order_relaxed);
+    }
+
     uint32_t mmap::err_code() const {
         return error_code;
     }
@@ -30,21 +30,40 @@
 #include <Windows.h>
 #include <winnt.h>
 #include <minwinbase.h>
+#include <atomic>
 #include <string>
 #include <vector>
-#include "sync/rwlock.h"
+#include "sync/futex_rwlock.h"
+#include "byte_span.h"
+#include "mapped_file.h"
 #include "mem.h"
+#include "registry.h"
 namespace YanLib::mem {
     class mmap {
     private:
         std::vector<HANDLE> file_handles = {};
         std::vector<HANDLE> mmap_handles = {};
-        std::vector<void *> addr_list = {};
-        sync::rwlock file_rwlock = {};
-        sync::rwlock mmap_rwlock = {};
-        sync::rwlock addr_rwlock = {};
+        // view -> view size << 2 | writable << 1 | on large pages
+        mutable registry addr_list = {};
+        // section -> section size in bytes, for sections created here
+        registry section_sizes = {};
+        // sections on large pages
+        registry large_handles = {};
+        std::atomic<size_t> large_bytes{0};
+        sync::futex_rwlock file_rwlock = {};
+        sync::futex_rwlock mmap_rwlock = {};
         uint32_t error_code = 0;
 
+        void remember_size(HANDLE mmap_handle,
+                           HANDLE file_handle,
+                           uint32_t max_high,
+                           uint32_t max_low);
+
+        bool in_view(const void *addr,
+                     uint64_t offset,
+                     int64_t size,
+                     bool for_write = false) const;
+
     public:
         mmap(const mmap &other) = delete;
 
@@ -58,6 +77,8 @@ namespace YanLib::mem {
 
         ~mmap();
 
+        // The file is opened with only the access protect needs, so
+        // ReadOnly and WriteCopy sections work on read-only media.
         HANDLE create(const char *file_name,
                       const char *mmap_name = nullptr,
                       SECURITY_ATTRIBUTES *sa = nullptr,
@@ -86,6 +107,38 @@ namespace YanLib::mem {
                       uint32_t max_high = 0,
                       uint32_t max_low = 0);
 
+        // ReadOnly sections share clean pages with every other reader of
+        // the file; CopyOnWrite views give each writer private copies of
+        // the pages it touches and leave the file as it is.
+        HANDLE create(const char *file_name,
+                      MapMode mode,
+                      const char *mmap_name = nullptr,
+                      SECURITY_ATTRIBUTES *sa = nullptr);
+
+        HANDLE create(const wchar_t *file_name,
+                      MapMode mode,
+                      const wchar_t *mmap_name = nullptr,
+                      SECURITY_ATTRIBUTES *sa = nullptr);
+
+        // file_handle needs GENERIC_WRITE only for MapMode::ReadWrite
+        HANDLE create(HANDLE file_handle,
+                      MapMode mode,
+                      const char *mmap_name = nullptr,
+                      SECURITY_ATTRIBUTES *sa = nullptr);
+
+        // Section backed by the paging file. large_pages asks for
+        // SEC_LARGE_PAGES and falls back to normal pages when the privilege
+        // or the memory is missing; see large_page_bytes().
+        HANDLE create_anonymous(const char *mmap_name,
+                                uint64_t size,
+                                bool large_pages = false,
+                                SECURITY_ATTRIBUTES *sa = nullptr);
+
+        HANDLE create_anonymous(const wchar_t *mmap_name,
+                                uint64_t size,
+                                bool large_pages = false,
+                                SECURITY_ATTRIBUTES *sa = nullptr);
+
         HANDLE open(const char *mmap_name,
                     MemoryAccess access = MemoryAccess::Read |
                             MemoryAccess::Write,
@@ -103,8 +156,26 @@ namespace YanLib::mem {
                         uint32_t offset_low = 0,
                         uint64_t size = 0);
 
+        void *mmap_file(HANDLE mmap_handle,
+                        uint64_t offset,
+                        size_t size,
+                        MemoryAccess access = MemoryAccess::Read |
+                                MemoryAccess::Write);
+
+        // view of a section made by create(..., MapMode, ...), size 0 maps
+        // the rest of it
+        void *mmap_file(HANDLE mmap_handle,
+                        MapMode mode,
+                        uint64_t offset = 0,
+                        size_t size = 0);
+
         bool unmap_file(const void *addr);
 
+        // the bytes of a view returned by mmap_file, without copying
+        [[nodiscard]] byte_span view(const void *addr) const;
+
+        // read and write fail when the range leaves the view addr is in,
+        // write also on views mapped without write or copy access
         bool
         read(void *addr, uint8_t *buf, int64_t size, uint64_t offset = 0) const;
 
@@ -113,6 +184,8 @@ namespace YanLib::mem {
                    int64_t size,
                    uint64_t offset = 0) const;
 
+        [[nodiscard]] size_t large_page_bytes() const;
+
         [[nodiscard]] uint32_t err_code() const;
 
         [[nodiscard]] std::string err_string() const;
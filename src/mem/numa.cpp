@@ -0,0 +1,164 @@
+/* clang-format off */
+/*
+ * @file numa.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "numa.h"
+#include <Windows.h>
+#include <new>
+#include "helper/convert.h"
+#include "sys/processor.h"
+
+namespace YanLib::mem {
+    namespace {
+        // committed sizes are page multiples, the low bits carry the node
+        constexpr uintptr_t NODE_MASK = numa::max_nodes - 1;
+
+        size_t page_size() {
+            static const size_t size = [] {
+                SYSTEM_INFO info = {};
+                GetSystemInfo(&info);
+                return static_cast<size_t>(info.dwPageSize);
+            }();
+            return size;
+        }
+    } // namespace
+
+    numa::~numa() {
+        for (const auto &[mem, value] : mem_list.drain()) {
+            VirtualFree(const_cast<void *>(mem), 0, MEM_RELEASE);
+        }
+    }
+
+    uint32_t numa::node_count() {
+        static const uint32_t count = [] {
+            // 0 on failure as well, which leaves the single node
+            sys::processor cpu;
+            const uint32_t highest = cpu.numa_highest_node();
+            return highest + 1 < max_nodes ? highest + 1 : max_nodes;
+        }();
+        return count;
+    }
+
+    uint32_t numa::current_node() {
+        sys::processor cpu;
+        const uint16_t node = cpu.numa_node();
+        return node < max_nodes ? node : 0;
+    }
+
+    void *numa::malloc(const size_t size, uint32_t node) {
+        if (node == current) {
+            node = current_node();
+        }
+        if (node >= node_count()) {
+            error_code = ERROR_INVALID_PARAMETER;
+            return nullptr;
+        }
+        const size_t length = (size + page_size() - 1) & ~(page_size() - 1);
+        void *address = VirtualAllocExNuma(GetCurrentProcess(), nullptr,
+                                           length, MEM_RESERVE | MEM_COMMIT,
+                                           PAGE_READWRITE, node);
+        if (!address) {
+            error_code = GetLastError();
+            return nullptr;
+        }
+        mem_list.insert(address, length | node);
+        node_bytes[node].fetch_add(length, std::memory_order_relaxed);
+        return address;
+    }
+
+    bool numa::free(void *addr) {
+        if (!addr) {
+            return false;
+        }
+        uintptr_t value = 0;
+        if (!mem_list.erase(addr, &value)) {
+            error_code = ERROR_INVALID_ADDRESS;
+            return false;
+        }
+        node_bytes[value & NODE_MASK].fetch_sub(value & ~NODE_MASK,
+                                                std::memory_order_relaxed);
+        if (!VirtualFree(addr, 0, MEM_RELEASE)) {
+            error_code = GetLastError();
+            return false;
+        }
+        return true;
+    }
+
+    size_t numa::allocated_bytes(const uint32_t node) const {
+        if (node >= max_nodes) {
+            return 0;
+        }
+        return node_bytes[node].load(std::memory_order_relaxed);
+    }
+
+    uint64_t numa::available_bytes(const uint32_t node) {
+        sys::processor cpu;
+        uint64_t bytes = 0;
+        if (node >= max_nodes ||
+            !cpu.numa_available_memory(static_cast<uint16_t>(node), &bytes)) {
+            return 0;
+        }
+        return bytes;
+    }
+
+    uint32_t numa::err_code() const {
+        return error_code;
+    }
+
+    std::string numa::err_string() const {
+        std::string result = helper::convert::err_string(error_code);
+        return result;
+    }
+
+    std::wstring numa::err_wstring() const {
+        std::wstring result = helper::convert::err_wstring(error_code);
+        return result;
+    }
+
+    numa_resource::numa_resource(numa &owner, const uint32_t node)
+        : owner(owner), node(node) {
+    }
+
+    void *numa_resource::do_allocate(const size_t bytes,
+                                      const size_t alignment) {
+        // pages are aligned far beyond anything operator new asks for
+        (void)alignment;
+        void *ptr = owner.malloc(bytes, node);
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    void numa_resource::do_deallocate(void *p, size_t, size_t) {
+        owner.free(p);
+    }
+
+    bool numa_resource::do_is_equal(
+            const std::pmr::memory_resource &other) const noexcept {
+        return this == &other;
+    }
+} // namespace YanLib::mem
@@ -0,0 +1,118 @@
+/* clang-format off */
+/*
+ * @file numa.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef NUMA_H
+#define NUMA_H
+#include <atomic>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include "registry.h"
+
+namespace YanLib::mem {
+    // Page-granular allocation on a chosen NUMA node (VirtualAllocExNuma),
+    // with the bytes currently allocated per node.
+    class numa {
+    public:
+        static constexpr uint32_t max_nodes = 64;
+        // the node of the processor the calling thread runs on
+        static constexpr uint32_t current = UINT32_MAX;
+
+    private:
+        // block -> committed size, node number in the low bits
+        registry mem_list = {};
+        std::atomic<size_t> node_bytes[max_nodes] = {};
+        uint32_t error_code = 0;
+
+    public:
+        numa(const numa &other) = delete;
+
+        numa(numa &&other) = delete;
+
+        numa &operator=(const numa &other) = delete;
+
+        numa &operator=(numa &&other) = delete;
+
+        numa() = default;
+
+        ~numa();
+
+        [[nodiscard]] static uint32_t node_count();
+
+        [[nodiscard]] static uint32_t current_node();
+
+        // the node is preferred, Windows falls back to another one when the
+        // node runs out of memory
+        void *malloc(size_t size, uint32_t node = current);
+
+        bool free(void *addr);
+
+        // bytes this object has allocated on node and not freed yet
+        [[nodiscard]] size_t allocated_bytes(uint32_t node) const;
+
+        // free physical memory on node
+        [[nodiscard]] static uint64_t available_bytes(uint32_t node);
+
+        [[nodiscard]] uint32_t err_code() const;
+
+        [[nodiscard]] std::string err_string() const;
+
+        [[nodiscard]] std::wstring err_wstring() const;
+    };
+
+    // std::pmr adapter over numa, meant as the upstream of an arena. With
+    // numa::current each block goes to the node of the thread that grows
+    // the arena, so a worker's arena stays on the worker's node.
+    class numa_resource : public std::pmr::memory_resource {
+    private:
+        numa &owner;
+        uint32_t node;
+
+    protected:
+        void *do_allocate(size_t bytes, size_t alignment) override;
+
+        void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+
+        [[nodiscard]] bool
+        do_is_equal(const std::pmr::memory_resource &other) const noexcept
+                override;
+
+    public:
+        numa_resource(const numa_resource &other) = delete;
+
+        numa_resource(numa_resource &&other) = delete;
+
+        numa_resource &operator=(const numa_resource &other) = delete;
+
+        numa_resource &operator=(numa_resource &&other) = delete;
+
+        explicit numa_resource(numa &owner, uint32_t node = numa::current);
+
+        ~numa_resource() override = default;
+    };
+} // namespace YanLib::mem
+#endif // NUMA_H
@@ -0,0 +1,399 @@
+/* clang-format off */
+/*
+ * @file object_pool.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "object_pool.h"
+#include <cstring>
+#include <thread>
+#include <unordered_set>
+
+namespace YanLib::mem {
+    struct fixed_pool::thread_cache {
+        std::thread::id thread = {};
+        void *head = nullptr;
+        void *tail = nullptr;
+        uint32_t count = 0;
+        // written by the owning thread only, summed up by stats()
+        std::atomic<int64_t> in_use{0};
+    };
+
+    namespace {
+        constexpr uint32_t NIL = UINT32_MAX;
+        // chunk index in the high half of a slot index, slot in the low one
+        constexpr uint32_t SLOT_BITS = 16;
+        constexpr size_t CHUNK_HEADER = 64;
+        constexpr size_t MIN_CHUNK_BYTES = 64 * 1024;
+        constexpr size_t TARGET_PER_CHUNK = 4096;
+        constexpr size_t TLS_SLOTS = 4;
+
+        uint64_t pack(const uint32_t index, const uint32_t tag) {
+            return static_cast<uint64_t>(tag) << 32 | index;
+        }
+
+        uint32_t index_of(const uint64_t head) {
+            return static_cast<uint32_t>(head);
+        }
+
+        uint32_t tag_of(const uint64_t head) {
+            return static_cast<uint32_t>(head >> 32);
+        }
+
+        // a free slot in a thread cache starts with the link to the next
+        // one, the shared list links by index in the chunk's link array
+        void *&next_ptr(void *slot) {
+            return *static_cast<void **>(slot);
+        }
+
+        // the link array rounded up to a cache line, so the slots after it
+        // stay as aligned as the chunk header leaves them
+        size_t link_bytes(const size_t count) {
+            return (count * sizeof(std::atomic<uint32_t>) + CHUNK_HEADER - 1) &
+                    ~(CHUNK_HEADER - 1);
+        }
+
+        struct tls_slot {
+            uint64_t id;
+            fixed_pool::thread_cache *cache;
+        };
+
+        std::atomic<uint64_t> g_next_id{1};
+
+        // pools still alive, so exiting threads only touch those
+        std::mutex &live_mutex() {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        std::unordered_set<uint64_t> &live_pools() {
+            static std::unordered_set<uint64_t> pools;
+            return pools;
+        }
+
+        struct tls_caches {
+            tls_slot slots[TLS_SLOTS] = {};
+            fixed_pool *pools[TLS_SLOTS] = {};
+            size_t next = 0;
+
+            ~tls_caches() {
+                std::lock_guard lock(live_mutex());
+                for (size_t i = 0; i < TLS_SLOTS; ++i) {
+                    if (slots[i].id && live_pools().count(slots[i].id)) {
+                        pools[i]->flush();
+                    }
+                }
+            }
+        };
+
+        thread_local tls_caches t_caches;
+    } // namespace
+
+    fixed_pool::fixed_pool(const size_t object_size, const size_t align)
+        : id(g_next_id.fetch_add(1, std::memory_order_relaxed)),
+          free_head(pack(NIL, 0)) {
+        const size_t slot_align = align < sizeof(void *) ? sizeof(void *)
+                                                         : align;
+        size_t size = object_size < sizeof(void *) ? sizeof(void *)
+                                                   : object_size;
+        slot_size = (size + slot_align - 1) & ~(slot_align - 1);
+        // every slot also takes one entry of the link array
+        const size_t stride = slot_size + sizeof(std::atomic<uint32_t>);
+        chunk_bytes = MIN_CHUNK_BYTES;
+        while (chunk_bytes < CHUNK_HEADER + TARGET_PER_CHUNK * stride &&
+               (chunk_bytes - CHUNK_HEADER) / stride < (1u << SLOT_BITS) &&
+               chunk_bytes < (size_t{1} << 30)) {
+            chunk_bytes *= 2;
+        }
+        while (chunk_bytes < CHUNK_HEADER + link_bytes(1) + slot_size) {
+            chunk_bytes *= 2;
+        }
+        size_t per = (chunk_bytes - CHUNK_HEADER) / stride;
+        per = per < (1u << SLOT_BITS) ? per : (1u << SLOT_BITS) - 1;
+        while (CHUNK_HEADER + link_bytes(per) + per * slot_size >
+               chunk_bytes) {
+            --per;
+        }
+        per_chunk = static_cast<uint32_t>(per);
+        slots_offset = CHUNK_HEADER + link_bytes(per);
+        std::lock_guard lock(live_mutex());
+        live_pools().insert(id);
+    }
+
+    fixed_pool::~fixed_pool() {
+        {
+            std::lock_guard lock(live_mutex());
+            live_pools().erase(id);
+        }
+        for (auto &chunk : chunks) {
+            if (uint8_t *addr = chunk.load(std::memory_order_relaxed)) {
+                ::operator delete(addr, std::align_val_t(chunk_bytes));
+            }
+        }
+        for (const auto cache : caches) {
+            delete cache;
+        }
+    }
+
+    fixed_pool::thread_cache *fixed_pool::local_cache() {
+        for (const auto &slot : t_caches.slots) {
+            if (slot.id == id) {
+                return slot.cache;
+            }
+        }
+        // the slot may have gone to another pool, reuse what this thread
+        // already owns before making a new cache
+        const std::thread::id self = std::this_thread::get_id();
+        thread_cache *cache = nullptr;
+        {
+            std::lock_guard lock(mutex);
+            for (const auto c : caches) {
+                if (c->thread == self) {
+                    cache = c;
+                    break;
+                }
+            }
+            if (!cache) {
+                cache = new thread_cache;
+                cache->thread = self;
+                caches.push_back(cache);
+            }
+        }
+        const size_t i = t_caches.next;
+        t_caches.next = (i + 1) % TLS_SLOTS;
+        if (t_caches.slots[i].id) {
+            // an evicted cache would otherwise keep its slots to itself
+            std::lock_guard lock(live_mutex());
+            if (live_pools().count(t_caches.slots[i].id)) {
+                t_caches.pools[i]->flush();
+            }
+        }
+        t_caches.slots[i] = {id, cache};
+        t_caches.pools[i] = this;
+        return cache;
+    }
+
+    uint8_t *fixed_pool::slot_addr(const uint32_t index) const {
+        uint8_t *chunk =
+                chunks[index >> SLOT_BITS].load(std::memory_order_acquire);
+        return chunk + slots_offset +
+                (index & ((1u << SLOT_BITS) - 1)) * slot_size;
+    }
+
+    uint32_t fixed_pool::slot_index(const void *addr) const {
+        // chunks are aligned to their size, the header holds their number
+        const auto value = reinterpret_cast<uintptr_t>(addr);
+        const uintptr_t base = value & ~(uintptr_t{chunk_bytes} - 1);
+        const uint32_t chunk = *reinterpret_cast<const uint32_t *>(base);
+        const auto slot = static_cast<uint32_t>(
+                (value - base - slots_offset) / slot_size);
+        return chunk << SLOT_BITS | slot;
+    }
+
+    std::atomic<uint32_t> &fixed_pool::link(const uint32_t index) const {
+        uint8_t *chunk =
+                chunks[index >> SLOT_BITS].load(std::memory_order_acquire);
+        auto *links =
+                reinterpret_cast<std::atomic<uint32_t> *>(chunk + CHUNK_HEADER);
+        return links[index & ((1u << SLOT_BITS) - 1)];
+    }
+
+    bool fixed_pool::add_chunk(const size_t chunk) {
+        if (chunk >= max_chunks) {
+            return false;
+        }
+        if (chunks[chunk].load(std::memory_order_acquire)) {
+            return true;
+        }
+        std::lock_guard lock(mutex);
+        if (chunks[chunk].load(std::memory_order_relaxed)) {
+            return true;
+        }
+        auto *addr = static_cast<uint8_t *>(::operator new(
+                chunk_bytes, std::align_val_t(chunk_bytes), std::nothrow));
+        if (!addr) {
+            return false;
+        }
+        // fault the pages in here rather than on the hot path later
+        memset(addr, 0, chunk_bytes);
+        *reinterpret_cast<uint32_t *>(addr) = static_cast<uint32_t>(chunk);
+        for (uint32_t i = 0; i < per_chunk; ++i) {
+            new (addr + CHUNK_HEADER + i * sizeof(std::atomic<uint32_t>))
+                    std::atomic<uint32_t>(NIL);
+        }
+        chunks[chunk].store(addr, std::memory_order_release);
+        chunk_count.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void *fixed_pool::carve() {
+        const uint64_t n = carved.fetch_add(1, std::memory_order_relaxed);
+        const size_t chunk = n / per_chunk;
+        if (!add_chunk(chunk)) {
+            carved.fetch_sub(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return slot_addr(static_cast<uint32_t>(chunk << SLOT_BITS |
+                                               n % per_chunk));
+    }
+
+    void *fixed_pool::refill(thread_cache *cache) {
+        // take up to half a cache from the shared list, one CAS per slot
+        uint64_t head = free_head.load(std::memory_order_acquire);
+        while (cache->count < cache_limit / 2 && index_of(head) != NIL) {
+            // may read the link of a slot another thread just took, the
+            // tag then makes the CAS fail and the value is never used
+            const uint32_t next =
+                    link(index_of(head)).load(std::memory_order_relaxed);
+            if (free_head.compare_exchange_weak(head,
+                                                pack(next, tag_of(head) + 1),
+                                                std::memory_order_acquire,
+                                                std::memory_order_acquire)) {
+                void *slot = slot_addr(index_of(head));
+                next_ptr(slot) = cache->head;
+                if (!cache->head) {
+                    cache->tail = slot;
+                }
+                cache->head = slot;
+                ++cache->count;
+                head = free_head.load(std::memory_order_acquire);
+            }
+        }
+        if (cache->head) {
+            void *slot = cache->head;
+            cache->head = next_ptr(slot);
+            --cache->count;
+            return slot;
+        }
+        return carve();
+    }
+
+    void fixed_pool::push_chain(void *first, void *last) {
+        // relink by index, the shared list cannot use pointers
+        for (void *slot = first; slot != last;) {
+            void *next = next_ptr(slot);
+            link(slot_index(slot))
+                    .store(slot_index(next), std::memory_order_relaxed);
+            slot = next;
+        }
+        std::atomic<uint32_t> &last_link = link(slot_index(last));
+        const uint32_t first_index = slot_index(first);
+        uint64_t head = free_head.load(std::memory_order_relaxed);
+        do {
+            last_link.store(index_of(head), std::memory_order_relaxed);
+        } while (!free_head.compare_exchange_weak(
+                head, pack(first_index, tag_of(head) + 1),
+                std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void *fixed_pool::malloc() {
+        thread_cache *cache = local_cache();
+        void *slot = cache->head;
+        if (slot) {
+            cache->head = next_ptr(slot);
+            --cache->count;
+        } else {
+            slot = refill(cache);
+            if (!slot) {
+                return nullptr;
+            }
+        }
+        cache->in_use.store(cache->in_use.load(std::memory_order_relaxed) + 1,
+                            std::memory_order_relaxed);
+        return slot;
+    }
+
+    void fixed_pool::free(void *addr) {
+        if (!addr) {
+            return;
+        }
+        thread_cache *cache = local_cache();
+        next_ptr(addr) = cache->head;
+        if (!cache->head) {
+            cache->tail = addr;
+        }
+        cache->head = addr;
+        ++cache->count;
+        cache->in_use.store(cache->in_use.load(std::memory_order_relaxed) - 1,
+                            std::memory_order_relaxed);
+        if (cache->count <= cache_limit) {
+            return;
+        }
+        // keep the hot half, hand the rest back in one CAS
+        void *last = cache->head;
+        for (uint32_t i = 1; i < cache_limit / 2; ++i) {
+            last = next_ptr(last);
+        }
+        void *first = next_ptr(last);
+        next_ptr(last) = nullptr;
+        push_chain(first, cache->tail);
+        cache->tail = last;
+        cache->count = cache_limit / 2;
+    }
+
+    void fixed_pool::flush() {
+        thread_cache *cache = nullptr;
+        for (const auto &slot : t_caches.slots) {
+            if (slot.id == id) {
+                cache = slot.cache;
+                break;
+            }
+        }
+        if (!cache || !cache->head) {
+            return;
+        }
+        push_chain(cache->head, cache->tail);
+        cache->head = nullptr;
+        cache->tail = nullptr;
+        cache->count = 0;
+    }
+
+    bool fixed_pool::prewarm(const size_t count) {
+        const size_t needed = (count + per_chunk - 1) / per_chunk;
+        for (size_t chunk = 0; chunk < needed; ++chunk) {
+            if (!add_chunk(chunk)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    pool_stats fixed_pool::stats() {
+        pool_stats result;
+        result.object_size = slot_size;
+        result.chunks = chunk_count.load(std::memory_order_relaxed);
+        result.capacity = result.chunks * per_chunk;
+        result.high_water = static_cast<size_t>(
+                carved.load(std::memory_order_relaxed));
+        int64_t in_use = 0;
+        {
+            std::lock_guard lock(mutex);
+            for (const auto cache : caches) {
+                in_use += cache->in_use.load(std::memory_order_relaxed);
+            }
+        }
+        result.in_use = in_use > 0 ? static_cast<size_t>(in_use) : 0;
+        return result;
+    }
+} // namespace YanLib::mem
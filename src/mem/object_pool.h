@@ -0,0 +1,198 @@
+/* clang-format off */
+/*
+ * @file object_pool.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace YanLib::mem {
+    struct pool_stats {
+        size_t object_size = 0;
+        // slots in the chunks allocated so far
+        size_t capacity = 0;
+        // objects handed out and not freed yet
+        size_t in_use = 0;
+        // most slots ever out of the shared list at once, thread caches
+        // included; a good value for prewarm()
+        size_t high_water = 0;
+        size_t chunks = 0;
+    };
+
+    // Pool of equally sized slots. Threads allocate from and free into a
+    // small cache of their own; caches refill from and spill into a shared
+    // lock-free free list whose head packs a slot index with a version tag,
+    // so a slot that was popped and pushed again meanwhile fails the CAS.
+    // The shared list links slots through an index array at the front of
+    // each chunk, never through the slots, so a pop racing with a reuse
+    // does not read an object's bytes. Memory comes from chunks that are
+    // only given back on destruction.
+    class fixed_pool {
+    public:
+        static constexpr size_t max_chunks = 1024;
+        static constexpr uint32_t cache_limit = 64;
+
+        struct thread_cache;
+
+    private:
+        uint64_t id;
+        size_t slot_size;
+        size_t chunk_bytes;
+        // chunk header, then the link array, then the slots
+        size_t slots_offset;
+        uint32_t per_chunk;
+        std::atomic<uint64_t> free_head;
+        std::atomic<uint64_t> carved{0};
+        std::atomic<uint8_t *> chunks[max_chunks] = {};
+        std::atomic<size_t> chunk_count{0};
+        std::mutex mutex = {};
+        std::vector<thread_cache *> caches = {};
+
+        thread_cache *local_cache();
+
+        uint8_t *slot_addr(uint32_t index) const;
+
+        uint32_t slot_index(const void *addr) const;
+
+        std::atomic<uint32_t> &link(uint32_t index) const;
+
+        bool add_chunk(size_t chunk);
+
+        void *carve();
+
+        void *refill(thread_cache *cache);
+
+        void push_chain(void *first, void *last);
+
+    public:
+        fixed_pool(const fixed_pool &other) = delete;
+
+        fixed_pool(fixed_pool &&other) = delete;
+
+        fixed_pool &operator=(const fixed_pool &other) = delete;
+
+        fixed_pool &operator=(fixed_pool &&other) = delete;
+
+        fixed_pool(size_t object_size, size_t align);
+
+        ~fixed_pool();
+
+        void *malloc();
+
+        // addr must come from this pool, any thread may free it
+        void free(void *addr);
+
+        // makes room for count slots up front, so the first count
+        // allocations do not reach the system allocator
+        bool prewarm(size_t count);
+
+        // moves the calling thread's cache back to the shared list
+        void flush();
+
+        [[nodiscard]] pool_stats stats();
+    };
+
+    template <typename T> class object_pool {
+        static_assert(alignof(T) <= 64, "slots are at most 64-byte aligned");
+
+    private:
+        fixed_pool pool;
+
+    public:
+        object_pool(const object_pool &other) = delete;
+
+        object_pool(object_pool &&other) = delete;
+
+        object_pool &operator=(const object_pool &other) = delete;
+
+        object_pool &operator=(object_pool &&other) = delete;
+
+        explicit object_pool(size_t prewarm_count = 0);
+
+        // objects still alive when the pool goes away are not destroyed
+        ~object_pool() = default;
+
+        template <typename... Args> T *create(Args &&...args);
+
+        void destroy(T *obj);
+
+        bool prewarm(size_t count);
+
+        void flush();
+
+        [[nodiscard]] pool_stats stats();
+    };
+
+    template <typename T>
+    object_pool<T>::object_pool(const size_t prewarm_count)
+        : pool(sizeof(T), alignof(T)) {
+        if (prewarm_count) {
+            pool.prewarm(prewarm_count);
+        }
+    }
+
+    template <typename T>
+    template <typename... Args>
+    T *object_pool<T>::create(Args &&...args) {
+        void *addr = pool.malloc();
+        if (!addr) {
+            return nullptr;
+        }
+        try {
+            return new (addr) T(std::forward<Args>(args)...);
+        } catch (...) {
+            pool.free(addr);
+            throw;
+        }
+    }
+
+    template <typename T> void object_pool<T>::destroy(T *obj) {
+        if (!obj) {
+            return;
+        }
+        obj->~T();
+        pool.free(obj);
+    }
+
+    template <typename T> bool object_pool<T>::prewarm(const size_t count) {
+        return pool.prewarm(count);
+    }
+
+    template <typename T> void object_pool<T>::flush() {
+        pool.flush();
+    }
+
+    template <typename T> pool_stats object_pool<T>::stats() {
+        return pool.stats();
+    }
+} // namespace YanLib::mem
+#endif // OBJECT_POOL_H
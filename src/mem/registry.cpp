@@ -0,0 +1,106 @@
+/* clang-format off */
+/*
+ * @file registry.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "registry.h"
+
+namespace YanLib::mem {
+    size_t registry::shard_of(const void *addr) {
+        // blocks are at least 16-byte aligned and pages 4 KiB aligned, fold
+        // the high bits in so both spread over the shards
+        const auto value = reinterpret_cast<uintptr_t>(addr);
+        return ((value >> 4) ^ (value >> 12) ^ (value >> 16)) %
+                shard_count;
+    }
+
+    bool registry::insert(const void *addr, const uintptr_t value) {
+        shard &s = shards[shard_of(addr)];
+        s.rwlock.write_lock();
+        const bool inserted = s.map.emplace(addr, value).second;
+        s.rwlock.write_unlock();
+        return inserted;
+    }
+
+    bool registry::erase(const void *addr, uintptr_t *value) {
+        shard &s = shards[shard_of(addr)];
+        s.rwlock.write_lock();
+        const auto it = s.map.find(addr);
+        const bool found = it != s.map.end();
+        if (found) {
+            if (value) {
+                *value = it->second;
+            }
+            s.map.erase(it);
+        }
+        s.rwlock.write_unlock();
+        return found;
+    }
+
+    bool registry::update(const void *addr, const uintptr_t value) {
+        shard &s = shards[shard_of(addr)];
+        s.rwlock.write_lock();
+        const auto it = s.map.find(addr);
+        const bool found = it != s.map.end();
+        if (found) {
+            it->second = value;
+        }
+        s.rwlock.write_unlock();
+        return found;
+    }
+
+    bool registry::find(const void *addr, uintptr_t *value) {
+        shard &s = shards[shard_of(addr)];
+        s.rwlock.read_lock();
+        const auto it = s.map.find(addr);
+        const bool found = it != s.map.end();
+        if (found && value) {
+            *value = it->second;
+        }
+        s.rwlock.read_unlock();
+        return found;
+    }
+
+    size_t registry::size() {
+        size_t count = 0;
+        for (auto &s : shards) {
+            s.rwlock.read_lock();
+            count += s.map.size();
+            s.rwlock.read_unlock();
+        }
+        return count;
+    }
+
+    std::vector<std::pair<const void *, uintptr_t>> registry::drain() {
+        std::vector<std::pair<const void *, uintptr_t>> result;
+        for (auto &s : shards) {
+            s.rwlock.write_lock();
+            result.insert(result.end(), s.map.begin(), s.map.end());
+            s.map.clear();
+            s.rwlock.write_unlock();
+        }
+        return result;
+    }
+} // namespace YanLib::mem
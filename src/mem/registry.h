@@ -0,0 +1,85 @@
+/* clang-format off */
+/*
+ * @file registry.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef REGISTRY_H
+#define REGISTRY_H
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "sync/futex_rwlock.h"
+
+namespace YanLib::mem {
+    // Address -> value map behind allocate, heap and mmap. The addresses are
+    // spread over shards with a lock each, so insert and erase stay O(1) and
+    // threads freeing unrelated blocks rarely meet on the same lock.
+    class registry {
+    public:
+        static constexpr size_t shard_count = 16;
+
+    private:
+        struct alignas(64) shard {
+            std::unordered_map<const void *, uintptr_t> map = {};
+            sync::futex_rwlock rwlock = {};
+        };
+
+        shard shards[shard_count];
+
+        static size_t shard_of(const void *addr);
+
+    public:
+        registry(const registry &other) = delete;
+
+        registry(registry &&other) = delete;
+
+        registry &operator=(const registry &other) = delete;
+
+        registry &operator=(registry &&other) = delete;
+
+        registry() = default;
+
+        ~registry() = default;
+
+        // false if addr is already present, the stored value is kept then
+        bool insert(const void *addr, uintptr_t value = 0);
+
+        // false if addr is not present
+        bool erase(const void *addr, uintptr_t *value = nullptr);
+
+        // false if addr is not present
+        bool update(const void *addr, uintptr_t value);
+
+        bool find(const void *addr, uintptr_t *value = nullptr);
+
+        size_t size();
+
+        // removes every entry and hands them back, for destructors
+        std::vector<std::pair<const void *, uintptr_t>> drain();
+    };
+} // namespace YanLib::mem
+#endif // REGISTRY_H
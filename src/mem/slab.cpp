@@ -0,0 +1,599 @@
+/* clang-format off */
+/*
+ * @file slab.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "slab.h"
+#include <new>
+#include <thread>
+#include <unordered_set>
+#ifdef _WIN32
+#include <Windows.h>
+#include "helper/convert.h"
+#else
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#endif
+
+namespace YanLib::mem {
+    struct slab::span {
+        slab *owner = nullptr;
+        thread_cache *cache = nullptr;
+        // partial list of the owning cache, or the pool / large list
+        span *prev = nullptr;
+        span *next = nullptr;
+        void *free_list = nullptr;
+        uint8_t *bump = nullptr;
+        uint8_t *end = nullptr;
+        uint32_t block_size = 0;
+        uint32_t size_class = 0;
+        uint32_t used = 0;
+        bool in_partial = false;
+        // mapping size of a large allocation, 0 for spans of a size class
+        size_t large_size = 0;
+    };
+
+    struct slab::thread_cache {
+        std::thread::id thread = {};
+        span *active[class_count] = {};
+        span *partial[class_count] = {};
+        // blocks other threads freed, pushed with CAS and taken as a whole
+        std::atomic<void *> remote_free{nullptr};
+
+        // for the thread-exit hook, which is not a member
+        static void leave(slab *owner, thread_cache *cache) {
+            owner->retire(cache);
+        }
+    };
+
+    namespace {
+        constexpr size_t HEADER_SIZE =
+                (sizeof(slab::span) + 63) & ~static_cast<size_t>(63);
+        static_assert(HEADER_SIZE % slab::alignment == 0);
+
+        constexpr size_t TLS_SLOTS = 4;
+
+        struct tls_slot {
+            uint64_t id;
+            slab *owner;
+            slab::thread_cache *cache;
+        };
+
+        std::atomic<uint64_t> g_next_id{1};
+
+        // slabs still alive, so exiting threads only touch those
+        std::mutex &live_mutex() {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        std::unordered_set<uint64_t> &live_slabs() {
+            static std::unordered_set<uint64_t> slabs;
+            return slabs;
+        }
+
+        struct tls_caches {
+            // lookup cache, a slab may be evicted by a newer one
+            tls_slot slots[TLS_SLOTS] = {};
+            size_t next = 0;
+            // every cache this thread took, evicted or not
+            std::vector<tls_slot> owned = {};
+
+            ~tls_caches() {
+                std::lock_guard lock(live_mutex());
+                for (const auto &slot : owned) {
+                    if (live_slabs().count(slot.id)) {
+                        slab::thread_cache::leave(slot.owner, slot.cache);
+                    }
+                }
+            }
+        };
+
+        thread_local tls_caches t_caches;
+
+        // 16..128 in steps of 16, then four classes per power of two
+        constexpr size_t class_size(const size_t size_class) {
+            if (size_class < 8) {
+                return (size_class + 1) * 16;
+            }
+            const size_t k = size_class - 8;
+            const size_t lg = 7 + k / 4;
+            return (size_t{1} << lg) + (k % 4 + 1) * (size_t{1} << (lg - 2));
+        }
+
+        static_assert(class_size(slab::class_count - 1) ==
+                      slab::max_small_size);
+
+        uint32_t floor_log2(const size_t value) {
+#ifdef _MSC_VER
+            unsigned long index = 0;
+            _BitScanReverse64(&index, value);
+            return index;
+#else
+            return 63 - __builtin_clzll(value);
+#endif
+        }
+
+        size_t class_of(const size_t size) {
+            if (size <= 128) {
+                return size ? (size - 1) / 16 : 0;
+            }
+            const size_t value = size - 1;
+            const uint32_t lg = floor_log2(value);
+            return 8 + (lg - 7) * 4 + ((value >> (lg - 2)) & 3);
+        }
+
+        slab::span *span_of(const void *addr) {
+            return reinterpret_cast<slab::span *>(
+                    reinterpret_cast<uintptr_t>(addr) &
+                    ~static_cast<uintptr_t>(slab::span_size - 1));
+        }
+
+        uint32_t last_error() {
+#ifdef _WIN32
+            return GetLastError();
+#else
+            return static_cast<uint32_t>(errno);
+#endif
+        }
+
+        // committed read/write memory aligned to span_size
+        void *os_map(const size_t size) {
+#ifdef _WIN32
+            // the allocation granularity is 64 KiB already
+            return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT,
+                                PAGE_READWRITE);
+#else
+            const size_t length = size + slab::span_size;
+            void *addr = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (addr == MAP_FAILED) {
+                return nullptr;
+            }
+            // over-map by one span and trim both ends to the alignment
+            const auto base = reinterpret_cast<uintptr_t>(addr);
+            const uintptr_t aligned = (base + slab::span_size - 1) &
+                    ~static_cast<uintptr_t>(slab::span_size - 1);
+            if (aligned > base) {
+                munmap(addr, aligned - base);
+            }
+            if (const uintptr_t tail = base + length - (aligned + size)) {
+                munmap(reinterpret_cast<void *>(aligned + size), tail);
+            }
+            return reinterpret_cast<void *>(aligned);
+#endif
+        }
+
+        bool os_unmap(void *addr, const size_t size) {
+#ifdef _WIN32
+            (void)size;
+            return VirtualFree(addr, 0, MEM_RELEASE);
+#else
+            return munmap(addr, size) == 0;
+#endif
+        }
+
+        void partial_push(slab::thread_cache *cache, slab::span *s) {
+            slab::span *&head = cache->partial[s->size_class];
+            s->prev = nullptr;
+            s->next = head;
+            if (head) {
+                head->prev = s;
+            }
+            head = s;
+            s->in_partial = true;
+        }
+
+        void partial_remove(slab::thread_cache *cache, slab::span *s) {
+            if (s->prev) {
+                s->prev->next = s->next;
+            } else {
+                cache->partial[s->size_class] = s->next;
+            }
+            if (s->next) {
+                s->next->prev = s->prev;
+            }
+            s->prev = nullptr;
+            s->next = nullptr;
+            s->in_partial = false;
+        }
+    } // namespace
+
+    slab::slab() : id(g_next_id.fetch_add(1, std::memory_order_relaxed)) {
+        std::lock_guard lock(live_mutex());
+        live_slabs().insert(id);
+    }
+
+    slab::~slab() {
+        release();
+        std::lock_guard lock(live_mutex());
+        live_slabs().erase(id);
+    }
+
+    slab::thread_cache *slab::local_cache() {
+        for (const auto &slot : t_caches.slots) {
+            if (slot.id == id) {
+                return slot.cache;
+            }
+        }
+        // the slot may have been taken over by another slab, so look for a
+        // cache this thread already owns before making a new one
+        const std::thread::id self = std::this_thread::get_id();
+        thread_cache *cache = nullptr;
+        {
+            std::lock_guard lock(mutex);
+            for (const auto c : caches) {
+                if (c->thread == self) {
+                    cache = c;
+                    break;
+                }
+            }
+            if (!cache) {
+                // a cache left by an exited thread comes with its spans
+                if (!orphans.empty()) {
+                    cache = orphans.back();
+                    orphans.pop_back();
+                } else {
+                    cache = new thread_cache;
+                    caches.push_back(cache);
+                }
+                cache->thread = self;
+                t_caches.owned.push_back({id, this, cache});
+            }
+        }
+        tls_slot &slot = t_caches.slots[t_caches.next];
+        t_caches.next = (t_caches.next + 1) % TLS_SLOTS;
+        slot = {id, this, cache};
+        return cache;
+    }
+
+    void slab::retire(thread_cache *cache) {
+        drain_remote(cache);
+        // active spans go back on the partial list or to the pool, so the
+        // next owner and reclaim_orphans() see every span with free room
+        for (size_t size_class = 0; size_class < class_count; ++size_class) {
+            span *s = cache->active[size_class];
+            if (!s) {
+                continue;
+            }
+            cache->active[size_class] = nullptr;
+            if (s->used == 0) {
+                recycle_span(s);
+            } else if (!s->in_partial) {
+                partial_push(cache, s);
+            }
+        }
+        std::lock_guard lock(mutex);
+        cache->thread = {};
+        orphans.push_back(cache);
+    }
+
+    void slab::reclaim_orphans() {
+        std::vector<thread_cache *> taken;
+        {
+            std::lock_guard lock(mutex);
+            if (orphans.empty()) {
+                return;
+            }
+            taken.swap(orphans);
+        }
+        // taken out, so no other thread adopts or drains them meanwhile;
+        // blocks freed back to them return their spans to the pool
+        for (const auto cache : taken) {
+            drain_remote(cache);
+        }
+        std::lock_guard lock(mutex);
+        orphans.insert(orphans.end(), taken.begin(), taken.end());
+    }
+
+    slab::span *slab::new_span(thread_cache *cache, const size_t size_class) {
+        reclaim_orphans();
+        span *s = nullptr;
+        {
+            std::lock_guard lock(mutex);
+            if (span_pool) {
+                s = span_pool;
+                span_pool = s->next;
+            } else {
+                if (region_cursor == region_end) {
+                    void *region = os_map(region_size);
+                    if (!region) {
+                        error_code = last_error();
+                        return nullptr;
+                    }
+                    regions.push_back(region);
+                    region_cursor = static_cast<uint8_t *>(region);
+                    region_end = region_cursor + region_size;
+                }
+                s = reinterpret_cast<span *>(region_cursor);
+                region_cursor += span_size;
+            }
+        }
+        new (s) span;
+        s->owner = this;
+        s->cache = cache;
+        s->block_size = static_cast<uint32_t>(class_size(size_class));
+        s->size_class = static_cast<uint32_t>(size_class);
+        s->bump = reinterpret_cast<uint8_t *>(s) + HEADER_SIZE;
+        s->end = reinterpret_cast<uint8_t *>(s) + span_size;
+        return s;
+    }
+
+    void slab::recycle_span(span *s) {
+        s->~span();
+        std::lock_guard lock(mutex);
+        s->next = span_pool;
+        span_pool = s;
+    }
+
+    void *slab::malloc_small(thread_cache *cache, const size_t size_class) {
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            span *s = cache->active[size_class];
+            if (s) {
+                if (void *block = s->free_list) {
+                    s->free_list = *static_cast<void **>(block);
+                    ++s->used;
+                    return block;
+                }
+                if (s->end - s->bump >= s->block_size) {
+                    void *block = s->bump;
+                    s->bump += s->block_size;
+                    ++s->used;
+                    return block;
+                }
+            }
+            if (attempt == 0) {
+                drain_remote(cache);
+            }
+        }
+        // the active span is full and stays unlisted until a block returns
+        span *s = cache->partial[size_class];
+        if (s) {
+            partial_remove(cache, s);
+        } else {
+            s = new_span(cache, size_class);
+            if (!s) {
+                return nullptr;
+            }
+        }
+        cache->active[size_class] = s;
+        if (void *block = s->free_list) {
+            s->free_list = *static_cast<void **>(block);
+            ++s->used;
+            return block;
+        }
+        void *block = s->bump;
+        s->bump += s->block_size;
+        ++s->used;
+        return block;
+    }
+
+    void *slab::malloc_large(const size_t size) {
+        if (size > SIZE_MAX - HEADER_SIZE - span_size) {
+            return nullptr;
+        }
+        // whole pages, the header keeps the block inside the first span
+        const size_t length = (HEADER_SIZE + size + 4095) & ~size_t{4095};
+        void *addr = os_map(length);
+        if (!addr) {
+            error_code = last_error();
+            return nullptr;
+        }
+        auto *s = new (addr) span;
+        s->owner = this;
+        s->large_size = length;
+        {
+            std::lock_guard lock(mutex);
+            s->next = large_list;
+            if (large_list) {
+                large_list->prev = s;
+            }
+            large_list = s;
+        }
+        large_bytes.fetch_add(length, std::memory_order_relaxed);
+        return static_cast<uint8_t *>(addr) + HEADER_SIZE;
+    }
+
+    void *slab::malloc(const size_t size) {
+        if (size > max_small_size) {
+            return malloc_large(size);
+        }
+        return malloc_small(local_cache(), class_of(size));
+    }
+
+    void slab::free_local(thread_cache *cache, span *s, void *addr) {
+        *static_cast<void **>(addr) = s->free_list;
+        s->free_list = addr;
+        --s->used;
+        if (s == cache->active[s->size_class]) {
+            return;
+        }
+        if (s->used == 0) {
+            if (s->in_partial) {
+                partial_remove(cache, s);
+            }
+            recycle_span(s);
+        } else if (!s->in_partial) {
+            partial_push(cache, s);
+        }
+    }
+
+    void slab::free_remote(span *s, void *addr) {
+        // the span cannot be recycled before the owner has seen this block,
+        // so its cache stays valid here
+        thread_cache *cache = s->cache;
+        void *head = cache->remote_free.load(std::memory_order_relaxed);
+        do {
+            *static_cast<void **>(addr) = head;
+        } while (!cache->remote_free.compare_exchange_weak(
+                head, addr, std::memory_order_release,
+                std::memory_order_relaxed));
+    }
+
+    void slab::drain_remote(thread_cache *cache) {
+        void *block = cache->remote_free.exchange(nullptr,
+                                                  std::memory_order_acquire);
+        while (block) {
+            void *next = *static_cast<void **>(block);
+            free_local(cache, span_of(block), block);
+            block = next;
+        }
+    }
+
+    bool slab::free(void *addr) {
+        if (!addr) {
+            return false;
+        }
+        span *s = span_of(addr);
+        if (s->owner != this) {
+            return false;
+        }
+        if (s->large_size) {
+            const size_t length = s->large_size;
+            {
+                std::lock_guard lock(mutex);
+                if (s->prev) {
+                    s->prev->next = s->next;
+                } else {
+                    large_list = s->next;
+                }
+                if (s->next) {
+                    s->next->prev = s->prev;
+                }
+            }
+            large_bytes.fetch_sub(length, std::memory_order_relaxed);
+            s->~span();
+            if (!os_unmap(s, length)) {
+                error_code = last_error();
+                return false;
+            }
+            return true;
+        }
+        thread_cache *cache = nullptr;
+        for (const auto &slot : t_caches.slots) {
+            if (slot.id == id) {
+                cache = slot.cache;
+                break;
+            }
+        }
+        if (cache == s->cache) {
+            free_local(cache, s, addr);
+        } else {
+            free_remote(s, addr);
+        }
+        return true;
+    }
+
+    bool slab::owns(const void *addr) {
+        const auto value = reinterpret_cast<uintptr_t>(addr);
+        std::lock_guard lock(mutex);
+        for (const auto region : regions) {
+            const auto base = reinterpret_cast<uintptr_t>(region);
+            if (value >= base && value - base < region_size) {
+                return true;
+            }
+        }
+        for (const span *s = large_list; s; s = s->next) {
+            const auto base = reinterpret_cast<uintptr_t>(s);
+            if (value >= base + HEADER_SIZE && value - base < s->large_size) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t slab::size(const void *addr) {
+        if (!addr) {
+            return 0;
+        }
+        const span *s = span_of(addr);
+        if (s->large_size) {
+            return s->large_size - HEADER_SIZE;
+        }
+        return s->block_size;
+    }
+
+    void slab::release() {
+        // held throughout, so no exiting thread hands back a cache meanwhile
+        std::lock_guard live_lock(live_mutex());
+        live_slabs().erase(id);
+        std::lock_guard lock(mutex);
+        for (span *s = large_list; s;) {
+            span *next = s->next;
+            const size_t length = s->large_size;
+            s->~span();
+            os_unmap(s, length);
+            s = next;
+        }
+        large_list = nullptr;
+        large_bytes.store(0, std::memory_order_relaxed);
+        for (const auto region : regions) {
+            os_unmap(region, region_size);
+        }
+        regions.clear();
+        region_cursor = nullptr;
+        region_end = nullptr;
+        span_pool = nullptr;
+        for (const auto cache : caches) {
+            delete cache;
+        }
+        caches.clear();
+        orphans.clear();
+        // thread-local slots still name the old id and the deleted caches
+        id = g_next_id.fetch_add(1, std::memory_order_relaxed);
+        live_slabs().insert(id);
+    }
+
+    size_t slab::reserved_bytes() {
+        std::lock_guard lock(mutex);
+        return regions.size() * region_size +
+                large_bytes.load(std::memory_order_relaxed);
+    }
+
+    uint32_t slab::err_code() const {
+        return error_code;
+    }
+
+    std::string slab::err_string() const {
+#ifdef _WIN32
+        std::string result = helper::convert::err_string(error_code);
+#else
+        std::string result = std::strerror(static_cast<int>(error_code));
+#endif
+        return result;
+    }
+
+    std::wstring slab::err_wstring() const {
+#ifdef _WIN32
+        std::wstring result = helper::convert::err_wstring(error_code);
+#else
+        // strerror text is ASCII in the C locale
+        const std::string text = err_string();
+        std::wstring result(text.begin(), text.end());
+#endif
+        return result;
+    }
+} // namespace YanLib::mem
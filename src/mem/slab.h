@@ -0,0 +1,138 @@
+/* clang-format off */
+/*
+ * @file slab.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef SLAB_H
+#define SLAB_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace YanLib::mem {
+    // Size-class allocator. Small requests are carved from 64 KiB spans
+    // that each serve one size class; every thread allocates from its own
+    // spans without locking and a span header at the 64 KiB boundary makes
+    // free O(1). Spans come from 4 MiB regions reserved from the OS
+    // (VirtualAlloc, mmap on other platforms), requests above
+    // max_small_size get a region of their own. Blocks freed by a thread
+    // other than the owner are handed back through a lock-free list. A
+    // thread that exits leaves its cache to the slab: the next new thread
+    // adopts it, and blocks freed into it meanwhile return their spans to
+    // the pool before another region is reserved.
+    class slab {
+    public:
+        static constexpr size_t span_size = 64 * 1024;
+        static constexpr size_t region_size = 64 * span_size;
+        static constexpr size_t max_small_size = 16 * 1024;
+        static constexpr size_t alignment = 16;
+        static constexpr size_t class_count = 36;
+
+        struct span;
+        struct thread_cache;
+
+    private:
+        uint64_t id;
+        std::mutex mutex = {};
+        std::vector<void *> regions = {};
+        std::vector<thread_cache *> caches = {};
+        // caches of exited threads, adopted by the next new thread
+        std::vector<thread_cache *> orphans = {};
+        uint8_t *region_cursor = nullptr;
+        uint8_t *region_end = nullptr;
+        span *span_pool = nullptr;
+        span *large_list = nullptr;
+        std::atomic<size_t> large_bytes{0};
+        uint32_t error_code = 0;
+
+        thread_cache *local_cache();
+
+        // hands the cache of an exiting thread back to the slab
+        void retire(thread_cache *cache);
+
+        // frees what other threads returned to orphaned caches
+        void reclaim_orphans();
+
+        span *new_span(thread_cache *cache, size_t size_class);
+
+        void recycle_span(span *s);
+
+        void *malloc_small(thread_cache *cache, size_t size_class);
+
+        void *malloc_large(size_t size);
+
+        void drain_remote(thread_cache *cache);
+
+        void free_local(thread_cache *cache, span *s, void *addr);
+
+        static void free_remote(span *s, void *addr);
+
+    public:
+        slab(const slab &other) = delete;
+
+        slab(slab &&other) = delete;
+
+        slab &operator=(const slab &other) = delete;
+
+        slab &operator=(slab &&other) = delete;
+
+        slab();
+
+        ~slab();
+
+        void *malloc(size_t size);
+
+        // addr must come from a slab, this one or another: the span header
+        // is read before anything else, so any other pointer is undefined
+        // behaviour (check those with owns() first). Returns false for
+        // nullptr, for blocks of another slab and when the OS refuses to
+        // unmap a large block.
+        bool free(void *addr);
+
+        // whether addr lies in memory this slab handed out; takes the
+        // lock and walks the regions, so it is meant for checks, not for
+        // every free
+        [[nodiscard]] bool owns(const void *addr);
+
+        // usable size of a block, at least the size it was requested with
+        [[nodiscard]] static size_t size(const void *addr);
+
+        // Returns every region to the OS at once. All blocks become invalid
+        // and no other thread may use the slab while this runs.
+        void release();
+
+        [[nodiscard]] size_t reserved_bytes();
+
+        [[nodiscard]] uint32_t err_code() const;
+
+        [[nodiscard]] std::string err_string() const;
+
+        [[nodiscard]] std::wstring err_wstring() const;
+    };
+} // namespace YanLib::mem
+#endif // SLAB_H
@@ -0,0 +1,60 @@
+/* clang-format off */
+/*
+ * @file event_count.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "event_count.h"
+
+namespace YanLib::sync {
+    namespace {
+        constexpr uint32_t WAITING = 1;
+    } // namespace
+
+    uint32_t event_count::prepare_wait() {
+        const uint32_t key =
+                epoch.fetch_or(WAITING, std::memory_order_seq_cst) | WAITING;
+        // pairs with the fence in notify: either the notifier sees the
+        // flag or the recheck that follows sees the notifier's change
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return key;
+    }
+
+    void event_count::cancel_wait() {
+        // the flag stays up, the next notify pays one needless wakeup
+    }
+
+    void event_count::wait(const uint32_t key) {
+        futex::wait(epoch, key);
+    }
+
+    void event_count::notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (epoch.load(std::memory_order_relaxed) & WAITING) {
+            // clears the flag and moves the epoch on in one step
+            epoch.fetch_add(WAITING, std::memory_order_acq_rel);
+            futex::wake_all(epoch);
+        }
+    }
+} // namespace YanLib::sync
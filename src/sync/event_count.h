@@ -0,0 +1,79 @@
+/* clang-format off */
+/*
+ * @file event_count.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef EVENT_COUNT_H
+#define EVENT_COUNT_H
+#include <atomic>
+#include <cstdint>
+#include "futex.h"
+
+namespace YanLib::sync {
+    // Lets a lock-free structure block its callers without a lock on the
+    // fast path. A waiter announces itself, rechecks its condition and
+    // only then sleeps; notify() costs a fence and a load unless somebody
+    // announced itself since the last notify, and then wakes every
+    // waiter, so a burst of notifies makes one syscall instead of one
+    // each:
+    //
+    //     while (!try_pop(out)) {
+    //         const uint32_t key = not_empty.prepare_wait();
+    //         if (try_pop(out)) {
+    //             not_empty.cancel_wait();
+    //             break;
+    //         }
+    //         not_empty.wait(key);
+    //     }
+    class event_count {
+    private:
+        // bumped by 2 per wakeup, the low bit says somebody may sleep
+        std::atomic<uint32_t> epoch{0};
+
+    public:
+        event_count(const event_count &other) = delete;
+
+        event_count(event_count &&other) = delete;
+
+        event_count &operator=(const event_count &other) = delete;
+
+        event_count &operator=(event_count &&other) = delete;
+
+        event_count() = default;
+
+        ~event_count() = default;
+
+        [[nodiscard]] uint32_t prepare_wait();
+
+        void cancel_wait();
+
+        // sleeps unless a notify came after prepare_wait(); may return
+        // spuriously
+        void wait(uint32_t key);
+
+        void notify();
+    };
+} // namespace YanLib::sync
+#endif // EVENT_COUNT_H
@@ -0,0 +1,116 @@
+/* clang-format off */
+/*
+ * @file futex.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "futex.h"
+#include <algorithm>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#ifdef _WIN32
+#include <Windows.h>
+#include <synchapi.h>
+#pragma comment(lib, "Synchronization.lib")
+#else
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace YanLib::sync {
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) &&
+                          std::atomic<uint32_t>::is_always_lock_free,
+                  "the kernel waits on the atomic's own storage");
+
+    void futex::wait(std::atomic<uint32_t> &word, uint32_t expected) {
+#ifdef _WIN32
+        WaitOnAddress(&word, &expected, sizeof(expected), INFINITE);
+#else
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word),
+                FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#endif
+    }
+
+    bool futex::wake_one(std::atomic<uint32_t> &word) {
+#ifdef _WIN32
+        WakeByAddressSingle(&word);
+        return false;
+#else
+        return syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word),
+                       FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0) > 0;
+#endif
+    }
+
+    void futex::wake_all(std::atomic<uint32_t> &word) {
+#ifdef _WIN32
+        WakeByAddressAll(&word);
+#else
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word),
+                FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+    }
+
+    void futex::pause() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+        __yield();
+#elif defined(__aarch64__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    adaptive_spin::adaptive_spin(const uint32_t limit) : limit(limit) {
+    }
+
+    uint32_t adaptive_spin::budget() const {
+        const uint32_t cap = limit.load(std::memory_order_relaxed);
+        const uint32_t guess = estimate.load(std::memory_order_relaxed);
+        return std::min(cap, guess * 2 + 10);
+    }
+
+    void adaptive_spin::record(const uint32_t spins) {
+        // racy read-modify-write on purpose, it is only a hint
+        const uint32_t guess = estimate.load(std::memory_order_relaxed);
+        const auto next = static_cast<int64_t>(guess) +
+                (static_cast<int64_t>(spins) - static_cast<int64_t>(guess)) /
+                        8;
+        estimate.store(static_cast<uint32_t>(next), std::memory_order_relaxed);
+    }
+
+    void adaptive_spin::set_limit(const uint32_t spins) {
+        limit.store(spins, std::memory_order_relaxed);
+    }
+
+    uint32_t adaptive_spin::get_limit() const {
+        return limit.load(std::memory_order_relaxed);
+    }
+} // namespace YanLib::sync
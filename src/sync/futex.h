@@ -0,0 +1,95 @@
+/* clang-format off */
+/*
+ * @file futex.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef FUTEX_H
+#define FUTEX_H
+#include <atomic>
+#include <cstdint>
+
+namespace YanLib::sync {
+    // Waiting on a 32-bit word: WaitOnAddress on Windows, futex(2) on
+    // Linux. wait() returns when the word no longer holds expected, after
+    // a wake, or spuriously; callers recheck in a loop.
+    class futex {
+    public:
+        futex(const futex &other) = delete;
+
+        futex(futex &&other) = delete;
+
+        futex &operator=(const futex &other) = delete;
+
+        futex &operator=(futex &&other) = delete;
+
+        futex() = delete;
+
+        ~futex() = delete;
+
+        static void wait(std::atomic<uint32_t> &word, uint32_t expected);
+
+        // true if a waiter may have been woken; Windows cannot tell and
+        // always says false
+        static bool wake_one(std::atomic<uint32_t> &word);
+
+        static void wake_all(std::atomic<uint32_t> &word);
+
+        // a spin-wait hint to the core
+        static void pause();
+    };
+
+    // Spin budget that follows how long the lock usually takes to free
+    // up, like glibc's adaptive mutexes: a moving average of the spins the
+    // last acquisitions needed, doubled, capped at limit. A limit of 0
+    // parks straight away.
+    class adaptive_spin {
+    private:
+        std::atomic<uint32_t> estimate{0};
+        std::atomic<uint32_t> limit;
+
+    public:
+        adaptive_spin(const adaptive_spin &other) = delete;
+
+        adaptive_spin(adaptive_spin &&other) = delete;
+
+        adaptive_spin &operator=(const adaptive_spin &other) = delete;
+
+        adaptive_spin &operator=(adaptive_spin &&other) = delete;
+
+        explicit adaptive_spin(uint32_t limit = 100);
+
+        ~adaptive_spin() = default;
+
+        [[nodiscard]] uint32_t budget() const;
+
+        // spins taken by the last acquisition, budget() if it gave up
+        void record(uint32_t spins);
+
+        void set_limit(uint32_t spins);
+
+        [[nodiscard]] uint32_t get_limit() const;
+    };
+} // namespace YanLib::sync
+#endif // FUTEX_H
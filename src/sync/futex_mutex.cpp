@@ -0,0 +1,93 @@
+/* clang-format off */
+/*
+ * @file futex_mutex.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "futex_mutex.h"
+
+namespace YanLib::sync {
+    namespace {
+        constexpr uint32_t UNLOCKED = 0;
+        constexpr uint32_t LOCKED = 1;
+        constexpr uint32_t CONTENDED = 2;
+    } // namespace
+
+    futex_mutex::futex_mutex(const uint32_t spin_limit) : spin(spin_limit) {
+    }
+
+    void futex_mutex::lock() {
+        uint32_t expected = UNLOCKED;
+        if (!state.compare_exchange_strong(expected, LOCKED,
+                                           std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+            lock_contended();
+        }
+    }
+
+    void futex_mutex::lock_contended() {
+        const uint32_t budget = spin.budget();
+        uint32_t spins = 0;
+        // spin on plain loads, the cache line stays shared until it frees
+        for (; spins < budget; ++spins) {
+            uint32_t current = state.load(std::memory_order_relaxed);
+            if (current == UNLOCKED &&
+                state.compare_exchange_weak(current, LOCKED,
+                                            std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+                spin.record(spins);
+                return;
+            }
+            if (current == CONTENDED) {
+                // others already sleep, it is not freeing up soon
+                break;
+            }
+            futex::pause();
+        }
+        spin.record(budget);
+        // Taken as CONTENDED from here on: this thread cannot tell
+        // whether others still sleep, so the next unlock wakes one.
+        while (state.exchange(CONTENDED, std::memory_order_acquire) !=
+               UNLOCKED) {
+            futex::wait(state, CONTENDED);
+        }
+    }
+
+    bool futex_mutex::try_lock() {
+        uint32_t expected = UNLOCKED;
+        return state.compare_exchange_strong(expected, LOCKED,
+                                             std::memory_order_acquire,
+                                             std::memory_order_relaxed);
+    }
+
+    void futex_mutex::unlock() {
+        if (state.exchange(UNLOCKED, std::memory_order_release) == CONTENDED) {
+            futex::wake_one(state);
+        }
+    }
+
+    void futex_mutex::set_spin_limit(const uint32_t spins) {
+        spin.set_limit(spins);
+    }
+} // namespace YanLib::sync
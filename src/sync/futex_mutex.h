@@ -0,0 +1,72 @@
+/* clang-format off */
+/*
+ * @file futex_mutex.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef FUTEX_MUTEX_H
+#define FUTEX_MUTEX_H
+#include <atomic>
+#include <cstdint>
+#include "futex.h"
+
+namespace YanLib::sync {
+    // A one-word mutex: a compare-exchange when free, an adaptive spin
+    // when held, and a futex wait only after that. Unlocking makes a
+    // syscall only when a thread is parked. Not recursive. lock(),
+    // try_lock() and unlock() make it usable with std::lock_guard.
+    class futex_mutex {
+    private:
+        // 0 free, 1 held, 2 held with waiters parked
+        std::atomic<uint32_t> state{0};
+        adaptive_spin spin;
+
+        void lock_contended();
+
+    public:
+        futex_mutex(const futex_mutex &other) = delete;
+
+        futex_mutex(futex_mutex &&other) = delete;
+
+        futex_mutex &operator=(const futex_mutex &other) = delete;
+
+        futex_mutex &operator=(futex_mutex &&other) = delete;
+
+        futex_mutex() = default;
+
+        // spin_limit caps the spins before parking, 0 never spins
+        explicit futex_mutex(uint32_t spin_limit);
+
+        ~futex_mutex() = default;
+
+        void lock();
+
+        bool try_lock();
+
+        void unlock();
+
+        void set_spin_limit(uint32_t spins);
+    };
+} // namespace YanLib::sync
+#endif // FUTEX_MUTEX_H
@@ -0,0 +1,255 @@
+/* clang-format off */
+/*
+ * @file futex_rwlock.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "futex_rwlock.h"
+#include <cstdlib>
+
+namespace YanLib::sync {
+    namespace {
+        constexpr uint32_t READ_LOCKED = 1;
+        constexpr uint32_t MASK = (1u << 30) - 1;
+        constexpr uint32_t WRITE_LOCKED = MASK;
+        constexpr uint32_t MAX_READERS = MASK - 1;
+        constexpr uint32_t READERS_WAITING = 1u << 30;
+        constexpr uint32_t WRITERS_WAITING = 1u << 31;
+
+        bool is_unlocked(const uint32_t state) {
+            return (state & MASK) == 0;
+        }
+
+        bool is_write_locked(const uint32_t state) {
+            return (state & MASK) == WRITE_LOCKED;
+        }
+
+        bool has_readers_waiting(const uint32_t state) {
+            return state & READERS_WAITING;
+        }
+
+        bool has_writers_waiting(const uint32_t state) {
+            return state & WRITERS_WAITING;
+        }
+
+        bool is_read_lockable(const uint32_t state) {
+            // Not while anyone waits: a waiting writer must get its turn,
+            // and waiting readers are only there because of one.
+            return (state & MASK) < MAX_READERS &&
+                    !has_readers_waiting(state) && !has_writers_waiting(state);
+        }
+    } // namespace
+
+    futex_rwlock::futex_rwlock(const uint32_t spin_limit) : spin(spin_limit) {
+    }
+
+    template <typename F>
+    uint32_t futex_rwlock::spin_until(F &&done) {
+        const uint32_t budget = spin.budget();
+        for (uint32_t spins = 0;; ++spins) {
+            const uint32_t current = state.load(std::memory_order_relaxed);
+            if (done(current)) {
+                spin.record(spins);
+                return current;
+            }
+            if (spins >= budget) {
+                spin.record(budget);
+                return current;
+            }
+            futex::pause();
+        }
+    }
+
+    void futex_rwlock::read_lock() {
+        uint32_t current = state.load(std::memory_order_relaxed);
+        if (!is_read_lockable(current) ||
+            !state.compare_exchange_weak(current, current + READ_LOCKED,
+                                         std::memory_order_acquire,
+                                         std::memory_order_relaxed)) {
+            read_contended();
+        }
+    }
+
+    void futex_rwlock::read_contended() {
+        const auto done = [](const uint32_t s) {
+            return !is_write_locked(s) || has_readers_waiting(s) ||
+                    has_writers_waiting(s);
+        };
+        uint32_t current = spin_until(done);
+        while (true) {
+            if (is_read_lockable(current)) {
+                if (state.compare_exchange_weak(current,
+                                                current + READ_LOCKED,
+                                                std::memory_order_acquire,
+                                                std::memory_order_relaxed)) {
+                    return;
+                }
+                continue;
+            }
+            if ((current & MASK) == MAX_READERS) {
+                std::abort();
+            }
+            // the flag must be up before sleeping, or nobody wakes us
+            if (!has_readers_waiting(current)) {
+                if (!state.compare_exchange_weak(current,
+                                                 current | READERS_WAITING,
+                                                 std::memory_order_relaxed)) {
+                    continue;
+                }
+            }
+            futex::wait(state, current | READERS_WAITING);
+            current = spin_until(done);
+        }
+    }
+
+    bool futex_rwlock::try_read_lock() {
+        uint32_t current = state.load(std::memory_order_relaxed);
+        while (is_read_lockable(current)) {
+            if (state.compare_exchange_weak(current, current + READ_LOCKED,
+                                            std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void futex_rwlock::read_unlock() {
+        const uint32_t current =
+                state.fetch_sub(READ_LOCKED, std::memory_order_release) -
+                READ_LOCKED;
+        // readers only wait on a read-locked lock behind a waiting writer
+        if (is_unlocked(current) && has_writers_waiting(current)) {
+            wake_writer_or_readers(current);
+        }
+    }
+
+    void futex_rwlock::write_lock() {
+        uint32_t expected = 0;
+        if (!state.compare_exchange_strong(expected, WRITE_LOCKED,
+                                           std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+            write_contended();
+        }
+    }
+
+    void futex_rwlock::write_contended() {
+        const auto done = [](const uint32_t s) {
+            return is_unlocked(s) || has_writers_waiting(s);
+        };
+        uint32_t current = spin_until(done);
+        // once this writer has slept it cannot know whether others still
+        // do, so it keeps the flag up when it takes the lock
+        uint32_t other_writers_waiting = 0;
+        while (true) {
+            if (is_unlocked(current)) {
+                if (state.compare_exchange_weak(
+                            current,
+                            current | WRITE_LOCKED | other_writers_waiting,
+                            std::memory_order_acquire,
+                            std::memory_order_relaxed)) {
+                    return;
+                }
+                continue;
+            }
+            if (!has_writers_waiting(current)) {
+                if (!state.compare_exchange_weak(current,
+                                                 current | WRITERS_WAITING,
+                                                 std::memory_order_relaxed)) {
+                    continue;
+                }
+            }
+            other_writers_waiting = WRITERS_WAITING;
+            // read the counter before the final check, a wakeup in
+            // between changes it and the wait returns at once
+            const uint32_t seq = writer_notify.load(std::memory_order_acquire);
+            current = state.load(std::memory_order_relaxed);
+            if (is_unlocked(current) || !has_writers_waiting(current)) {
+                continue;
+            }
+            futex::wait(writer_notify, seq);
+            current = spin_until(done);
+        }
+    }
+
+    bool futex_rwlock::try_write_lock() {
+        uint32_t current = state.load(std::memory_order_relaxed);
+        while (is_unlocked(current)) {
+            if (state.compare_exchange_weak(current, current + WRITE_LOCKED,
+                                            std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void futex_rwlock::write_unlock() {
+        const uint32_t current =
+                state.fetch_sub(WRITE_LOCKED, std::memory_order_release) -
+                WRITE_LOCKED;
+        if (has_readers_waiting(current) || has_writers_waiting(current)) {
+            wake_writer_or_readers(current);
+        }
+    }
+
+    void futex_rwlock::wake_writer_or_readers(uint32_t current) {
+        // writers go first
+        if (current == WRITERS_WAITING) {
+            if (state.compare_exchange_strong(current, 0,
+                                              std::memory_order_relaxed)) {
+                wake_writer();
+                return;
+            }
+        }
+        if (current == (READERS_WAITING | WRITERS_WAITING)) {
+            if (!state.compare_exchange_strong(current, READERS_WAITING,
+                                               std::memory_order_relaxed)) {
+                // a lock was taken meanwhile, its unlock wakes the rest
+                return;
+            }
+            if (wake_writer()) {
+                return;
+            }
+            // no writer was actually asleep (or the platform cannot say),
+            // fall through to the readers
+            current = READERS_WAITING;
+        }
+        if (current == READERS_WAITING) {
+            if (state.compare_exchange_strong(current, 0,
+                                              std::memory_order_relaxed)) {
+                futex::wake_all(state);
+            }
+        }
+    }
+
+    bool futex_rwlock::wake_writer() {
+        writer_notify.fetch_add(1, std::memory_order_release);
+        return futex::wake_one(writer_notify);
+    }
+
+    void futex_rwlock::set_spin_limit(const uint32_t spins) {
+        spin.set_limit(spins);
+    }
+} // namespace YanLib::sync
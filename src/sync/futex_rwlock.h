@@ -0,0 +1,91 @@
+/* clang-format off */
+/*
+ * @file futex_rwlock.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef FUTEX_RWLOCK_H
+#define FUTEX_RWLOCK_H
+#include <atomic>
+#include <cstdint>
+#include "futex.h"
+
+namespace YanLib::sync {
+    // Reader-writer lock on a futex word, a drop-in for sync::rwlock that
+    // also builds outside Windows. Readers take it with one
+    // compare-exchange; once a writer waits, new readers queue behind it
+    // so writers are not starved. Both sides spin adaptively before they
+    // park.
+    class futex_rwlock {
+    private:
+        // reader count or write-locked in the low 30 bits, then the
+        // readers-waiting and writers-waiting flags
+        std::atomic<uint32_t> state{0};
+        // bumped for every writer wakeup, writers park on it
+        std::atomic<uint32_t> writer_notify{0};
+        adaptive_spin spin;
+
+        template <typename F>
+        uint32_t spin_until(F &&done);
+
+        void read_contended();
+
+        void write_contended();
+
+        void wake_writer_or_readers(uint32_t current);
+
+        bool wake_writer();
+
+    public:
+        futex_rwlock(const futex_rwlock &other) = delete;
+
+        futex_rwlock(futex_rwlock &&other) = delete;
+
+        futex_rwlock &operator=(const futex_rwlock &other) = delete;
+
+        futex_rwlock &operator=(futex_rwlock &&other) = delete;
+
+        futex_rwlock() = default;
+
+        // spin_limit caps the spins before parking, 0 never spins
+        explicit futex_rwlock(uint32_t spin_limit);
+
+        ~futex_rwlock() = default;
+
+        void read_lock();
+
+        bool try_read_lock();
+
+        void read_unlock();
+
+        void write_lock();
+
+        bool try_write_lock();
+
+        void write_unlock();
+
+        void set_spin_limit(uint32_t spins);
+    };
+} // namespace YanLib::sync
+#endif // FUTEX_RWLOCK_H
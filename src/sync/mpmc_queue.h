@@ -0,0 +1,301 @@
+/* clang-format off */
+/*
+ * @file mpmc_queue.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "event_count.h"
+
+namespace YanLib::sync {
+    // Bounded multi-producer multi-consumer queue after Dmitry Vyukov:
+    // every cell carries a sequence number telling whose turn it is, so a
+    // producer or consumer claims a cell with one CAS on its own index and
+    // never touches the other side's. The try_ calls never block; push()
+    // and pop() wait on an event_count while the queue is full or empty.
+    // Capacity is rounded up to a power of two.
+    template <typename T> class mpmc_queue {
+        static_assert(std::is_nothrow_move_constructible_v<T> &&
+                              std::is_nothrow_move_assignable_v<T> &&
+                              std::is_nothrow_destructible_v<T>,
+                      "a claimed cell must always be filled and emptied");
+
+    private:
+        struct cell {
+            std::atomic<size_t> sequence;
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            T *get() {
+                return std::launder(reinterpret_cast<T *>(storage));
+            }
+        };
+
+        std::unique_ptr<cell[]> cells;
+        size_t mask;
+        alignas(64) std::atomic<size_t> enqueue_pos{0};
+        alignas(64) std::atomic<size_t> dequeue_pos{0};
+        alignas(64) event_count not_empty = {};
+        event_count not_full = {};
+
+        size_t claim_push(size_t count, size_t &pos);
+
+        size_t claim_pop(size_t count, size_t &pos);
+
+    public:
+        mpmc_queue(const mpmc_queue &other) = delete;
+
+        mpmc_queue(mpmc_queue &&other) = delete;
+
+        mpmc_queue &operator=(const mpmc_queue &other) = delete;
+
+        mpmc_queue &operator=(mpmc_queue &&other) = delete;
+
+        explicit mpmc_queue(size_t capacity);
+
+        // destroys whatever is still queued
+        ~mpmc_queue();
+
+        bool try_push(T value);
+
+        bool try_pop(T &out);
+
+        // Moves up to count items in with one CAS and returns how many
+        // fit; they stay contiguous in the queue.
+        size_t try_push_batch(T *items, size_t count);
+
+        size_t try_pop_batch(T *out, size_t count);
+
+        // blocks while the queue is full
+        void push(T value);
+
+        // blocks while the queue is empty
+        T pop();
+
+        [[nodiscard]] size_t capacity() const;
+
+        // a snapshot, stale as soon as it returns
+        [[nodiscard]] size_t size_approx() const;
+    };
+
+    template <typename T>
+    mpmc_queue<T>::mpmc_queue(const size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        cells = std::make_unique<cell[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        mask = size - 1;
+    }
+
+    template <typename T> mpmc_queue<T>::~mpmc_queue() {
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        const size_t end = enqueue_pos.load(std::memory_order_relaxed);
+        for (; pos != end; ++pos) {
+            cells[pos & mask].get()->~T();
+        }
+    }
+
+    template <typename T>
+    size_t mpmc_queue<T>::claim_push(const size_t count, size_t &pos) {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            // a cell is free for the producer at pos once its sequence
+            // has come round to pos
+            size_t n = 0;
+            while (n < count) {
+                const size_t seq = cells[(pos + n) & mask].sequence.load(
+                        std::memory_order_acquire);
+                if (seq != pos + n) {
+                    break;
+                }
+                ++n;
+            }
+            if (!n) {
+                const size_t seq =
+                        cells[pos & mask].sequence.load(
+                                std::memory_order_acquire);
+                if (static_cast<std::ptrdiff_t>(seq - pos) < 0) {
+                    // full: a consumer has not freed this cell yet
+                    return 0;
+                }
+                // another producer got here first
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (enqueue_pos.compare_exchange_weak(pos, pos + n,
+                                                  std::memory_order_relaxed)) {
+                return n;
+            }
+        }
+    }
+
+    template <typename T>
+    size_t mpmc_queue<T>::claim_pop(const size_t count, size_t &pos) {
+        pos = dequeue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            // a cell holds an item for the consumer at pos once its
+            // sequence is pos + 1
+            size_t n = 0;
+            while (n < count) {
+                const size_t seq = cells[(pos + n) & mask].sequence.load(
+                        std::memory_order_acquire);
+                if (seq != pos + n + 1) {
+                    break;
+                }
+                ++n;
+            }
+            if (!n) {
+                const size_t seq =
+                        cells[pos & mask].sequence.load(
+                                std::memory_order_acquire);
+                if (static_cast<std::ptrdiff_t>(seq - (pos + 1)) < 0) {
+                    // empty
+                    return 0;
+                }
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (dequeue_pos.compare_exchange_weak(pos, pos + n,
+                                                  std::memory_order_relaxed)) {
+                return n;
+            }
+        }
+    }
+
+    template <typename T> bool mpmc_queue<T>::try_push(T value) {
+        size_t pos = 0;
+        if (!claim_push(1, pos)) {
+            return false;
+        }
+        cell &c = cells[pos & mask];
+        new (c.storage) T(std::move(value));
+        c.sequence.store(pos + 1, std::memory_order_release);
+        not_empty.notify();
+        return true;
+    }
+
+    template <typename T> bool mpmc_queue<T>::try_pop(T &out) {
+        size_t pos = 0;
+        if (!claim_pop(1, pos)) {
+            return false;
+        }
+        cell &c = cells[pos & mask];
+        T *item = c.get();
+        out = std::move(*item);
+        item->~T();
+        // free for the producer one lap later
+        c.sequence.store(pos + mask + 1, std::memory_order_release);
+        not_full.notify();
+        return true;
+    }
+
+    template <typename T>
+    size_t mpmc_queue<T>::try_push_batch(T *items, const size_t count) {
+        size_t pos = 0;
+        const size_t n = count ? claim_push(count, pos) : 0;
+        for (size_t i = 0; i < n; ++i) {
+            cell &c = cells[(pos + i) & mask];
+            new (c.storage) T(std::move(items[i]));
+            c.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        if (n) {
+            not_empty.notify();
+        }
+        return n;
+    }
+
+    template <typename T>
+    size_t mpmc_queue<T>::try_pop_batch(T *out, const size_t count) {
+        size_t pos = 0;
+        const size_t n = count ? claim_pop(count, pos) : 0;
+        for (size_t i = 0; i < n; ++i) {
+            cell &c = cells[(pos + i) & mask];
+            T *item = c.get();
+            out[i] = std::move(*item);
+            item->~T();
+            c.sequence.store(pos + i + mask + 1, std::memory_order_release);
+        }
+        if (n) {
+            not_full.notify();
+        }
+        return n;
+    }
+
+    template <typename T> void mpmc_queue<T>::push(T value) {
+        size_t pos = 0;
+        while (!claim_push(1, pos)) {
+            const uint32_t key = not_full.prepare_wait();
+            if (claim_push(1, pos)) {
+                not_full.cancel_wait();
+                break;
+            }
+            not_full.wait(key);
+        }
+        cell &c = cells[pos & mask];
+        new (c.storage) T(std::move(value));
+        c.sequence.store(pos + 1, std::memory_order_release);
+        not_empty.notify();
+    }
+
+    template <typename T> T mpmc_queue<T>::pop() {
+        size_t pos = 0;
+        while (!claim_pop(1, pos)) {
+            const uint32_t key = not_empty.prepare_wait();
+            if (claim_pop(1, pos)) {
+                not_empty.cancel_wait();
+                break;
+            }
+            not_empty.wait(key);
+        }
+        cell &c = cells[pos & mask];
+        T *item = c.get();
+        T value = std::move(*item);
+        item->~T();
+        c.sequence.store(pos + mask + 1, std::memory_order_release);
+        not_full.notify();
+        return value;
+    }
+
+    template <typename T> size_t mpmc_queue<T>::capacity() const {
+        return mask + 1;
+    }
+
+    template <typename T> size_t mpmc_queue<T>::size_approx() const {
+        const size_t tail = dequeue_pos.load(std::memory_order_relaxed);
+        const size_t head = enqueue_pos.load(std::memory_order_relaxed);
+        return head > tail ? head - tail : 0;
+    }
+} // namespace YanLib::sync
+#endif // MPMC_QUEUE_H
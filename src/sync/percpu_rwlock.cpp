@@ -0,0 +1,164 @@
+/* clang-format off */
+/*
+ * @file percpu_rwlock.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "percpu_rwlock.h"
+#include <thread>
+
+namespace YanLib::sync {
+    namespace {
+        // spins before a writer parks on a slot that has not drained
+        constexpr uint32_t DRAIN_SPINS = 200;
+
+        // more slots than this buys nothing but slower writers
+        constexpr uint32_t MAX_SLOTS = 256;
+
+        std::atomic<uint32_t> next_slot{0};
+
+        // Handed out round-robin: threads then spread evenly whatever core
+        // they start on, which asking the CPU number once would not do.
+        uint32_t thread_slot() {
+            thread_local const uint32_t index =
+                    next_slot.fetch_add(1, std::memory_order_relaxed);
+            return index;
+        }
+    } // namespace
+
+    percpu_rwlock::percpu_rwlock()
+        : percpu_rwlock(std::thread::hardware_concurrency()) {
+    }
+
+    percpu_rwlock::percpu_rwlock(const uint32_t slot_count) {
+        uint32_t count = 1;
+        while (count < slot_count && count < MAX_SLOTS) {
+            count <<= 1;
+        }
+        slots = std::make_unique<slot[]>(count);
+        slot_mask = count - 1;
+    }
+
+    percpu_rwlock::slot &percpu_rwlock::local_slot() const {
+        return slots[thread_slot() & slot_mask];
+    }
+
+    void percpu_rwlock::read_lock() {
+        slot &s = local_slot();
+        while (true) {
+            // seq_cst on both sides: either this reader sees the writer's
+            // flag or the writer sees this reader's count
+            s.readers.fetch_add(1, std::memory_order_seq_cst);
+            if (!writer.load(std::memory_order_seq_cst)) {
+                return;
+            }
+            leave(s);
+            wait_for_writer();
+        }
+    }
+
+    bool percpu_rwlock::try_read_lock() {
+        slot &s = local_slot();
+        s.readers.fetch_add(1, std::memory_order_seq_cst);
+        if (!writer.load(std::memory_order_seq_cst)) {
+            return true;
+        }
+        leave(s);
+        return false;
+    }
+
+    void percpu_rwlock::read_unlock() {
+        leave(local_slot());
+    }
+
+    void percpu_rwlock::leave(slot &s) {
+        if (s.readers.fetch_sub(1, std::memory_order_seq_cst) == 1 &&
+            writer.load(std::memory_order_seq_cst)) {
+            // the last reader out of this slot, a writer may be parked on it
+            futex::wake_all(s.readers);
+        }
+    }
+
+    void percpu_rwlock::wait_for_writer() {
+        reader_waiters.fetch_add(1, std::memory_order_seq_cst);
+        while (writer.load(std::memory_order_seq_cst)) {
+            futex::wait(writer, 1);
+        }
+        reader_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void percpu_rwlock::drain() {
+        for (uint32_t i = 0; i <= slot_mask; ++i) {
+            std::atomic<uint32_t> &readers = slots[i].readers;
+            uint32_t spins = 0;
+            uint32_t count = readers.load(std::memory_order_seq_cst);
+            while (count) {
+                if (spins < DRAIN_SPINS) {
+                    ++spins;
+                    futex::pause();
+                } else {
+                    futex::wait(readers, count);
+                }
+                count = readers.load(std::memory_order_seq_cst);
+            }
+        }
+    }
+
+    void percpu_rwlock::release_readers() {
+        writer.store(0, std::memory_order_seq_cst);
+        if (reader_waiters.load(std::memory_order_seq_cst)) {
+            futex::wake_all(writer);
+        }
+    }
+
+    void percpu_rwlock::write_lock() {
+        writer_mutex.lock();
+        writer.store(1, std::memory_order_seq_cst);
+        drain();
+    }
+
+    bool percpu_rwlock::try_write_lock() {
+        if (!writer_mutex.try_lock()) {
+            return false;
+        }
+        writer.store(1, std::memory_order_seq_cst);
+        for (uint32_t i = 0; i <= slot_mask; ++i) {
+            if (slots[i].readers.load(std::memory_order_seq_cst)) {
+                release_readers();
+                writer_mutex.unlock();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void percpu_rwlock::write_unlock() {
+        release_readers();
+        writer_mutex.unlock();
+    }
+
+    uint32_t percpu_rwlock::slot_count() const {
+        return slot_mask + 1;
+    }
+} // namespace YanLib::sync
@@ -0,0 +1,98 @@
+/* clang-format off */
+/*
+ * @file percpu_rwlock.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef PERCPU_RWLOCK_H
+#define PERCPU_RWLOCK_H
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "futex.h"
+#include "futex_mutex.h"
+
+namespace YanLib::sync {
+    // "Big-reader" lock for read-mostly data. Readers count themselves in
+    // one of several cache-line sized slots, about one per CPU, so readers
+    // on different cores touch different lines and scale with the core
+    // count. A writer raises a flag and waits for every slot to drain,
+    // which makes writes cost O(slots); readers that see the flag step
+    // back and wait for it, so writers are not starved. Same interface as
+    // sync::rwlock. A thread keeps the slot it is given first, so read
+    // locks may be nested across locks and migrate with the thread.
+    class percpu_rwlock {
+    private:
+        struct alignas(64) slot {
+            std::atomic<uint32_t> readers{0};
+        };
+
+        std::unique_ptr<slot[]> slots;
+        uint32_t slot_mask = 0;
+        alignas(64) std::atomic<uint32_t> writer{0};
+        std::atomic<uint32_t> reader_waiters{0};
+        futex_mutex writer_mutex = {};
+
+        slot &local_slot() const;
+
+        void leave(slot &s);
+
+        void wait_for_writer();
+
+        void drain();
+
+        void release_readers();
+
+    public:
+        percpu_rwlock(const percpu_rwlock &other) = delete;
+
+        percpu_rwlock(percpu_rwlock &&other) = delete;
+
+        percpu_rwlock &operator=(const percpu_rwlock &other) = delete;
+
+        percpu_rwlock &operator=(percpu_rwlock &&other) = delete;
+
+        percpu_rwlock();
+
+        // slot_count is rounded up to a power of two
+        explicit percpu_rwlock(uint32_t slot_count);
+
+        ~percpu_rwlock() = default;
+
+        void read_lock();
+
+        bool try_read_lock();
+
+        void read_unlock();
+
+        void write_lock();
+
+        bool try_write_lock();
+
+        void write_unlock();
+
+        [[nodiscard]] uint32_t slot_count() const;
+    };
+} // namespace YanLib::sync
+#endif // PERCPU_RWLOCK_H
@@ -0,0 +1,139 @@
+/* clang-format off */
+/*
+ * @file rcu.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "rcu.h"
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "futex.h"
+
+namespace YanLib::sync {
+    namespace {
+        // polls before a waiting writer starts yielding
+        constexpr uint32_t SPIN_ROUNDS = 128;
+
+        struct reader {
+            // 0 outside a read section, else the grace period it began in
+            std::atomic<uint64_t> period{0};
+            uint32_t nesting = 0;
+        };
+
+        struct domain {
+            std::atomic<uint64_t> period{1};
+            std::mutex readers_mutex;
+            // Every record ever handed out. Records are never freed, so a
+            // writer polls a copy of the list without holding the mutex.
+            std::vector<reader *> readers;
+            // records of exited threads, taken over by new ones
+            std::vector<reader *> spare;
+            // one grace period at a time
+            std::mutex writer_mutex;
+        };
+
+        // never destroyed: threads may still leave after static teardown
+        domain &state() {
+            static domain *d = new domain;
+            return *d;
+        }
+
+        struct registration {
+            reader *self = nullptr;
+
+            registration() {
+                domain &d = state();
+                std::lock_guard<std::mutex> lock(d.readers_mutex);
+                if (d.spare.empty()) {
+                    self = new reader;
+                    d.readers.push_back(self);
+                } else {
+                    self = d.spare.back();
+                    d.spare.pop_back();
+                }
+            }
+
+            ~registration() {
+                // idle from here on, whatever section the thread left open
+                self->nesting = 0;
+                self->period.store(0, std::memory_order_release);
+                domain &d = state();
+                std::lock_guard<std::mutex> lock(d.readers_mutex);
+                d.spare.push_back(self);
+            }
+        };
+
+        reader &local_reader() {
+            thread_local registration local;
+            return *local.self;
+        }
+    } // namespace
+
+    void rcu::read_lock() {
+        reader &r = local_reader();
+        if (r.nesting++ == 0) {
+            // seq_cst store, then seq_cst pointer loads in rcu_ptr: either
+            // synchronize() sees this section or the section sees the new
+            // pointer. A stale period only makes writers wait longer.
+            r.period.store(state().period.load(std::memory_order_relaxed),
+                           std::memory_order_seq_cst);
+        }
+    }
+
+    void rcu::read_unlock() {
+        reader &r = local_reader();
+        if (--r.nesting == 0) {
+            r.period.store(0, std::memory_order_release);
+        }
+    }
+
+    void rcu::synchronize() {
+        domain &d = state();
+        std::lock_guard<std::mutex> writer(d.writer_mutex);
+        const uint64_t target =
+                d.period.fetch_add(1, std::memory_order_seq_cst) + 1;
+        std::vector<reader *> readers;
+        {
+            // registration only waits for the copy, not the grace period
+            std::lock_guard<std::mutex> lock(d.readers_mutex);
+            readers = d.readers;
+        }
+        for (const reader *r : readers) {
+            // sections that began from target on cannot see the old value
+            for (uint32_t polls = 0;; ++polls) {
+                const uint64_t period =
+                        r->period.load(std::memory_order_seq_cst);
+                if (!period || period >= target) {
+                    break;
+                }
+                if (polls < SPIN_ROUNDS) {
+                    futex::pause();
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    }
+} // namespace YanLib::sync
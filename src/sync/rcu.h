@@ -0,0 +1,150 @@
+/* clang-format off */
+/*
+ * @file rcu.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef RCU_H
+#define RCU_H
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace YanLib::sync {
+    // Read-copy-update. Readers mark a read section and follow published
+    // pointers without locks or shared writes beyond their own counter; a
+    // writer builds a new version, swaps the pointer and waits in
+    // synchronize() until every section that could still see the old one
+    // has ended, then frees it. One grace-period counter serves the whole
+    // process; threads register on their first read_lock().
+    class rcu {
+    public:
+        rcu(const rcu &other) = delete;
+
+        rcu(rcu &&other) = delete;
+
+        rcu &operator=(const rcu &other) = delete;
+
+        rcu &operator=(rcu &&other) = delete;
+
+        rcu() = delete;
+
+        ~rcu() = delete;
+
+        // Nests and never waits for a writer; a thread's first call
+        // registers it under a lock held only briefly.
+        static void read_lock();
+
+        static void read_unlock();
+
+        // Returns once every read section running at the call has ended.
+        // Blocks, so never from inside a read section.
+        static void synchronize();
+    };
+
+    class rcu_guard {
+    public:
+        rcu_guard(const rcu_guard &other) = delete;
+
+        rcu_guard(rcu_guard &&other) = delete;
+
+        rcu_guard &operator=(const rcu_guard &other) = delete;
+
+        rcu_guard &operator=(rcu_guard &&other) = delete;
+
+        rcu_guard() {
+            rcu::read_lock();
+        }
+
+        ~rcu_guard() {
+            rcu::read_unlock();
+        }
+    };
+
+    // A pointer published through rcu: readers call read() inside a read
+    // section and may use the result until the section ends; publish()
+    // swaps in a new object and frees the old one after a grace period.
+    template <typename T> class rcu_ptr {
+    private:
+        std::atomic<T *> ptr{nullptr};
+
+    public:
+        rcu_ptr(const rcu_ptr &other) = delete;
+
+        rcu_ptr(rcu_ptr &&other) = delete;
+
+        rcu_ptr &operator=(const rcu_ptr &other) = delete;
+
+        rcu_ptr &operator=(rcu_ptr &&other) = delete;
+
+        rcu_ptr() = default;
+
+        explicit rcu_ptr(std::unique_ptr<T> initial);
+
+        // no reader may still hold the current object
+        ~rcu_ptr();
+
+        [[nodiscard]] const T *read() const;
+
+        // blocks for a grace period, never from inside a read section
+        void publish(std::unique_ptr<T> next);
+
+        // Installs next only if nothing is published yet and returns
+        // whether it did; safe inside a read section, it never waits.
+        bool publish_if_empty(std::unique_ptr<T> &next);
+    };
+
+    template <typename T>
+    rcu_ptr<T>::rcu_ptr(std::unique_ptr<T> initial) : ptr(initial.release()) {
+    }
+
+    template <typename T> rcu_ptr<T>::~rcu_ptr() {
+        delete ptr.load(std::memory_order_relaxed);
+    }
+
+    template <typename T> const T *rcu_ptr<T>::read() const {
+        // seq_cst, paired with the reader's counter store in read_lock
+        return ptr.load(std::memory_order_seq_cst);
+    }
+
+    template <typename T> void rcu_ptr<T>::publish(std::unique_ptr<T> next) {
+        std::unique_ptr<T> old(
+                ptr.exchange(next.release(), std::memory_order_seq_cst));
+        if (old) {
+            rcu::synchronize();
+        }
+    }
+
+    template <typename T>
+    bool rcu_ptr<T>::publish_if_empty(std::unique_ptr<T> &next) {
+        T *expected = nullptr;
+        if (!ptr.compare_exchange_strong(expected, next.get(),
+                                         std::memory_order_seq_cst)) {
+            return false;
+        }
+        next.release();
+        return true;
+    }
+} // namespace YanLib::sync
+#endif // RCU_H
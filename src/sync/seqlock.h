@@ -0,0 +1,167 @@
+/* clang-format off */
+/*
+ * @file seqlock.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include "futex.h"
+#include "futex_mutex.h"
+
+namespace YanLib::sync {
+    // Sequence lock for small trivially copyable state read far more often
+    // than written. Readers take no lock and write nothing shared: they
+    // copy the value and retry if the sequence number moved or was odd
+    // (a write in progress). Writers serialize on a futex_mutex. The value
+    // is kept as relaxed atomic words so a torn read is a retry, not a
+    // data race.
+    template <typename T> class seqlock {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "readers copy the value bytewise");
+
+    private:
+        static constexpr size_t WORDS = (sizeof(T) + 7) / 8;
+
+        // after this many failed reads a reader yields between tries
+        static constexpr uint32_t SPIN_ROUNDS = 64;
+
+        std::atomic<uint32_t> sequence{0};
+        std::atomic<uint64_t> words[WORDS] = {};
+        futex_mutex writer_mutex = {};
+
+        void write_words(const T &value);
+
+        // writer lock held
+        void publish(const T &value);
+
+    public:
+        seqlock(const seqlock &other) = delete;
+
+        seqlock(seqlock &&other) = delete;
+
+        seqlock &operator=(const seqlock &other) = delete;
+
+        seqlock &operator=(seqlock &&other) = delete;
+
+        seqlock();
+
+        explicit seqlock(const T &initial);
+
+        ~seqlock() = default;
+
+        // one attempt, false if a writer got in the way
+        bool try_load(T &out) const;
+
+        [[nodiscard]] T load() const;
+
+        void store(const T &value);
+
+        // read-modify-write under the writer lock: fn(T &) edits a copy
+        // of the current value, which is then stored
+        template <typename F> void update(F &&fn);
+    };
+
+    template <typename T> seqlock<T>::seqlock() : seqlock(T{}) {
+    }
+
+    template <typename T> seqlock<T>::seqlock(const T &initial) {
+        write_words(initial);
+    }
+
+    template <typename T> void seqlock<T>::write_words(const T &value) {
+        uint64_t buffer[WORDS] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        for (size_t i = 0; i < WORDS; ++i) {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T> bool seqlock<T>::try_load(T &out) const {
+        const uint32_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+        uint64_t buffer[WORDS];
+        for (size_t i = 0; i < WORDS; ++i) {
+            buffer[i] = words[i].load(std::memory_order_relaxed);
+        }
+        // keeps the word loads above the second sequence load
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(&out, buffer, sizeof(T));
+        return true;
+    }
+
+    template <typename T> T seqlock<T>::load() const {
+        T value;
+        for (uint32_t tries = 0; !try_load(value); ++tries) {
+            if (tries < SPIN_ROUNDS) {
+                futex::pause();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        return value;
+    }
+
+    template <typename T> void seqlock<T>::publish(const T &value) {
+        const uint32_t current = sequence.load(std::memory_order_relaxed);
+        sequence.store(current + 1, std::memory_order_relaxed);
+        // keeps the word stores below the odd sequence number
+        std::atomic_thread_fence(std::memory_order_release);
+        write_words(value);
+        sequence.store(current + 2, std::memory_order_release);
+    }
+
+    template <typename T> void seqlock<T>::store(const T &value) {
+        std::lock_guard<futex_mutex> lock(writer_mutex);
+        publish(value);
+    }
+
+    template <typename T>
+    template <typename F>
+    void seqlock<T>::update(F &&fn) {
+        std::lock_guard<futex_mutex> lock(writer_mutex);
+        // no other writer can run, so the words are stable here
+        uint64_t buffer[WORDS];
+        for (size_t i = 0; i < WORDS; ++i) {
+            buffer[i] = words[i].load(std::memory_order_relaxed);
+        }
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        fn(value);
+        publish(value);
+    }
+} // namespace YanLib::sync
+#endif // SEQLOCK_H
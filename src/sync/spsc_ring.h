@@ -0,0 +1,242 @@
+/* clang-format off */
+/*
+ * @file spsc_ring.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "event_count.h"
+
+namespace YanLib::sync {
+    // Bounded ring for exactly one producer and one consumer thread. Each
+    // side keeps its own index on its own cache line, plus a cached copy
+    // of the other side's that it refreshes only when the ring looks full
+    // (or empty), so in steady state neither side reads the other's line.
+    // push() and pop() block on an event_count; the try_ calls never do.
+    // Capacity is rounded up to a power of two.
+    template <typename T> class spsc_ring {
+        static_assert(std::is_nothrow_move_constructible_v<T> &&
+                              std::is_nothrow_move_assignable_v<T> &&
+                              std::is_nothrow_destructible_v<T>,
+                      "a reserved slot must always be filled and emptied");
+
+    private:
+        struct slot {
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            T *get() {
+                return std::launder(reinterpret_cast<T *>(storage));
+            }
+        };
+
+        std::unique_ptr<slot[]> slots;
+        size_t mask;
+        // consumer side
+        alignas(64) std::atomic<size_t> head{0};
+        size_t cached_tail = 0;
+        // producer side
+        alignas(64) std::atomic<size_t> tail{0};
+        size_t cached_head = 0;
+        alignas(64) event_count not_empty = {};
+        event_count not_full = {};
+
+        size_t writable(size_t t, size_t count);
+
+        size_t readable(size_t h, size_t count);
+
+    public:
+        spsc_ring(const spsc_ring &other) = delete;
+
+        spsc_ring(spsc_ring &&other) = delete;
+
+        spsc_ring &operator=(const spsc_ring &other) = delete;
+
+        spsc_ring &operator=(spsc_ring &&other) = delete;
+
+        explicit spsc_ring(size_t capacity);
+
+        ~spsc_ring();
+
+        // producer thread only
+        bool try_push(T value);
+
+        size_t try_push_batch(T *items, size_t count);
+
+        void push(T value);
+
+        // consumer thread only
+        bool try_pop(T &out);
+
+        size_t try_pop_batch(T *out, size_t count);
+
+        T pop();
+
+        [[nodiscard]] size_t capacity() const;
+
+        [[nodiscard]] size_t size_approx() const;
+    };
+
+    template <typename T> spsc_ring<T>::spsc_ring(const size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        slots = std::make_unique<slot[]>(size);
+        mask = size - 1;
+    }
+
+    template <typename T> spsc_ring<T>::~spsc_ring() {
+        const size_t end = tail.load(std::memory_order_relaxed);
+        for (size_t i = head.load(std::memory_order_relaxed); i != end; ++i) {
+            slots[i & mask].get()->~T();
+        }
+    }
+
+    template <typename T>
+    size_t spsc_ring<T>::writable(const size_t t, const size_t count) {
+        size_t space = mask + 1 - (t - cached_head);
+        if (space < count) {
+            cached_head = head.load(std::memory_order_acquire);
+            space = mask + 1 - (t - cached_head);
+        }
+        return space < count ? space : count;
+    }
+
+    template <typename T>
+    size_t spsc_ring<T>::readable(const size_t h, const size_t count) {
+        size_t ready = cached_tail - h;
+        if (ready < count) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            ready = cached_tail - h;
+        }
+        return ready < count ? ready : count;
+    }
+
+    template <typename T> bool spsc_ring<T>::try_push(T value) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (!writable(t, 1)) {
+            return false;
+        }
+        new (slots[t & mask].storage) T(std::move(value));
+        tail.store(t + 1, std::memory_order_release);
+        not_empty.notify();
+        return true;
+    }
+
+    template <typename T>
+    size_t spsc_ring<T>::try_push_batch(T *items, const size_t count) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        const size_t n = writable(t, count);
+        for (size_t i = 0; i < n; ++i) {
+            new (slots[(t + i) & mask].storage) T(std::move(items[i]));
+        }
+        if (n) {
+            // one release store publishes the whole batch
+            tail.store(t + n, std::memory_order_release);
+            not_empty.notify();
+        }
+        return n;
+    }
+
+    template <typename T> void spsc_ring<T>::push(T value) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        while (!writable(t, 1)) {
+            const uint32_t key = not_full.prepare_wait();
+            if (writable(t, 1)) {
+                not_full.cancel_wait();
+                break;
+            }
+            not_full.wait(key);
+        }
+        new (slots[t & mask].storage) T(std::move(value));
+        tail.store(t + 1, std::memory_order_release);
+        not_empty.notify();
+    }
+
+    template <typename T> bool spsc_ring<T>::try_pop(T &out) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (!readable(h, 1)) {
+            return false;
+        }
+        T *item = slots[h & mask].get();
+        out = std::move(*item);
+        item->~T();
+        head.store(h + 1, std::memory_order_release);
+        not_full.notify();
+        return true;
+    }
+
+    template <typename T>
+    size_t spsc_ring<T>::try_pop_batch(T *out, const size_t count) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        const size_t n = readable(h, count);
+        for (size_t i = 0; i < n; ++i) {
+            T *item = slots[(h + i) & mask].get();
+            out[i] = std::move(*item);
+            item->~T();
+        }
+        if (n) {
+            head.store(h + n, std::memory_order_release);
+            not_full.notify();
+        }
+        return n;
+    }
+
+    template <typename T> T spsc_ring<T>::pop() {
+        const size_t h = head.load(std::memory_order_relaxed);
+        while (!readable(h, 1)) {
+            const uint32_t key = not_empty.prepare_wait();
+            if (readable(h, 1)) {
+                not_empty.cancel_wait();
+                break;
+            }
+            not_empty.wait(key);
+        }
+        T *item = slots[h & mask].get();
+        T value = std::move(*item);
+        item->~T();
+        head.store(h + 1, std::memory_order_release);
+        not_full.notify();
+        return value;
+    }
+
+    template <typename T> size_t spsc_ring<T>::capacity() const {
+        return mask + 1;
+    }
+
+    template <typename T> size_t spsc_ring<T>::size_approx() const {
+        const size_t h = head.load(std::memory_order_relaxed);
+        const size_t t = tail.load(std::memory_order_relaxed);
+        return t > h ? t - h : 0;
+    }
+} // namespace YanLib::sync
+#endif // SPSC_RING_H
@@ -0,0 +1,83 @@
+/* clang-format off */
+/*
+ * @file ticket_lock.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "ticket_lock.h"
+
+namespace YanLib::sync {
+    ticket_lock::ticket_lock(const uint32_t spin_limit) : spin(spin_limit) {
+    }
+
+    void ticket_lock::lock() {
+        const uint32_t ticket = next.fetch_add(1, std::memory_order_relaxed);
+        uint32_t current = serving.load(std::memory_order_acquire);
+        if (current == ticket) {
+            return;
+        }
+        const uint32_t budget = spin.budget();
+        uint32_t spins = 0;
+        while (current != ticket && spins < budget) {
+            // the further back in line, the longer between looks
+            const uint32_t ahead = ticket - current;
+            for (uint32_t i = 0; i < ahead && spins < budget; ++i, ++spins) {
+                futex::pause();
+            }
+            current = serving.load(std::memory_order_acquire);
+        }
+        spin.record(current == ticket ? spins : budget);
+        while (current != ticket) {
+            // seq_cst on both sides: either unlock() sees the sleeper or
+            // this thread sees the new serving value
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            current = serving.load(std::memory_order_seq_cst);
+            if (current != ticket) {
+                futex::wait(serving, current);
+            }
+            sleepers.fetch_sub(1, std::memory_order_relaxed);
+            current = serving.load(std::memory_order_acquire);
+        }
+    }
+
+    bool ticket_lock::try_lock() {
+        uint32_t ticket = serving.load(std::memory_order_acquire);
+        // only when nobody holds or waits: take the ticket being served
+        return next.compare_exchange_strong(ticket, ticket + 1,
+                                            std::memory_order_acquire,
+                                            std::memory_order_relaxed);
+    }
+
+    void ticket_lock::unlock() {
+        serving.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_seq_cst)) {
+            // each sleeper waits for its own ticket, wake them all
+            futex::wake_all(serving);
+        }
+    }
+
+    void ticket_lock::set_spin_limit(const uint32_t spins) {
+        spin.set_limit(spins);
+    }
+} // namespace YanLib::sync
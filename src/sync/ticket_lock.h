@@ -0,0 +1,72 @@
+/* clang-format off */
+/*
+ * @file ticket_lock.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef TICKET_LOCK_H
+#define TICKET_LOCK_H
+#include <atomic>
+#include <cstdint>
+#include "futex.h"
+
+namespace YanLib::sync {
+    // FIFO lock: every locker draws a ticket and waits for it to be
+    // served, so no thread is overtaken. Waiters spin in proportion to
+    // their place in the line and park on the serving counter once the
+    // spin budget runs out. Meant for short, fairness-sensitive sections;
+    // a parked waiter costs every unlock a wake-all.
+    class ticket_lock {
+    private:
+        alignas(64) std::atomic<uint32_t> next{0};
+        alignas(64) std::atomic<uint32_t> serving{0};
+        std::atomic<uint32_t> sleepers{0};
+        adaptive_spin spin;
+
+    public:
+        ticket_lock(const ticket_lock &other) = delete;
+
+        ticket_lock(ticket_lock &&other) = delete;
+
+        ticket_lock &operator=(const ticket_lock &other) = delete;
+
+        ticket_lock &operator=(ticket_lock &&other) = delete;
+
+        ticket_lock() = default;
+
+        // spin_limit caps the spins before parking, 0 never spins
+        explicit ticket_lock(uint32_t spin_limit);
+
+        ~ticket_lock() = default;
+
+        void lock();
+
+        bool try_lock();
+
+        void unlock();
+
+        void set_spin_limit(uint32_t spins);
+    };
+} // namespace YanLib::sync
+#endif // TICKET_LOCK_H
@@ -27,6 +27,7 @@
 /* clang-format on */
 #include "fiber.h"
 #include "helper/convert.h"
+#include <algorithm>
 #include <random>
 
 namespace YanLib::sys {
@@ -58,6 +59,27 @@ namespace YanLib::sys {
         return addr;
     }
 
+    bool fiber::destroy(void *addr) {
+        if (!addr || addr == GetCurrentFiber()) {
+            error_code = ERROR_INVALID_PARAMETER;
+            return false;
+        }
+        fiber_lock.write_lock();
+        const auto it = std::find(fiber_addrs.begin(), fiber_addrs.end(), addr);
+        const bool found = it != fiber_addrs.end();
+        if (found) {
+            *it = fiber_addrs.back();
+            fiber_addrs.pop_back();
+        }
+        fiber_lock.write_unlock();
+        if (!found) {
+            error_code = ERROR_INVALID_PARAMETER;
+            return false;
+        }
+        DeleteFiber(addr);
+        return true;
+    }
+
     uint32_t fiber::fls_alloc(PFLS_CALLBACK_FUNCTION callback) {
         const uint32_t index = FlsAlloc(callback);
         if (index == FLS_OUT_OF_INDEXES) {
@@ -101,12 +123,16 @@ namespace YanLib::sys {
     void fiber::yield() {
         std::random_device rd = {};
         fiber_lock.read_lock();
-        size_t index = rd() % fiber_addrs.size();
-        if (index > fiber_addrs.size()) {
-            index = fiber_addrs.size() - 1;
+        void *addr = nullptr;
+        if (!fiber_addrs.empty()) {
+            addr = fiber_addrs[rd() % fiber_addrs.size()];
+        }
+        // unlocked before switching, the fiber switched to may never come
+        // back to release it
+        fiber_lock.read_unlock();
+        if (addr && addr != GetCurrentFiber()) {
+            SwitchToFiber(addr);
         }
-        SwitchToFiber(fiber_addrs[index]);
-        fiber_lock.read_lock();
     }
 
     void *fiber::thread_to_fiber(void *params, const bool switch_float) {
@@ -134,7 +160,9 @@ namespace YanLib::sys {
         if (const auto it =
                     std::find(fiber_addrs.begin(), fiber_addrs.end(), addr);
             it != fiber_addrs.end()) {
-            *it = nullptr;
+            // the thread's fiber data is freed by ConvertFiberToThread
+            *it = fiber_addrs.back();
+            fiber_addrs.pop_back();
         }
         fiber_lock.write_unlock();
         if (!ConvertFiberToThread()) {
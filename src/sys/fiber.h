@@ -32,13 +32,13 @@
 #include <WinBase.h>
 #include <string>
 #include <vector>
-#include "sync/rwlock.h"
+#include "sync/futex_rwlock.h"
 
 namespace YanLib::sys {
     class fiber {
     private:
         std::vector<void *> fiber_addrs = {};
-        sync::rwlock fiber_lock = {};
+        sync::futex_rwlock fiber_lock = {};
         uint32_t error_code = 0;
 
     public:
@@ -60,6 +60,9 @@ namespace YanLib::sys {
                      size_t reserve = 0,
                      bool switch_float = true);
 
+        // deletes a fiber made by create(), never the running one
+        bool destroy(void *addr);
+
         uint32_t fls_alloc(PFLS_CALLBACK_FUNCTION callback);
 
         bool fls_free(uint32_t index);
@@ -0,0 +1,547 @@
+/* clang-format off */
+/*
+ * @file fiber_scheduler.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "fiber_scheduler.h"
+#include <functional>
+#include <system_error>
+#ifdef _WIN32
+#include "helper/convert.h"
+#else
+#include <cstring>
+#include <cerrno>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef _MSC_VER
+#define FIBER_NOINLINE __declspec(noinline)
+#else
+#define FIBER_NOINLINE __attribute__((noinline))
+#endif
+
+namespace YanLib::sys {
+    namespace {
+        // scans for work before a carrier parks
+        constexpr uint32_t SPIN_ROUNDS = 64;
+        // a deque that keeps refilling must not starve the inject queue
+        constexpr uint32_t INJECT_EVERY = 61;
+
+        uint64_t next_random(uint64_t &state) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        }
+    } // namespace
+
+    thread_local fiber_scheduler::carrier *fiber_scheduler::local = nullptr;
+
+    void fiber_scheduler::green_thread::run() {
+        owner->resume(this);
+    }
+
+    fiber_scheduler::fiber_scheduler(uint32_t carriers, const size_t stack_size)
+        : stack_size(stack_size) {
+        if (!carriers) {
+            carriers = std::thread::hardware_concurrency();
+            carriers = carriers ? carriers : 1;
+        }
+        this->carriers.reserve(carriers);
+        for (uint32_t i = 0; i < carriers; ++i) {
+            auto c = std::make_unique<carrier>();
+            c->owner = this;
+            c->index = i;
+            c->seed = 0x9E3779B97F4A7C15ULL * (i + 1);
+            this->carriers.push_back(std::move(c));
+        }
+        for (uint32_t i = 0; i < carriers; ++i) {
+            try {
+                this->carriers[i]->thread =
+                        std::thread(&fiber_scheduler::carrier_loop, this,
+                                    std::ref(*this->carriers[i]));
+            } catch (const std::system_error &e) {
+                error_code = static_cast<uint32_t>(e.code().value());
+                // running carriers may already be reading carriers, so it
+                // keeps its size and thieves stop at started
+                break;
+            }
+            started.store(i + 1, std::memory_order_release);
+        }
+    }
+
+    fiber_scheduler::~fiber_scheduler() {
+        wait();
+        // nothing may unpark a fiber once the carriers are gone
+        timers.stop();
+        offload_pool.reset();
+        {
+            std::lock_guard<std::mutex> lock(park_mutex);
+            stopping.store(true, std::memory_order_seq_cst);
+            epoch.fetch_add(1, std::memory_order_seq_cst);
+        }
+        park_cv.notify_all();
+        for (auto &c : carriers) {
+            if (c->thread.joinable()) {
+                c->thread.join();
+            }
+        }
+        // Every fiber left is suspended at the end of entry(). On Windows
+        // the fibers member deletes them all in one pass when it goes, a
+        // destroy() per fiber would search its list each time.
+#ifndef _WIN32
+        for (auto &g : all) {
+            if (g->stack) {
+                munmap(g->stack, g->stack_bytes);
+            }
+        }
+#endif
+    }
+
+    // Not inlined: a fiber may resume on another thread, and a caller
+    // that had the thread_local address folded in would read the old
+    // carrier.
+    FIBER_NOINLINE fiber_scheduler::carrier *fiber_scheduler::this_carrier() {
+        return local;
+    }
+
+    fiber_scheduler *fiber_scheduler::current_owner() {
+        const carrier *c = this_carrier();
+        return c ? c->owner : nullptr;
+    }
+
+    bool fiber_scheduler::in_fiber() {
+        return current() != nullptr;
+    }
+
+    fiber_scheduler::green_thread *fiber_scheduler::current() {
+        const carrier *c = this_carrier();
+        return c ? c->running : nullptr;
+    }
+
+    fiber_scheduler::green_thread *fiber_scheduler::make_green() {
+        {
+            std::lock_guard<std::mutex> lock(free_mutex);
+            if (!free_list.empty()) {
+                green_thread *g = free_list.back();
+                free_list.pop_back();
+                return g;
+            }
+        }
+        auto g = std::make_unique<green_thread>();
+        g->owner = this;
+#ifdef _WIN32
+        g->context = fibers.create(fiber_entry, g.get(), 0, stack_size);
+        if (!g->context) {
+            error_code = fibers.err_code();
+            return nullptr;
+        }
+#else
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        // one guard page below the stack, an overflow faults instead of
+        // running into the neighbour
+        const size_t bytes = (stack_size + page - 1) / page * page + page;
+        void *stack = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (stack == MAP_FAILED) {
+            error_code = static_cast<uint32_t>(errno);
+            return nullptr;
+        }
+        mprotect(stack, page, PROT_NONE);
+        if (getcontext(&g->context) != 0) {
+            error_code = static_cast<uint32_t>(errno);
+            munmap(stack, bytes);
+            return nullptr;
+        }
+        g->stack = stack;
+        g->stack_bytes = bytes;
+        g->context.uc_stack.ss_sp = static_cast<char *>(stack) + page;
+        g->context.uc_stack.ss_size = bytes - page;
+        g->context.uc_link = nullptr;
+        // makecontext only passes ints
+        const auto address = reinterpret_cast<uintptr_t>(g.get());
+        makecontext(&g->context,
+                    reinterpret_cast<void (*)()>(context_entry), 2,
+                    static_cast<uint32_t>(static_cast<uint64_t>(address) >>
+                                          32),
+                    static_cast<uint32_t>(address));
+#endif
+        green_thread *result = g.get();
+        std::lock_guard<std::mutex> lock(free_mutex);
+        all.push_back(std::move(g));
+        return result;
+    }
+
+    bool fiber_scheduler::spawn(std::function<void()> fn) {
+        if (!fn || !started.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        green_thread *g = make_green();
+        if (!g) {
+            return false;
+        }
+        g->fn = std::move(fn);
+        live.fetch_add(1, std::memory_order_relaxed);
+        push(g);
+        return true;
+    }
+
+    void fiber_scheduler::push(green_thread *g) {
+        if (carrier *c = this_carrier(); c && c->owner == this) {
+            c->deque.push(g);
+            wake();
+        } else {
+            requeue(g);
+        }
+    }
+
+    // FIFO, unlike the deque's own end: the fiber runs after every fiber
+    // that was ready before it
+    void fiber_scheduler::requeue(green_thread *g) {
+        {
+            std::lock_guard<std::mutex> lock(inject_mutex);
+            inject.push_back(g);
+            inject_size.fetch_add(1, std::memory_order_release);
+        }
+        wake();
+    }
+
+    void fiber_scheduler::wake() {
+        // pairs with the sleepers/epoch check in carrier_loop
+        epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_seq_cst)) {
+            {
+                std::lock_guard<std::mutex> lock(park_mutex);
+            }
+            park_cv.notify_one();
+        }
+    }
+
+    fiber_scheduler::green_thread *fiber_scheduler::pop_inject() {
+        if (!inject_size.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(inject_mutex);
+        if (inject.empty()) {
+            return nullptr;
+        }
+        green_thread *g = inject.front();
+        inject.pop_front();
+        inject_size.fetch_sub(1, std::memory_order_relaxed);
+        return g;
+    }
+
+    task *fiber_scheduler::find(carrier &self) {
+        if (++self.ticks % INJECT_EVERY == 0) {
+            if (task *t = pop_inject()) {
+                return t;
+            }
+        }
+        if (task *t = self.deque.pop()) {
+            return t;
+        }
+        if (task *t = pop_inject()) {
+            return t;
+        }
+        const size_t count = started.load(std::memory_order_acquire);
+        if (!count) {
+            return nullptr;
+        }
+        const size_t start = next_random(self.seed) % count;
+        for (size_t i = 0; i < count; ++i) {
+            carrier *victim = carriers[(start + i) % count].get();
+            if (victim == &self) {
+                continue;
+            }
+            if (task *t = victim->deque.steal()) {
+                return t;
+            }
+        }
+        return nullptr;
+    }
+
+    void fiber_scheduler::carrier_loop(carrier &self) {
+        local = &self;
+#ifdef _WIN32
+        self.context = fibers.thread_to_fiber(nullptr);
+        if (!self.context) {
+            local = nullptr;
+            return;
+        }
+#endif
+        while (true) {
+            const uint64_t seen = epoch.load(std::memory_order_seq_cst);
+            task *t = nullptr;
+            for (uint32_t i = 0; i < SPIN_ROUNDS && !t; ++i) {
+                t = find(self);
+                if (!t && i) {
+                    std::this_thread::yield();
+                }
+            }
+            if (t) {
+                t->run();
+                continue;
+            }
+            if (stopping.load(std::memory_order_seq_cst)) {
+                break;
+            }
+            std::unique_lock<std::mutex> lock(park_mutex);
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            while (epoch.load(std::memory_order_seq_cst) == seen) {
+                park_cv.wait(lock);
+            }
+            sleepers.fetch_sub(1, std::memory_order_seq_cst);
+        }
+#ifdef _WIN32
+        fibers.fiber_to_thread();
+#endif
+        local = nullptr;
+    }
+
+    void fiber_scheduler::resume(green_thread *g) {
+        carrier *self = this_carrier();
+        self->running = g;
+#ifdef _WIN32
+        fibers.switch_to_fiber(g->context);
+#else
+        swapcontext(&self->context, &g->context);
+#endif
+        self->running = nullptr;
+        // The fiber is fully switched out now; only from here may another
+        // carrier pick it up.
+        switch (g->action) {
+        case ACTION_YIELD:
+            // back of the line; the deque would hand it straight back
+            requeue(g);
+            break;
+        case ACTION_PARK: {
+            uint32_t expected = STATE_RUNNING;
+            if (!g->state.compare_exchange_strong(expected, STATE_PARKED,
+                                                  std::memory_order_acq_rel)) {
+                // unparked before it got here
+                push(g);
+            }
+            break;
+        }
+        default:
+            retire(g);
+            break;
+        }
+    }
+
+    void fiber_scheduler::retire(green_thread *g) {
+        {
+            std::lock_guard<std::mutex> lock(free_mutex);
+            free_list.push_back(g);
+        }
+        if (live.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(idle_mutex);
+            idle_cv.notify_all();
+        }
+    }
+
+    void fiber_scheduler::switch_out(const uint32_t action) {
+        carrier *c = this_carrier();
+        green_thread *g = c->running;
+        g->action = action;
+#ifdef _WIN32
+        c->owner->fibers.switch_to_fiber(c->context);
+#else
+        swapcontext(&g->context, &c->context);
+#endif
+    }
+
+    void fiber_scheduler::entry(green_thread *g) {
+        // a finished fiber stays suspended here until spawn() hands it
+        // the next function
+        while (true) {
+            try {
+                g->fn();
+            } catch (...) {
+                std::terminate();
+            }
+            g->fn = nullptr;
+            switch_out(ACTION_FINISH);
+        }
+    }
+
+#ifdef _WIN32
+    void __stdcall fiber_scheduler::fiber_entry(void *param) {
+        entry(static_cast<green_thread *>(param));
+    }
+#else
+    void fiber_scheduler::context_entry(const uint32_t high,
+                                        const uint32_t low) {
+        const uint64_t address = static_cast<uint64_t>(high) << 32 | low;
+        entry(reinterpret_cast<green_thread *>(
+                static_cast<uintptr_t>(address)));
+    }
+#endif
+
+    void fiber_scheduler::yield() {
+        if (!in_fiber()) {
+            std::this_thread::yield();
+            return;
+        }
+        switch_out(ACTION_YIELD);
+    }
+
+    void fiber_scheduler::park() {
+        green_thread *g = current();
+        if (!g) {
+            // a spurious return, callers loop on their condition
+            std::this_thread::yield();
+            return;
+        }
+        if (g->state.exchange(STATE_RUNNING, std::memory_order_acq_rel) ==
+            STATE_NOTIFIED) {
+            return;
+        }
+        switch_out(ACTION_PARK);
+        // an exchange rather than a store, so it acquires from every
+        // unpark() that left a permit meanwhile
+        g->state.exchange(STATE_RUNNING, std::memory_order_acq_rel);
+    }
+
+    void fiber_scheduler::unpark(green_thread *g) {
+        if (!g) {
+            return;
+        }
+        if (g->state.exchange(STATE_NOTIFIED, std::memory_order_acq_rel) ==
+            STATE_PARKED) {
+            push(g);
+        }
+    }
+
+    void fiber_scheduler::sleep_for(const std::chrono::milliseconds delay) {
+        green_thread *g = current();
+        if (!g) {
+            std::this_thread::sleep_for(delay);
+            return;
+        }
+        fiber_scheduler *owner = g->owner;
+        std::call_once(owner->timers_started, [owner] {
+            owner->timers_running.store(owner->timers.start(),
+                                        std::memory_order_release);
+        });
+        if (!owner->timers_running.load(std::memory_order_acquire)) {
+            std::this_thread::sleep_for(delay);
+            return;
+        }
+        std::atomic<bool> expired{false};
+        owner->timers.add(delay, [flag = &expired, owner, g] {
+            // the sleeper may return as soon as the flag is set, the flag
+            // is not touched after that
+            flag->store(true, std::memory_order_release);
+            owner->unpark(g);
+        });
+        while (!expired.load(std::memory_order_acquire)) {
+            park();
+        }
+    }
+
+    scheduler &fiber_scheduler::offload() {
+        std::call_once(offload_started, [this] {
+            offload_pool = std::make_unique<scheduler>(
+                    started.load(std::memory_order_relaxed));
+        });
+        return *offload_pool;
+    }
+
+    void fiber_scheduler::wait() {
+        std::unique_lock<std::mutex> lock(idle_mutex);
+        idle_cv.wait(lock, [this] {
+            return !live.load(std::memory_order_acquire);
+        });
+    }
+
+    size_t fiber_scheduler::active() const {
+        return live.load(std::memory_order_relaxed);
+    }
+
+    uint32_t fiber_scheduler::size() const {
+        return started.load(std::memory_order_relaxed);
+    }
+
+    uint32_t fiber_scheduler::err_code() const {
+        return error_code;
+    }
+
+    std::string fiber_scheduler::err_string() const {
+#ifdef _WIN32
+        std::string result = helper::convert::err_string(error_code);
+#else
+        std::string result = std::strerror(static_cast<int>(error_code));
+#endif
+        return result;
+    }
+
+    fiber_event::fiber_event(fiber_scheduler &owner) : owner(&owner) {
+    }
+
+    void fiber_event::set() {
+        std::vector<fiber_scheduler::green_thread *> woken;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            is_set.store(true, std::memory_order_release);
+            generation.fetch_add(1, std::memory_order_release);
+            woken.swap(waiters);
+        }
+        for (auto *g : woken) {
+            owner->unpark(g);
+        }
+    }
+
+    void fiber_event::reset() {
+        is_set.store(false, std::memory_order_release);
+    }
+
+    void fiber_event::wait() {
+        if (is_set.load(std::memory_order_acquire)) {
+            return;
+        }
+        fiber_scheduler::green_thread *g = fiber_scheduler::current();
+        if (!g) {
+            while (!is_set.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            return;
+        }
+        uint64_t seen = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (is_set.load(std::memory_order_acquire)) {
+                return;
+            }
+            seen = generation.load(std::memory_order_relaxed);
+            waiters.push_back(g);
+        }
+        // a set() followed by reset() still releases this waiter
+        while (generation.load(std::memory_order_acquire) == seen) {
+            fiber_scheduler::park();
+        }
+    }
+} // namespace YanLib::sys
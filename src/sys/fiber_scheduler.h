@@ -0,0 +1,319 @@
+/* clang-format off */
+/*
+ * @file fiber_scheduler.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef FIBER_SCHEDULER_H
+#define FIBER_SCHEDULER_H
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "scheduler.h"
+#include "timer_wheel.h"
+#ifdef _WIN32
+#include "fiber.h"
+#else
+#include <ucontext.h>
+#endif
+
+namespace YanLib::sys {
+    // M:N green threads: fibers with stacks of their own, multiplexed over
+    // a few carrier threads. Each carrier runs the fibers in its work_deque
+    // and steals from the others when it runs dry. Fibers switch only at
+    // yield(), sleep_for(), park() and blocking(); a fiber put back in a
+    // queue is queued by its carrier after the switch away from it, so no
+    // other carrier can resume it half-saved. yield() requeues at the
+    // tail of the shared inject queue, behind every fiber already ready,
+    // so a fiber spinning on yield() lets the others run even on a single
+    // carrier. Windows switches through
+    // sys::fiber, elsewhere through ucontext.
+    class fiber_scheduler {
+    private:
+        // what a fiber asks of its carrier when it switches out
+        static constexpr uint32_t ACTION_YIELD = 0;
+        static constexpr uint32_t ACTION_PARK = 1;
+        static constexpr uint32_t ACTION_FINISH = 2;
+
+        // park permit
+        static constexpr uint32_t STATE_RUNNING = 0;
+        static constexpr uint32_t STATE_PARKED = 1;
+        static constexpr uint32_t STATE_NOTIFIED = 2;
+
+    public:
+        class green_thread : public task {
+        private:
+            friend class fiber_scheduler;
+
+            fiber_scheduler *owner = nullptr;
+            std::function<void()> fn = nullptr;
+            std::atomic<uint32_t> state{STATE_RUNNING};
+            uint32_t action = ACTION_YIELD;
+#ifdef _WIN32
+            void *context = nullptr;
+#else
+            ucontext_t context = {};
+            void *stack = nullptr;
+            size_t stack_bytes = 0;
+#endif
+
+        public:
+            void run() override;
+        };
+
+    private:
+        struct alignas(64) carrier {
+            fiber_scheduler *owner = nullptr;
+            uint32_t index = 0;
+            uint64_t seed = 0;
+            // finds so far, every INJECT_EVERY-th looks at inject first
+            uint32_t ticks = 0;
+            work_deque deque;
+            std::thread thread = {};
+            // the fiber switched to, null while in the carrier's own loop
+            green_thread *running = nullptr;
+#ifdef _WIN32
+            void *context = nullptr;
+#else
+            ucontext_t context = {};
+#endif
+        };
+
+        // fixed once the constructor has filled it, running carriers read it
+        std::vector<std::unique_ptr<carrier>> carriers = {};
+        // carriers whose thread started, a prefix of carriers
+        std::atomic<uint32_t> started{0};
+        size_t stack_size;
+        std::mutex inject_mutex = {};
+        std::deque<green_thread *> inject = {};
+        std::atomic<size_t> inject_size{0};
+        std::mutex park_mutex = {};
+        std::condition_variable park_cv = {};
+        std::atomic<uint64_t> epoch{0};
+        std::atomic<uint32_t> sleepers{0};
+        std::atomic<bool> stopping{false};
+        // fibers spawned and not finished yet
+        std::atomic<size_t> live{0};
+        std::mutex idle_mutex = {};
+        std::condition_variable idle_cv = {};
+        // finished fibers, stack and all, ready for the next spawn
+        std::mutex free_mutex = {};
+        std::vector<green_thread *> free_list = {};
+        std::vector<std::unique_ptr<green_thread>> all = {};
+        timer_wheel timers;
+        std::once_flag timers_started = {};
+        std::atomic<bool> timers_running{false};
+        std::unique_ptr<scheduler> offload_pool = nullptr;
+        std::once_flag offload_started = {};
+#ifdef _WIN32
+        fiber fibers = {};
+#endif
+        uint32_t error_code = 0;
+
+        static thread_local carrier *local;
+
+        static carrier *this_carrier();
+
+        static fiber_scheduler *current_owner();
+
+        void carrier_loop(carrier &self);
+
+        task *find(carrier &self);
+
+        green_thread *pop_inject();
+
+        void push(green_thread *g);
+
+        void requeue(green_thread *g);
+
+        void wake();
+
+        void resume(green_thread *g);
+
+        void retire(green_thread *g);
+
+        green_thread *make_green();
+
+        static void switch_out(uint32_t action);
+
+        static void entry(green_thread *g);
+
+#ifdef _WIN32
+        static void __stdcall fiber_entry(void *param);
+#else
+        static void context_entry(uint32_t high, uint32_t low);
+#endif
+
+        scheduler &offload();
+
+    public:
+        fiber_scheduler(const fiber_scheduler &other) = delete;
+
+        fiber_scheduler(fiber_scheduler &&other) = delete;
+
+        fiber_scheduler &operator=(const fiber_scheduler &other) = delete;
+
+        fiber_scheduler &operator=(fiber_scheduler &&other) = delete;
+
+        // 0 carriers starts one per hardware thread
+        explicit fiber_scheduler(uint32_t carriers = 0,
+                                 size_t stack_size = 64 * 1024);
+
+        // waits for every fiber to finish, then stops the carriers
+        ~fiber_scheduler();
+
+        // fn must not let an exception escape, that terminates
+        bool spawn(std::function<void()> fn);
+
+        // blocks the calling thread until no fiber is left
+        void wait();
+
+        [[nodiscard]] size_t active() const;
+
+        [[nodiscard]] uint32_t size() const;
+
+        [[nodiscard]] uint32_t err_code() const;
+
+        [[nodiscard]] std::string err_string() const;
+
+        // The calls below act on the fiber running on the calling thread
+        // and fall back to the plain thread equivalent outside one.
+
+        [[nodiscard]] static bool in_fiber();
+
+        [[nodiscard]] static green_thread *current();
+
+        static void yield();
+
+        static void sleep_for(std::chrono::milliseconds delay);
+
+        // Suspends until unpark(). A permit left by an unpark() that came
+        // first makes it return at once, and it may return spuriously, so
+        // callers wait in a loop on their own condition.
+        static void park();
+
+        void unpark(green_thread *g);
+
+        // Runs fn on a helper thread pool while the fiber is parked, so a
+        // blocking call (file, socket, YanLib I/O) leaves the carrier free
+        // for other fibers. Exceptions are passed back to the caller.
+        template <typename F>
+        static std::invoke_result_t<F> blocking(F &&fn);
+    };
+
+    // Manual-reset event for fibers; wait() parks the fiber, not the
+    // carrier thread.
+    class fiber_event {
+    private:
+        std::mutex mutex = {};
+        std::vector<fiber_scheduler::green_thread *> waiters = {};
+        fiber_scheduler *owner = nullptr;
+        std::atomic<bool> is_set{false};
+        std::atomic<uint64_t> generation{0};
+
+    public:
+        fiber_event(const fiber_event &other) = delete;
+
+        fiber_event(fiber_event &&other) = delete;
+
+        fiber_event &operator=(const fiber_event &other) = delete;
+
+        fiber_event &operator=(fiber_event &&other) = delete;
+
+        explicit fiber_event(fiber_scheduler &owner);
+
+        ~fiber_event() = default;
+
+        void set();
+
+        void reset();
+
+        void wait();
+    };
+
+    template <typename F>
+    std::invoke_result_t<F> fiber_scheduler::blocking(F &&fn) {
+        using result_type = std::invoke_result_t<F>;
+        if (!in_fiber()) {
+            return fn();
+        }
+        fiber_scheduler *owner = current_owner();
+        green_thread *self = current();
+        struct job : task {
+            F &fn;
+            fiber_scheduler *owner;
+            green_thread *waiter;
+            std::conditional_t<std::is_void_v<result_type>, bool,
+                               std::optional<result_type>>
+                    value = {};
+            std::exception_ptr error = nullptr;
+            std::atomic<bool> done{false};
+
+            job(F &fn, fiber_scheduler *owner, green_thread *waiter)
+                : fn(fn), owner(owner), waiter(waiter) {
+            }
+
+            void run() override {
+                try {
+                    if constexpr (std::is_void_v<result_type>) {
+                        fn();
+                    } else {
+                        value.emplace(fn());
+                    }
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                // the job lives on the fiber's stack, gone once done is
+                // seen; copy what unpark needs first
+                fiber_scheduler *o = owner;
+                green_thread *w = waiter;
+                done.store(true, std::memory_order_release);
+                o->unpark(w);
+            }
+        } work(fn, owner, self);
+        owner->offload().spawn(&work);
+        while (!work.done.load(std::memory_order_acquire)) {
+            park();
+        }
+        if (work.error) {
+            std::rethrow_exception(work.error);
+        }
+        if constexpr (!std::is_void_v<result_type>) {
+            return std::move(*work.value);
+        }
+    }
+} // namespace YanLib::sys
+#endif // FIBER_SCHEDULER_H
@@ -32,13 +32,13 @@
 #include <minwinbase.h>
 #include <string>
 #include <vector>
-#include "sync/rwlock.h"
+#include "sync/futex_rwlock.h"
 #include "sys.h"
 namespace YanLib::sys {
     class job {
     private:
         std::vector<HANDLE> job_handles = {};
-        sync::rwlock rwlock = {};
+        sync::futex_rwlock rwlock = {};
         uint32_t error_code = 0;
 
     public:
@@ -39,7 +39,7 @@
 #include <string>
 #include <unordered_map>
 #include "helper/convert.h"
-#include "sync/rwlock.h"
+#include "sync/futex_rwlock.h"
 #include "mem/mem.h"
 #include "sys.h"
 #pragma comment(lib, "ntdll.lib")
@@ -48,8 +48,8 @@ namespace YanLib::sys {
     private:
         std::vector<PROCESS_INFORMATION> proc_infos = {};
         std::vector<HANDLE> proc_handles = {};
-        sync::rwlock proc_info_rwlock = {};
-        sync::rwlock proc_handle_rwlock = {};
+        sync::futex_rwlock proc_info_rwlock = {};
+        sync::futex_rwlock proc_handle_rwlock = {};
         uint32_t error_code = 0;
 
         NTSTATUS nt_query_info_proc(HANDLE proc_handle,
@@ -131,6 +131,48 @@ namespace YanLib::sys {
         return true;
     }
 
+    uint32_t processor::numa_highest_node() {
+        unsigned long highest = 0;
+        if (!GetNumaHighestNodeNumber(&highest)) {
+            error_code = GetLastError();
+            return 0;
+        }
+        return highest;
+    }
+
+    uint16_t processor::numa_node() {
+        PROCESSOR_NUMBER processor_number = {};
+        GetCurrentProcessorNumberEx(&processor_number);
+        uint16_t node = 0;
+        if (!GetNumaProcessorNodeEx(&processor_number, &node)) {
+            error_code = GetLastError();
+            return 0;
+        }
+        return node;
+    }
+
+    bool processor::numa_node_mask(const uint16_t node,
+                                   GROUP_AFFINITY *affinity) {
+        if (!GetNumaNodeProcessorMaskEx(node, affinity)) {
+            error_code = GetLastError();
+            return false;
+        }
+        return true;
+    }
+
+    bool processor::numa_available_memory(const uint16_t node,
+                                          uint64_t *available_bytes) {
+        unsigned long long bytes = 0;
+        if (!GetNumaAvailableMemoryNodeEx(node, &bytes)) {
+            error_code = GetLastError();
+            return false;
+        }
+        if (available_bytes) {
+            *available_bytes = bytes;
+        }
+        return true;
+    }
+
     uint32_t processor::err_code() const {
         return error_code;
     }
@@ -75,6 +75,16 @@ namespace YanLib::sys {
                              uint32_t *buffer_length,
                              uint64_t *processor_idle_cycle_time);
 
+        // highest NUMA node number, 0 on machines without NUMA
+        uint32_t numa_highest_node();
+
+        // node of the processor the calling thread runs on
+        uint16_t numa_node();
+
+        bool numa_node_mask(uint16_t node, GROUP_AFFINITY *affinity);
+
+        bool numa_available_memory(uint16_t node, uint64_t *available_bytes);
+
         [[nodiscard]] uint32_t err_code() const;
 
         [[nodiscard]] std::string err_string() const;
@@ -0,0 +1,339 @@
+/* clang-format off */
+/*
+ * @file scheduler.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "scheduler.h"
+#include <functional>
+#include <system_error>
+#ifdef _WIN32
+#include <Windows.h>
+#include "helper/convert.h"
+#else
+#include <cstring>
+#endif
+
+namespace YanLib::sys {
+    namespace {
+        // scans for work before a worker parks
+        constexpr uint32_t SPIN_ROUNDS = 64;
+
+        uint64_t next_random(uint64_t &state) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        }
+    } // namespace
+
+    thread_local scheduler::worker *scheduler::local = nullptr;
+
+    work_deque::ring::ring(const int64_t capacity)
+        : capacity(capacity), slots(new std::atomic<task *>[capacity]()) {
+    }
+
+    task *work_deque::ring::get(const int64_t index) const {
+        return slots[index & (capacity - 1)].load(std::memory_order_relaxed);
+    }
+
+    void work_deque::ring::put(const int64_t index, task *value) const {
+        slots[index & (capacity - 1)].store(value, std::memory_order_relaxed);
+    }
+
+    work_deque::work_deque(int64_t capacity) {
+        // a power of two, so indices wrap with a mask
+        int64_t size = 16;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        rings.push_back(std::make_unique<ring>(size));
+        array.store(rings.back().get(), std::memory_order_relaxed);
+    }
+
+    work_deque::ring *
+    work_deque::grow(ring *old, const int64_t b, const int64_t t) {
+        auto bigger = std::make_unique<ring>(old->capacity * 2);
+        for (int64_t i = t; i < b; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        ring *result = bigger.get();
+        rings.push_back(std::move(bigger));
+        array.store(result, std::memory_order_release);
+        return result;
+    }
+
+    void work_deque::push(task *value) {
+        const int64_t b = bottom.load(std::memory_order_relaxed);
+        const int64_t t = top.load(std::memory_order_acquire);
+        ring *a = array.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1) {
+            a = grow(a, b, t);
+        }
+        a->put(b, value);
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    task *work_deque::pop() {
+        const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        ring *a = array.load(std::memory_order_relaxed);
+        // seq_cst store and load instead of the usual fence: a thief must
+        // not see the old bottom once the owner has read top
+        bottom.store(b, std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_seq_cst);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        task *value = a->get(b);
+        if (t == b) {
+            // the last one, race the thieves for it
+            if (!top.compare_exchange_strong(t, t + 1,
+                                             std::memory_order_seq_cst,
+                                             std::memory_order_relaxed)) {
+                value = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return value;
+    }
+
+    task *work_deque::steal() {
+        int64_t t = top.load(std::memory_order_seq_cst);
+        const int64_t b = bottom.load(std::memory_order_seq_cst);
+        if (t >= b) {
+            return nullptr;
+        }
+        ring *a = array.load(std::memory_order_acquire);
+        task *value = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return value;
+    }
+
+    bool work_deque::empty() const {
+        return bottom.load(std::memory_order_relaxed) <=
+                top.load(std::memory_order_relaxed);
+    }
+
+    size_t work_deque::size() const {
+        const int64_t b = bottom.load(std::memory_order_relaxed);
+        const int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+    scheduler::scheduler(uint32_t threads) {
+        if (!threads) {
+            threads = std::thread::hardware_concurrency();
+            threads = threads ? threads : 1;
+        }
+        workers.reserve(threads);
+        for (uint32_t i = 0; i < threads; ++i) {
+            auto w = std::make_unique<worker>();
+            w->owner = this;
+            w->index = i;
+            w->seed = 0x9E3779B97F4A7C15ULL * (i + 1);
+            workers.push_back(std::move(w));
+        }
+        // every worker exists before any of them starts stealing
+        for (uint32_t i = 0; i < threads; ++i) {
+            try {
+                workers[i]->thread =
+                        std::thread(&scheduler::worker_loop, this,
+                                    std::ref(*workers[i]));
+            } catch (const std::system_error &e) {
+                error_code = static_cast<uint32_t>(e.code().value());
+                // running workers may already be reading workers, so it
+                // keeps its size and thieves stop at started
+                break;
+            }
+            started.store(i + 1, std::memory_order_release);
+        }
+    }
+
+    scheduler::~scheduler() {
+        {
+            std::lock_guard<std::mutex> lock(park_mutex);
+            stopping.store(true, std::memory_order_seq_cst);
+            epoch.fetch_add(1, std::memory_order_seq_cst);
+        }
+        park_cv.notify_all();
+        for (auto &w : workers) {
+            if (w->thread.joinable()) {
+                w->thread.join();
+            }
+        }
+    }
+
+    scheduler::worker *scheduler::local_worker() const {
+        worker *w = local;
+        return w && w->owner == this ? w : nullptr;
+    }
+
+    bool scheduler::local_empty() const {
+        if (worker *w = local_worker()) {
+            return w->deque.empty();
+        }
+        return !inject_size.load(std::memory_order_relaxed);
+    }
+
+    void scheduler::spawn(task *t) {
+        if (!t) {
+            return;
+        }
+        if (!started.load(std::memory_order_relaxed)) {
+            t->run();
+            return;
+        }
+        if (worker *w = local_worker()) {
+            w->deque.push(t);
+        } else {
+            std::lock_guard<std::mutex> lock(inject_mutex);
+            inject.push_back(t);
+            inject_size.fetch_add(1, std::memory_order_release);
+        }
+        wake();
+    }
+
+    void scheduler::wake() {
+        // pairs with the sleepers/epoch check in worker_loop: either the
+        // sleeper sees the new epoch or we see the sleeper
+        epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_seq_cst)) {
+            {
+                std::lock_guard<std::mutex> lock(park_mutex);
+            }
+            park_cv.notify_one();
+        }
+    }
+
+    task *scheduler::pop_inject() {
+        if (!inject_size.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(inject_mutex);
+        if (inject.empty()) {
+            return nullptr;
+        }
+        task *t = inject.front();
+        inject.pop_front();
+        inject_size.fetch_sub(1, std::memory_order_relaxed);
+        return t;
+    }
+
+    task *scheduler::steal_from(worker *self, uint64_t &seed) {
+        const size_t count = started.load(std::memory_order_acquire);
+        if (!count) {
+            return nullptr;
+        }
+        const size_t start = next_random(seed) % count;
+        for (size_t i = 0; i < count; ++i) {
+            worker *victim = workers[(start + i) % count].get();
+            if (victim == self) {
+                continue;
+            }
+            if (task *t = victim->deque.steal()) {
+                return t;
+            }
+        }
+        return nullptr;
+    }
+
+    task *scheduler::find_task(worker *self) {
+        if (self) {
+            if (task *t = self->deque.pop()) {
+                return t;
+            }
+        }
+        if (task *t = pop_inject()) {
+            return t;
+        }
+        if (self) {
+            return steal_from(self, self->seed);
+        }
+        thread_local uint64_t seed =
+                0x2545F4914F6CDD1DULL ^
+                std::hash<std::thread::id>()(std::this_thread::get_id());
+        return steal_from(nullptr, seed);
+    }
+
+    void scheduler::worker_loop(worker &self) {
+        local = &self;
+        while (true) {
+            const uint64_t seen = epoch.load(std::memory_order_seq_cst);
+            task *t = nullptr;
+            for (uint32_t i = 0; i < SPIN_ROUNDS && !t; ++i) {
+                t = find_task(&self);
+                if (!t && i) {
+                    std::this_thread::yield();
+                }
+            }
+            if (t) {
+                t->run();
+                continue;
+            }
+            if (stopping.load(std::memory_order_seq_cst)) {
+                break;
+            }
+            std::unique_lock<std::mutex> lock(park_mutex);
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            while (epoch.load(std::memory_order_seq_cst) == seen) {
+                park_cv.wait(lock);
+            }
+            sleepers.fetch_sub(1, std::memory_order_seq_cst);
+        }
+        local = nullptr;
+    }
+
+    bool scheduler::run_one() {
+        if (!started.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        task *t = find_task(local_worker());
+        if (!t) {
+            return false;
+        }
+        t->run();
+        return true;
+    }
+
+    uint32_t scheduler::size() const {
+        return started.load(std::memory_order_relaxed);
+    }
+
+    uint32_t scheduler::err_code() const {
+        return error_code;
+    }
+
+    std::string scheduler::err_string() const {
+#ifdef _WIN32
+        std::string result = helper::convert::err_string(error_code);
+#else
+        std::string result = std::strerror(static_cast<int>(error_code));
+#endif
+        return result;
+    }
+} // namespace YanLib::sys
@@ -0,0 +1,319 @@
+/* clang-format off */
+/*
+ * @file scheduler.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace YanLib::sys {
+    // Unit of work for a scheduler. run() is called exactly once, on some
+    // worker, and must not throw; tasks that own themselves delete
+    // themselves at the end of run().
+    class task {
+    public:
+        virtual ~task() = default;
+
+        virtual void run() = 0;
+    };
+
+    // Chase-Lev deque: the owning worker pushes and pops at the bottom,
+    // any other thread steals from the top. Grows without bound; retired
+    // rings are kept until destruction since a thief may still read them.
+    class work_deque {
+    private:
+        struct ring {
+            int64_t capacity;
+            std::unique_ptr<std::atomic<task *>[]> slots;
+
+            explicit ring(int64_t capacity);
+
+            [[nodiscard]] task *get(int64_t index) const;
+
+            void put(int64_t index, task *value) const;
+        };
+
+        alignas(64) std::atomic<int64_t> top{0};
+        alignas(64) std::atomic<int64_t> bottom{0};
+        std::atomic<ring *> array;
+        std::vector<std::unique_ptr<ring>> rings = {};
+
+        ring *grow(ring *old, int64_t b, int64_t t);
+
+    public:
+        work_deque(const work_deque &other) = delete;
+
+        work_deque(work_deque &&other) = delete;
+
+        work_deque &operator=(const work_deque &other) = delete;
+
+        work_deque &operator=(work_deque &&other) = delete;
+
+        explicit work_deque(int64_t capacity = 256);
+
+        ~work_deque() = default;
+
+        // owner only
+        void push(task *value);
+
+        // owner only, newest first
+        task *pop();
+
+        // any thread, oldest first; nullptr when empty or lost a race
+        task *steal();
+
+        [[nodiscard]] bool empty() const;
+
+        [[nodiscard]] size_t size() const;
+    };
+
+    // Work-stealing scheduler on plain std::threads. Each worker has a
+    // work_deque; tasks submitted from a worker go to its own deque,
+    // others to a shared injection queue. Idle workers steal from random
+    // victims, spin briefly and then park until new work arrives.
+    class scheduler {
+    private:
+        struct alignas(64) worker {
+            scheduler *owner = nullptr;
+            uint32_t index = 0;
+            uint64_t seed = 0;
+            work_deque deque;
+            std::thread thread = {};
+        };
+
+        // the worker running on this thread, if any
+        static thread_local worker *local;
+
+        // fixed once the constructor has filled it, running workers read it
+        std::vector<std::unique_ptr<worker>> workers = {};
+        // workers whose thread started, a prefix of workers
+        std::atomic<uint32_t> started{0};
+        std::mutex inject_mutex = {};
+        std::deque<task *> inject = {};
+        std::atomic<size_t> inject_size{0};
+        std::mutex park_mutex = {};
+        std::condition_variable park_cv = {};
+        std::atomic<uint64_t> epoch{0};
+        std::atomic<uint32_t> sleepers{0};
+        std::atomic<bool> stopping{false};
+        uint32_t error_code = 0;
+
+        void worker_loop(worker &self);
+
+        task *find_task(worker *self);
+
+        task *pop_inject();
+
+        task *steal_from(worker *self, uint64_t &seed);
+
+        void wake();
+
+        [[nodiscard]] worker *local_worker() const;
+
+        [[nodiscard]] bool local_empty() const;
+
+        template <typename F>
+        class function_task : public task {
+        private:
+            F fn;
+
+        public:
+            explicit function_task(F &&fn) : fn(std::move(fn)) {
+            }
+
+            void run() override {
+                fn();
+                delete this;
+            }
+        };
+
+        template <typename F>
+        struct range_state {
+            F &fn;
+            size_t grain;
+            std::atomic<size_t> remaining;
+            std::atomic<bool> failed{false};
+            std::exception_ptr error = nullptr;
+        };
+
+        template <typename F>
+        void run_chunk(range_state<F> &state, size_t begin, size_t end);
+
+        template <typename F>
+        void run_range(range_state<F> &state, size_t begin, size_t end);
+
+    public:
+        scheduler(const scheduler &other) = delete;
+
+        scheduler(scheduler &&other) = delete;
+
+        scheduler &operator=(const scheduler &other) = delete;
+
+        scheduler &operator=(scheduler &&other) = delete;
+
+        // 0 starts one worker per hardware thread
+        explicit scheduler(uint32_t threads = 0);
+
+        // runs what is still queued, then joins the workers
+        ~scheduler();
+
+        // t must stay alive until its run() returns
+        void spawn(task *t);
+
+        template <typename F>
+        auto submit(F &&fn)
+                -> std::future<std::invoke_result_t<std::decay_t<F>>>;
+
+        // fn(i) for every i in [begin, end). Ranges are split lazily: a
+        // chunk of grain indices is run at a time and the upper half of
+        // what is left is handed out only once the local deque has been
+        // drained by thieves, so splitting follows actual demand. The
+        // calling thread takes part; the first exception is rethrown.
+        template <typename F>
+        void parallel_for(size_t begin, size_t end, F &&fn, size_t grain = 0);
+
+        // runs one queued task on the calling thread, false if none found
+        bool run_one();
+
+        // get() that keeps running tasks meanwhile, so it is safe to call
+        // from inside a task
+        template <typename T>
+        T wait(std::future<T> &future);
+
+        [[nodiscard]] uint32_t size() const;
+
+        [[nodiscard]] uint32_t err_code() const;
+
+        [[nodiscard]] std::string err_string() const;
+    };
+
+    template <typename F>
+    auto scheduler::submit(F &&fn)
+            -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using result_type = std::invoke_result_t<std::decay_t<F>>;
+        std::packaged_task<result_type()> job(std::forward<F>(fn));
+        std::future<result_type> future = job.get_future();
+        spawn(new function_task<std::packaged_task<result_type()>>(
+                std::move(job)));
+        return future;
+    }
+
+    template <typename F>
+    void scheduler::run_chunk(range_state<F> &state,
+                              size_t begin,
+                              const size_t end) {
+        if (!state.failed.load(std::memory_order_relaxed)) {
+            try {
+                for (; begin < end; ++begin) {
+                    state.fn(begin);
+                }
+            } catch (...) {
+                if (!state.failed.exchange(true)) {
+                    state.error = std::current_exception();
+                }
+            }
+        }
+    }
+
+    template <typename F>
+    void scheduler::run_range(range_state<F> &state,
+                              size_t begin,
+                              size_t end) {
+        size_t done = 0;
+        while (end - begin > state.grain) {
+            if (local_empty()) {
+                const size_t mid = begin + (end - begin) / 2;
+                auto half = [this, &state, mid, end] {
+                    run_range(state, mid, end);
+                };
+                spawn(new function_task<decltype(half)>(std::move(half)));
+                end = mid;
+                continue;
+            }
+            run_chunk(state, begin, begin + state.grain);
+            begin += state.grain;
+            done += state.grain;
+        }
+        run_chunk(state, begin, end);
+        done += end - begin;
+        // the halves split off above count for themselves; state may be
+        // gone once the last index is accounted for
+        state.remaining.fetch_sub(done, std::memory_order_acq_rel);
+    }
+
+    template <typename F>
+    void scheduler::parallel_for(const size_t begin,
+                                 const size_t end,
+                                 F &&fn,
+                                 size_t grain) {
+        if (begin >= end) {
+            return;
+        }
+        const size_t count = end - begin;
+        if (!grain) {
+            // small enough for stealing to even out uneven indices, big
+            // enough that the split checks stay off the profile
+            grain = count / (static_cast<size_t>(size() + 1) * 64);
+            grain = grain ? grain : 1;
+        }
+        range_state<std::remove_reference_t<F>> state{fn, grain, count};
+        run_range(state, begin, end);
+        while (state.remaining.load(std::memory_order_acquire)) {
+            if (!run_one()) {
+                std::this_thread::yield();
+            }
+        }
+        if (state.error) {
+            std::rethrow_exception(state.error);
+        }
+    }
+
+    template <typename T>
+    T scheduler::wait(std::future<T> &future) {
+        while (future.wait_for(std::chrono::seconds(0)) !=
+               std::future_status::ready) {
+            if (!run_one()) {
+                std::this_thread::yield();
+            }
+        }
+        return future.get();
+    }
+} // namespace YanLib::sys
+#endif // SCHEDULER_H
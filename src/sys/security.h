@@ -32,14 +32,14 @@
 #include <minwinbase.h>
 #include <string>
 #include <vector>
-#include "sync/rwlock.h"
+#include "sync/futex_rwlock.h"
 #include "sys.h"
 namespace YanLib::sys {
     class security {
     private:
         void *env = nullptr;
         std::vector<HANDLE> token_handles = {};
-        sync::rwlock rwlock = {};
+        sync::futex_rwlock rwlock = {};
         uint32_t error_code = 0;
 
         void cleanup();
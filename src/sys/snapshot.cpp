@@ -30,23 +30,47 @@
 #include "helper/convert.h"
 
 namespace YanLib::sys {
-    snapshot::~snapshot() {
-        cleanup();
-    }
-
-    void snapshot::cleanup() {
-        if (snapshot_handle != INVALID_HANDLE_VALUE) {
-            CloseHandle(snapshot_handle);
-            snapshot_handle = INVALID_HANDLE_VALUE;
+    namespace {
+        // Returns the published table, building and publishing it if there
+        // is none yet. A failed (empty) build is not published so the next
+        // lookup tries again. Caller is inside a read section.
+        template <typename Table, typename Build>
+        const Table *view(sync::rcu_ptr<Table> &ptr, Build &&build) {
+            static const Table empty{};
+            std::unique_ptr<Table> built;
+            while (true) {
+                if (const Table *current = ptr.read()) {
+                    return current;
+                }
+                if (!built) {
+                    built = build();
+                }
+                if (built->entries.empty()) {
+                    return &empty;
+                }
+                const Table *raw = built.get();
+                if (ptr.publish_if_empty(built)) {
+                    return raw;
+                }
+            }
         }
-    }
 
-    std::vector<PROCESSENTRY32W> snapshot::ls_procs(const uint32_t pid) {
-        if (!procs.empty()) {
-            return procs;
+        // readers keep the old table until the new one is in place
+        template <typename Table>
+        void republish(sync::rcu_ptr<Table> &ptr,
+                       std::unique_ptr<Table> built) {
+            if (built->entries.empty()) {
+                built.reset();
+            }
+            ptr.publish(std::move(built));
         }
-        cleanup();
+    } // namespace
+
+    std::unique_ptr<snapshot::proc_table>
+    snapshot::build_procs(const uint32_t pid) {
+        auto result = std::make_unique<proc_table>();
         PROCESSENTRY32W pe = {sizeof(PROCESSENTRY32W)};
+        HANDLE snapshot_handle = INVALID_HANDLE_VALUE;
         do {
             snapshot_handle = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, pid);
             if (snapshot_handle == INVALID_HANDLE_VALUE) {
@@ -57,61 +81,136 @@ namespace YanLib::sys {
                 error_code = GetLastError();
                 break;
             }
-            procs.push_back(pe);
-            while (Process32NextW(snapshot_handle, &pe)) {
-                procs.push_back(pe);
-            }
+            do {
+                result->entries.push_back(pe);
+                result->ids.insert(pe.th32ProcessID);
+            } while (Process32NextW(snapshot_handle, &pe));
         } while (false);
-        return procs;
+        if (snapshot_handle != INVALID_HANDLE_VALUE) {
+            CloseHandle(snapshot_handle);
+        }
+        return result;
     }
 
-    std::unordered_set<uint32_t> snapshot::ls_pids(const uint32_t pid) {
-        if (!pids.empty()) {
-            return pids;
-        }
-        if (!procs.empty()) {
-            for (const auto process : procs) {
-                pids.insert(process.th32ProcessID);
+    std::unique_ptr<snapshot::thread_table>
+    snapshot::build_threads(const uint32_t pid) {
+        auto result = std::make_unique<thread_table>();
+        THREADENTRY32 te = {sizeof(THREADENTRY32)};
+        HANDLE snapshot_handle = INVALID_HANDLE_VALUE;
+        do {
+            snapshot_handle = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, pid);
+            if (snapshot_handle == INVALID_HANDLE_VALUE) {
+                error_code = GetLastError();
+                break;
+            }
+            if (!Thread32First(snapshot_handle, &te)) {
+                error_code = GetLastError();
+                break;
             }
-            return pids;
+            do {
+                result->entries.push_back(te);
+                result->ids.insert(te.th32ThreadID);
+            } while (Thread32Next(snapshot_handle, &te));
+        } while (false);
+        if (snapshot_handle != INVALID_HANDLE_VALUE) {
+            CloseHandle(snapshot_handle);
         }
-        cleanup();
-        PROCESSENTRY32W pe = {sizeof(PROCESSENTRY32W)};
+        return result;
+    }
+
+    std::unique_ptr<snapshot::module_table>
+    snapshot::build_modules(const uint32_t pid) {
+        auto result = std::make_unique<module_table>();
+        MODULEENTRY32W me = {sizeof(MODULEENTRY32W)};
+        HANDLE snapshot_handle = INVALID_HANDLE_VALUE;
         do {
-            snapshot_handle = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, pid);
+            snapshot_handle = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE, pid);
             if (snapshot_handle == INVALID_HANDLE_VALUE) {
                 error_code = GetLastError();
                 break;
             }
-            if (!Process32FirstW(snapshot_handle, &pe)) {
+            if (!Module32FirstW(snapshot_handle, &me)) {
                 error_code = GetLastError();
                 break;
             }
-            pids.insert(pe.th32ProcessID);
-            while (Process32NextW(snapshot_handle, &pe)) {
-                pids.insert(pe.th32ProcessID);
+            do {
+                result->entries.push_back(me);
+                result->ids.insert(me.hModule);
+            } while (Module32NextW(snapshot_handle, &me));
+        } while (false);
+        if (snapshot_handle != INVALID_HANDLE_VALUE) {
+            CloseHandle(snapshot_handle);
+        }
+        return result;
+    }
+
+    std::unique_ptr<snapshot::heap_table>
+    snapshot::build_heaps(const uint32_t pid) {
+        auto result = std::make_unique<heap_table>();
+        HEAPLIST32 he = {sizeof(HEAPLIST32)};
+        HANDLE snapshot_handle = INVALID_HANDLE_VALUE;
+        do {
+            snapshot_handle =
+                    CreateToolhelp32Snapshot(TH32CS_SNAPHEAPLIST, pid);
+            if (snapshot_handle == INVALID_HANDLE_VALUE) {
+                error_code = GetLastError();
+                break;
             }
+            if (!Heap32ListFirst(snapshot_handle, &he)) {
+                error_code = GetLastError();
+                break;
+            }
+            do {
+                result->entries.push_back(he);
+                result->ids.insert(he.th32HeapID);
+            } while (Heap32ListNext(snapshot_handle, &he));
         } while (false);
-        return pids;
+        if (snapshot_handle != INVALID_HANDLE_VALUE) {
+            CloseHandle(snapshot_handle);
+        }
+        return result;
+    }
+
+    const snapshot::proc_table *snapshot::proc_view(const uint32_t pid) {
+        return view(procs, [this, pid] { return build_procs(pid); });
+    }
+
+    const snapshot::thread_table *snapshot::thread_view(const uint32_t pid) {
+        return view(threads, [this, pid] { return build_threads(pid); });
+    }
+
+    const snapshot::module_table *snapshot::module_view(const uint32_t pid) {
+        return view(modules, [this, pid] { return build_modules(pid); });
+    }
+
+    const snapshot::heap_table *snapshot::heap_view(const uint32_t pid) {
+        return view(heaps, [this, pid] { return build_heaps(pid); });
+    }
+
+    std::vector<PROCESSENTRY32W> snapshot::ls_procs(const uint32_t pid) {
+        sync::rcu_guard guard;
+        return proc_view(pid)->entries;
+    }
+
+    std::unordered_set<uint32_t> snapshot::ls_pids(const uint32_t pid) {
+        sync::rcu_guard guard;
+        return proc_view(pid)->ids;
     }
 
     void snapshot::refresh_procs() {
-        procs.clear();
-        pids.clear();
+        // the process list is system wide, so it is rebuilt right away
+        republish(procs, build_procs(0));
     }
 
     bool snapshot::pid_exists(const uint32_t pid) {
-        if (pids.empty()) {
-            ls_pids();
-        }
-        return pids.find(pid) != pids.end();
+        sync::rcu_guard guard;
+        const auto &ids = proc_view()->ids;
+        return ids.find(pid) != ids.end();
     }
 
     uint32_t snapshot::get_ppid(const uint32_t pid) {
-        if (procs.empty()) {
-            ls_procs();
-        }
-        for (const auto process : procs) {
+        sync::rcu_guard guard;
+        for (const auto &process : proc_view()->entries) {
             if (process.th32ProcessID == pid) {
                 return process.th32ParentProcessID;
             }
@@ -120,10 +219,8 @@ namespace YanLib::sys {
     }
 
     PROCESSENTRY32W snapshot::find_proc(const uint32_t pid) {
-        if (procs.empty()) {
-            ls_procs();
-        }
-        for (const auto process : procs) {
+        sync::rcu_guard guard;
+        for (const auto &process : proc_view()->entries) {
             if (process.th32ProcessID == pid) {
                 return process;
             }
@@ -135,11 +232,10 @@ namespace YanLib::sys {
         if (!proc_name || wcslen(proc_name) == 0) {
             return {};
         }
-        if (procs.empty()) {
-            ls_procs();
-        }
-        for (const auto process : procs) {
-            if (helper::string::strstri(process.szExeFile, proc_name)) {
+        const helper::istr_needle needle(proc_name);
+        sync::rcu_guard guard;
+        for (const auto &process : proc_view()->entries) {
+            if (needle.is_in(process.szExeFile)) {
                 return process;
             }
         }
@@ -147,76 +243,29 @@ namespace YanLib::sys {
     }
 
     std::vector<THREADENTRY32> snapshot::ls_threads(const uint32_t pid) {
-        if (!threads.empty()) {
-            return threads;
-        }
-        cleanup();
-        THREADENTRY32 te = {sizeof(THREADENTRY32)};
-        do {
-            snapshot_handle = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, pid);
-            if (snapshot_handle == INVALID_HANDLE_VALUE) {
-                error_code = GetLastError();
-                break;
-            }
-            if (!Thread32First(snapshot_handle, &te)) {
-                error_code = GetLastError();
-                break;
-            }
-            threads.push_back(te);
-            while (Thread32Next(snapshot_handle, &te)) {
-                threads.push_back(te);
-            }
-        } while (false);
-        return threads;
+        sync::rcu_guard guard;
+        return thread_view(pid)->entries;
     }
 
     std::unordered_set<uint32_t> snapshot::ls_thread_ids(const uint32_t pid) {
-        if (!thread_ids.empty()) {
-            return thread_ids;
-        }
-        if (!threads.empty()) {
-            for (const auto thread : threads) {
-                thread_ids.insert(thread.th32ThreadID);
-            }
-            return thread_ids;
-        }
-        cleanup();
-        THREADENTRY32 te = {sizeof(THREADENTRY32)};
-        do {
-            snapshot_handle = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, pid);
-            if (snapshot_handle == INVALID_HANDLE_VALUE) {
-                error_code = GetLastError();
-                break;
-            }
-            if (!Thread32First(snapshot_handle, &te)) {
-                error_code = GetLastError();
-                break;
-            }
-            thread_ids.insert(te.th32ThreadID);
-            while (Thread32Next(snapshot_handle, &te)) {
-                thread_ids.insert(te.th32ThreadID);
-            }
-        } while (false);
-        return thread_ids;
+        sync::rcu_guard guard;
+        return thread_view(pid)->ids;
     }
 
     void snapshot::refresh_threads() {
-        threads.clear();
-        thread_ids.clear();
+        // TH32CS_SNAPTHREAD ignores the pid, rebuilt right away as above
+        republish(threads, build_threads(0));
     }
 
     bool snapshot::tid_exists(uint32_t tid) {
-        if (thread_ids.empty()) {
-            ls_thread_ids();
-        }
-        return thread_ids.find(tid) != thread_ids.end();
+        sync::rcu_guard guard;
+        const auto &ids = thread_view()->ids;
+        return ids.find(tid) != ids.end();
     }
 
     uint32_t snapshot::tid_to_pid(uint32_t tid) {
-        if (threads.empty()) {
-            ls_threads();
-        }
-        for (const auto thread : threads) {
+        sync::rcu_guard guard;
+        for (const auto &thread : thread_view()->entries) {
             if (thread.th32ThreadID == tid) {
                 return thread.th32OwnerProcessID;
             }
@@ -225,10 +274,8 @@ namespace YanLib::sys {
     }
 
     THREADENTRY32 snapshot::find_thread(uint32_t tid) {
-        if (threads.empty()) {
-            ls_threads();
-        }
-        for (const auto thread : threads) {
+        sync::rcu_guard guard;
+        for (const auto &thread : thread_view()->entries) {
             if (thread.th32ThreadID == tid) {
                 return thread;
             }
@@ -237,11 +284,9 @@ namespace YanLib::sys {
     }
 
     std::vector<THREADENTRY32> snapshot::find_threads(const uint32_t pid) {
-        if (threads.empty()) {
-            ls_threads();
-        }
         std::vector<THREADENTRY32> result;
-        for (auto thread : threads) {
+        sync::rcu_guard guard;
+        for (const auto &thread : thread_view()->entries) {
             if (thread.th32OwnerProcessID == pid) {
                 result.push_back(thread);
             }
@@ -250,75 +295,30 @@ namespace YanLib::sys {
     }
 
     std::vector<MODULEENTRY32W> snapshot::ls_modules(const uint32_t pid) {
-        if (!modules.empty()) {
-            return modules;
-        }
-        cleanup();
-        MODULEENTRY32W me = {sizeof(MODULEENTRY32W)};
-        do {
-            snapshot_handle = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE, pid);
-            if (snapshot_handle == INVALID_HANDLE_VALUE) {
-                error_code = GetLastError();
-                break;
-            }
-            if (!Module32FirstW(snapshot_handle, &me)) {
-                error_code = GetLastError();
-                break;
-            }
-            modules.push_back(me);
-            while (Module32NextW(snapshot_handle, &me)) {
-                modules.push_back(me);
-            }
-        } while (false);
-        return modules;
+        sync::rcu_guard guard;
+        return module_view(pid)->entries;
     }
 
     std::unordered_set<HMODULE>
     snapshot::ls_module_handles(const uint32_t pid) {
-        if (!module_handles.empty()) {
-            return module_handles;
-        }
-        if (!modules.empty()) {
-            for (auto module : modules) {
-                module_handles.insert(module.hModule);
-            }
-            return module_handles;
-        }
-        cleanup();
-        MODULEENTRY32W me = {sizeof(MODULEENTRY32W)};
-        do {
-            snapshot_handle = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE, pid);
-            if (snapshot_handle == INVALID_HANDLE_VALUE) {
-                error_code = GetLastError();
-                break;
-            }
-            if (!Module32FirstW(snapshot_handle, &me)) {
-                error_code = GetLastError();
-                break;
-            }
-            module_handles.insert(me.hModule);
-            while (Module32NextW(snapshot_handle, &me)) {
-                module_handles.insert(me.hModule);
-            }
-        } while (false);
-        return module_handles;
+        sync::rcu_guard guard;
+        return module_view(pid)->ids;
     }
 
     void snapshot::refresh_modules() {
-        modules.clear();
-        module_handles.clear();
+        // per process, so rebuilt on the next lookup with its pid
+        modules.publish(nullptr);
     }
 
     MODULEENTRY32W snapshot::find_module(const wchar_t *proc_name) {
         if (!proc_name || wcslen(proc_name) == 0) {
             return {};
         }
-        if (modules.empty()) {
-            ls_modules();
-        }
-        for (const auto module : modules) {
-            if (helper::string::strstri(module.szModule, proc_name) ||
-                helper::string::strstri(module.szExePath, proc_name)) {
+        const helper::istr_needle needle(proc_name);
+        sync::rcu_guard guard;
+        for (const auto &module : module_view()->entries) {
+            if (needle.is_in(module.szModule) ||
+                needle.is_in(module.szExePath)) {
                 return module;
             }
         }
@@ -329,10 +329,8 @@ namespace YanLib::sys {
         if (!address) {
             return {};
         }
-        if (modules.empty()) {
-            ls_modules();
-        }
-        for (const auto module : modules) {
+        sync::rcu_guard guard;
+        for (const auto &module : module_view()->entries) {
             if (module.modBaseAddr == address) {
                 return module;
             }
@@ -341,71 +339,22 @@ namespace YanLib::sys {
     }
 
     std::vector<HEAPLIST32> snapshot::ls_heaps(const uint32_t pid) {
-        if (!heaps.empty()) {
-            return heaps;
-        }
-        cleanup();
-        HEAPLIST32 he = {sizeof(HEAPLIST32)};
-        do {
-            snapshot_handle =
-                    CreateToolhelp32Snapshot(TH32CS_SNAPHEAPLIST, pid);
-            if (snapshot_handle == INVALID_HANDLE_VALUE) {
-                error_code = GetLastError();
-                break;
-            }
-            if (!Heap32ListFirst(snapshot_handle, &he)) {
-                error_code = GetLastError();
-                break;
-            }
-            heaps.push_back(he);
-            while (Heap32ListNext(snapshot_handle, &he)) {
-                heaps.push_back(he);
-            }
-        } while (false);
-        return heaps;
+        sync::rcu_guard guard;
+        return heap_view(pid)->entries;
     }
 
     std::unordered_set<uintptr_t> snapshot::ls_heap_ids(const uint32_t pid) {
-        if (!heap_ids.empty()) {
-            return heap_ids;
-        }
-        if (!heaps.empty()) {
-            for (auto heap : heaps) {
-                heap_ids.insert(heap.th32HeapID);
-            }
-            return heap_ids;
-        }
-        cleanup();
-        HEAPLIST32 he = {sizeof(HEAPLIST32)};
-        do {
-            snapshot_handle =
-                    CreateToolhelp32Snapshot(TH32CS_SNAPHEAPLIST, pid);
-            if (snapshot_handle == INVALID_HANDLE_VALUE) {
-                error_code = GetLastError();
-                break;
-            }
-            if (!Heap32ListFirst(snapshot_handle, &he)) {
-                error_code = GetLastError();
-                break;
-            }
-            heap_ids.insert(he.th32HeapID);
-            while (Heap32ListNext(snapshot_handle, &he)) {
-                heap_ids.insert(he.th32HeapID);
-            }
-        } while (false);
-        return heap_ids;
+        sync::rcu_guard guard;
+        return heap_view(pid)->ids;
     }
 
     void snapshot::refresh_heaps() {
-        heaps.clear();
-        heap_ids.clear();
+        heaps.publish(nullptr);
     }
 
     HEAPLIST32 snapshot::find_heap(uintptr_t heap_id) {
-        if (heaps.empty()) {
-            ls_heaps();
-        }
-        for (const auto heap : heaps) {
+        sync::rcu_guard guard;
+        for (const auto &heap : heap_view()->entries) {
             if (heap.th32HeapID == heap_id) {
                 return heap;
             }
@@ -414,11 +363,9 @@ namespace YanLib::sys {
     }
 
     std::vector<HEAPLIST32> snapshot::find_heaps(const uint32_t pid) {
-        if (heaps.empty()) {
-            ls_heaps();
-        }
         std::vector<HEAPLIST32> result;
-        for (auto heap : heaps) {
+        sync::rcu_guard guard;
+        for (const auto &heap : heap_view()->entries) {
             if (heap.th32ProcessID == pid) {
                 result.push_back(heap);
             }
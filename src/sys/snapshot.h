@@ -32,25 +32,51 @@
 #include <minwindef.h>
 #include <handleapi.h>
 #include <winnt.h>
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <unordered_set>
 #include <string>
 #include "sys.h"
+#include "sync/rcu.h"
 namespace YanLib::sys {
+    // Lists are built once and published through rcu, so lookups from any
+    // number of threads read them without locking; a refresh swaps in a new
+    // list and frees the old one once no lookup can still see it.
     class snapshot {
     private:
-        HANDLE snapshot_handle = INVALID_HANDLE_VALUE;
-        std::vector<PROCESSENTRY32W> procs{};
-        std::unordered_set<uint32_t> pids{};
-        std::vector<THREADENTRY32> threads{};
-        std::unordered_set<uint32_t> thread_ids{};
-        std::vector<MODULEENTRY32W> modules{};
-        std::unordered_set<HMODULE> module_handles{};
-        std::vector<HEAPLIST32> heaps{};
-        std::unordered_set<uintptr_t> heap_ids{};
-        uint32_t error_code = 0;
-
-        void cleanup();
+        template <typename Entry, typename Id> struct table {
+            std::vector<Entry> entries{};
+            std::unordered_set<Id> ids{};
+        };
+
+        using proc_table = table<PROCESSENTRY32W, uint32_t>;
+        using thread_table = table<THREADENTRY32, uint32_t>;
+        using module_table = table<MODULEENTRY32W, HMODULE>;
+        using heap_table = table<HEAPLIST32, uintptr_t>;
+
+        sync::rcu_ptr<proc_table> procs{};
+        sync::rcu_ptr<thread_table> threads{};
+        sync::rcu_ptr<module_table> modules{};
+        sync::rcu_ptr<heap_table> heaps{};
+        std::atomic<uint32_t> error_code{0};
+
+        std::unique_ptr<proc_table> build_procs(uint32_t pid);
+
+        std::unique_ptr<thread_table> build_threads(uint32_t pid);
+
+        std::unique_ptr<module_table> build_modules(uint32_t pid);
+
+        std::unique_ptr<heap_table> build_heaps(uint32_t pid);
+
+        // inside a read section only, builds the list on first use
+        const proc_table *proc_view(uint32_t pid = 0);
+
+        const thread_table *thread_view(uint32_t pid = 0);
+
+        const module_table *module_view(uint32_t pid = 0);
+
+        const heap_table *heap_view(uint32_t pid = 0);
 
     public:
         snapshot(const snapshot &other) = delete;
@@ -63,7 +89,7 @@ namespace YanLib::sys {
 
         snapshot() = default;
 
-        ~snapshot();
+        ~snapshot() = default;
 
         std::vector<PROCESSENTRY32W> ls_procs(uint32_t pid = 0);
 
@@ -0,0 +1,170 @@
+/* clang-format off */
+/*
+ * @file task_graph.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "task_graph.h"
+#include <chrono>
+#include <thread>
+
+namespace YanLib::sys {
+    void task_graph::node::run() {
+        if (!graph->failed.load(std::memory_order_relaxed)) {
+            try {
+                if (fn) {
+                    fn();
+                }
+            } catch (...) {
+                if (!graph->failed.exchange(true)) {
+                    graph->error = std::current_exception();
+                }
+            }
+        }
+        graph->finish(*this);
+    }
+
+    void task_graph::finish(node &n) {
+        for (const node_id next : n.successors) {
+            node &succ = nodes[next];
+            if (succ.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                pool->spawn(&succ);
+            }
+        }
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            // run() returns only once it has seen done under the lock, so
+            // the graph outlives this block
+            std::lock_guard<std::mutex> lock(done_mutex);
+            done = true;
+            done_cv.notify_all();
+        }
+    }
+
+    task_graph::node_id task_graph::add(std::function<void()> fn) {
+        node &n = nodes.emplace_back();
+        n.graph = this;
+        n.fn = std::move(fn);
+        checked = false;
+        return static_cast<node_id>(nodes.size() - 1);
+    }
+
+    task_graph::node_id task_graph::add(std::function<void()> fn,
+                                        std::initializer_list<node_id> after) {
+        for (const node_id from : after) {
+            if (from >= nodes.size()) {
+                return invalid_node;
+            }
+        }
+        const node_id id = add(std::move(fn));
+        for (const node_id from : after) {
+            precede(from, id);
+        }
+        return id;
+    }
+
+    bool task_graph::precede(const node_id from, const node_id to) {
+        if (from >= nodes.size() || to >= nodes.size()) {
+            return false;
+        }
+        nodes[from].successors.push_back(to);
+        ++nodes[to].predecessors;
+        checked = false;
+        return true;
+    }
+
+    bool task_graph::check() {
+        if (checked) {
+            return acyclic;
+        }
+        // Kahn's algorithm; the roots are kept for run()
+        roots.clear();
+        std::vector<uint32_t> in_degree(nodes.size());
+        std::vector<node_id> order;
+        order.reserve(nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            in_degree[i] = nodes[i].predecessors;
+            if (!in_degree[i]) {
+                roots.push_back(static_cast<node_id>(i));
+                order.push_back(static_cast<node_id>(i));
+            }
+        }
+        for (size_t i = 0; i < order.size(); ++i) {
+            for (const node_id next : nodes[order[i]].successors) {
+                if (!--in_degree[next]) {
+                    order.push_back(next);
+                }
+            }
+        }
+        checked = true;
+        acyclic = order.size() == nodes.size();
+        return acyclic;
+    }
+
+    bool task_graph::run(scheduler &pool) {
+        if (!check()) {
+            return false;
+        }
+        if (nodes.empty()) {
+            return true;
+        }
+        this->pool = &pool;
+        failed.store(false, std::memory_order_relaxed);
+        error = nullptr;
+        for (auto &n : nodes) {
+            n.pending.store(n.predecessors, std::memory_order_relaxed);
+        }
+        done = false;
+        remaining.store(nodes.size(), std::memory_order_release);
+        for (const node_id id : roots) {
+            pool.spawn(&nodes[id]);
+        }
+        while (remaining.load(std::memory_order_acquire)) {
+            if (pool.run_one()) {
+                continue;
+            }
+            // nothing to help with, the rest is running elsewhere; wake up
+            // now and then in case new work turns up to help with
+            std::unique_lock<std::mutex> lock(done_mutex);
+            done_cv.wait_for(lock, std::chrono::microseconds(200),
+                             [this] { return done; });
+        }
+        // the last node may still be inside finish()
+        std::unique_lock<std::mutex> lock(done_mutex);
+        done_cv.wait(lock, [this] { return done; });
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return true;
+    }
+
+    void task_graph::clear() {
+        nodes.clear();
+        roots.clear();
+        checked = false;
+    }
+
+    size_t task_graph::size() const {
+        return nodes.size();
+    }
+} // namespace YanLib::sys
@@ -0,0 +1,115 @@
+/* clang-format off */
+/*
+ * @file task_graph.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef TASK_GRAPH_H
+#define TASK_GRAPH_H
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <vector>
+#include "scheduler.h"
+
+namespace YanLib::sys {
+    // Dependency graph of callbacks run on a scheduler. A node is
+    // scheduled the moment its last predecessor finishes. Nodes, edges
+    // and the per-run counters are allocated while the graph is built,
+    // so run() can be called again and again without allocating.
+    class task_graph {
+    public:
+        using node_id = uint32_t;
+
+        static constexpr node_id invalid_node = UINT32_MAX;
+
+    private:
+        class node : public task {
+        public:
+            task_graph *graph = nullptr;
+            std::function<void()> fn;
+            std::vector<node_id> successors = {};
+            uint32_t predecessors = 0;
+            std::atomic<uint32_t> pending{0};
+
+            void run() override;
+        };
+
+        // deque keeps node addresses stable while the graph grows
+        std::deque<node> nodes = {};
+        std::vector<node_id> roots = {};
+        scheduler *pool = nullptr;
+        std::atomic<size_t> remaining{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error = nullptr;
+        std::mutex done_mutex = {};
+        std::condition_variable done_cv = {};
+        bool done = false;
+        bool checked = false;
+        bool acyclic = false;
+
+        void finish(node &n);
+
+        bool check();
+
+    public:
+        task_graph(const task_graph &other) = delete;
+
+        task_graph(task_graph &&other) = delete;
+
+        task_graph &operator=(const task_graph &other) = delete;
+
+        task_graph &operator=(task_graph &&other) = delete;
+
+        task_graph() = default;
+
+        ~task_graph() = default;
+
+        node_id add(std::function<void()> fn);
+
+        // fn runs after every node in after
+        node_id add(std::function<void()> fn,
+                    std::initializer_list<node_id> after);
+
+        // to runs only once from has finished
+        bool precede(node_id from, node_id to);
+
+        // Runs every node once and returns when all have finished, helping
+        // the scheduler meanwhile, so a task may run a graph as well. The
+        // first exception a node throws is rethrown here; nodes that had
+        // not started yet are skipped. False, with nothing run, when the
+        // edges form a cycle. One run at a time per graph.
+        bool run(scheduler &pool);
+
+        void clear();
+
+        [[nodiscard]] size_t size() const;
+    };
+} // namespace YanLib::sys
+#endif // TASK_GRAPH_H
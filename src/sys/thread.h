@@ -35,15 +35,15 @@
 #include <minwinbase.h>
 #include <string>
 #include <vector>
-#include "sync/rwlock.h"
+#include "sync/futex_rwlock.h"
 #include "sys.h"
 namespace YanLib::sys {
     class thread {
     private:
         std::vector<std::pair<uint32_t, HANDLE>> thread_records = {};
-        sync::rwlock thread_record_rwlock = {};
+        sync::futex_rwlock thread_record_rwlock = {};
         std::vector<HANDLE> open_thread_handles = {};
-        sync::rwlock open_thread_record_rwlock = {};
+        sync::futex_rwlock open_thread_record_rwlock = {};
         uint32_t error_code = 0;
 
     public:
@@ -34,7 +34,7 @@
 #include <winnt.h>
 #include <string>
 #include <vector>
-#include "sync/rwlock.h"
+#include "sync/futex_rwlock.h"
 
 namespace YanLib::sys {
     class thread_pool {
@@ -46,10 +46,10 @@ namespace YanLib::sys {
         std::vector<TP_TIMER *> timers = {};
         std::vector<TP_IO *> ios = {};
         std::vector<TP_WAIT *> waiters = {};
-        sync::rwlock tasks_rwlock = {};
-        sync::rwlock timers_rwlock = {};
-        sync::rwlock ios_rwlock = {};
-        sync::rwlock waiters_rwlock = {};
+        sync::futex_rwlock tasks_rwlock = {};
+        sync::futex_rwlock timers_rwlock = {};
+        sync::futex_rwlock ios_rwlock = {};
+        sync::futex_rwlock waiters_rwlock = {};
         uint32_t error_code = 0;
 
         void cleanup();
@@ -0,0 +1,356 @@
+/* clang-format off */
+/*
+ * @file timer_wheel.cpp
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#include "timer_wheel.h"
+
+namespace YanLib::sys {
+    void timer_wheel::node::run() {
+        // a throw must not skip retire(): the node would stay Firing and
+        // the destructor would wait for it forever
+        try {
+            fn();
+        } catch (...) {
+        }
+        wheel->retire(*this);
+    }
+
+    timer_wheel::timer_wheel(scheduler *pool,
+                             const std::chrono::milliseconds tick)
+        : pool(pool),
+          tick_length(tick.count() > 0 ? tick : std::chrono::milliseconds(1)),
+          start_time(std::chrono::steady_clock::now()) {
+    }
+
+    timer_wheel::~timer_wheel() {
+        stop();
+        std::unique_lock<std::mutex> lock(mutex);
+        // callbacks already handed to the pool still point at their node
+        idle_cv.wait(lock, [this] { return !firing_count; });
+    }
+
+    bool timer_wheel::start() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running) {
+            return false;
+        }
+        running = true;
+        tick_thread = std::thread(&timer_wheel::tick_loop, this);
+        return true;
+    }
+
+    void timer_wheel::stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running) {
+                return;
+            }
+            running = false;
+        }
+        tick_cv.notify_all();
+        if (tick_thread.joinable()) {
+            tick_thread.join();
+        }
+    }
+
+    uint64_t
+    timer_wheel::to_ticks(const std::chrono::milliseconds delay) const {
+        // rounded up, a timer never fires early
+        const auto length = std::chrono::duration_cast<
+                std::chrono::steady_clock::duration>(delay);
+        if (length.count() <= 0) {
+            return 1;
+        }
+        return static_cast<uint64_t>((length.count() + tick_length.count() -
+                                      1) /
+                                     tick_length.count());
+    }
+
+    void timer_wheel::catch_up() {
+        // an idle tick thread stops counting, bring the wheel up to date
+        // before a new expiry is computed from it
+        if (!running || pending_count) {
+            return;
+        }
+        const uint64_t now = static_cast<uint64_t>(
+                (std::chrono::steady_clock::now() - start_time) / tick_length);
+        if (current < now) {
+            current = now;
+        }
+    }
+
+    timer_wheel::node *timer_wheel::find(const timer_id id) {
+        const auto index = static_cast<uint32_t>(id);
+        if (!index || index > nodes.size()) {
+            return nullptr;
+        }
+        node &n = nodes[index - 1];
+        if (n.generation != static_cast<uint32_t>(id >> 32) ||
+            n.state == TimerState::Free) {
+            return nullptr;
+        }
+        return &n;
+    }
+
+    void timer_wheel::place(node &n) {
+        constexpr uint64_t LIMIT = 1ULL << 32;
+        if (n.expires - current >= LIMIT) {
+            n.expires = current + LIMIT - 1;
+        }
+        const uint64_t delta = n.expires - current;
+        size_t slot = 0;
+        if (delta < ROOT_SLOTS) {
+            slot = n.expires & (ROOT_SLOTS - 1);
+        } else {
+            uint32_t level = 1;
+            while (level < LEVELS && delta >= 1ULL << (8 + 6 * level)) {
+                ++level;
+            }
+            slot = ROOT_SLOTS + (level - 1) * LEVEL_SLOTS +
+                    ((n.expires >> (8 + 6 * (level - 1))) &
+                     (LEVEL_SLOTS - 1));
+        }
+        n.slot = &slots[slot];
+        n.prev = nullptr;
+        n.next = slots[slot];
+        if (n.next) {
+            n.next->prev = &n;
+        }
+        slots[slot] = &n;
+        n.state = TimerState::Pending;
+        ++pending_count;
+    }
+
+    void timer_wheel::unlink(node &n) {
+        if (n.prev) {
+            n.prev->next = n.next;
+        } else {
+            *n.slot = n.next;
+        }
+        if (n.next) {
+            n.next->prev = n.prev;
+        }
+        n.prev = nullptr;
+        n.next = nullptr;
+        n.slot = nullptr;
+        --pending_count;
+    }
+
+    void timer_wheel::release(node &n, std::function<void()> &dead) {
+        // the callback is destroyed by the caller, outside the lock
+        dead = std::move(n.fn);
+        n.fn = nullptr;
+        n.state = TimerState::Free;
+        n.cancelled = false;
+        n.rearm = 0;
+        ++n.generation;
+        if (!n.generation) {
+            n.generation = 1;
+        }
+        free_nodes.push_back(&n);
+    }
+
+    timer_wheel::timer_id
+    timer_wheel::add(const std::chrono::milliseconds delay,
+                     std::function<void()> fn,
+                     const std::chrono::milliseconds period) {
+        if (!fn) {
+            return invalid_timer;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        node *n = nullptr;
+        if (!free_nodes.empty()) {
+            n = free_nodes.back();
+            free_nodes.pop_back();
+        } else {
+            n = &nodes.emplace_back();
+            n->wheel = this;
+            n->index = static_cast<uint32_t>(nodes.size());
+        }
+        n->fn = std::move(fn);
+        catch_up();
+        n->expires = current + to_ticks(delay);
+        n->period = period.count() > 0 ? to_ticks(period) : 0;
+        const bool was_idle = !pending_count;
+        place(*n);
+        if (was_idle) {
+            // the tick thread sleeps without a deadline while idle
+            tick_cv.notify_one();
+        }
+        return static_cast<timer_id>(n->generation) << 32 | n->index;
+    }
+
+    bool timer_wheel::cancel(const timer_id id) {
+        std::function<void()> dead;
+        std::lock_guard<std::mutex> lock(mutex);
+        node *n = find(id);
+        if (!n || n->cancelled) {
+            return false;
+        }
+        if (n->state == TimerState::Firing) {
+            // too late for this run, stops a periodic one repeating
+            if (!n->period && !n->rearm) {
+                return false;
+            }
+            n->cancelled = true;
+            return true;
+        }
+        unlink(*n);
+        release(*n, dead);
+        return true;
+    }
+
+    bool timer_wheel::reschedule(const timer_id id,
+                                 const std::chrono::milliseconds delay) {
+        std::lock_guard<std::mutex> lock(mutex);
+        node *n = find(id);
+        if (!n || n->cancelled) {
+            return false;
+        }
+        if (n->state == TimerState::Firing) {
+            n->rearm = to_ticks(delay);
+            return true;
+        }
+        unlink(*n);
+        catch_up();
+        n->expires = current + to_ticks(delay);
+        place(*n);
+        return true;
+    }
+
+    void timer_wheel::cascade(const uint32_t level, const uint32_t index) {
+        node **slot = &slots[ROOT_SLOTS + (level - 1) * LEVEL_SLOTS + index];
+        node *list = *slot;
+        *slot = nullptr;
+        while (list) {
+            node *next = list->next;
+            --pending_count;
+            place(*list);
+            list = next;
+        }
+    }
+
+    timer_wheel::node *timer_wheel::step() {
+        ++current;
+        const auto index = static_cast<uint32_t>(current & (ROOT_SLOTS - 1));
+        if (!index) {
+            // the root wrapped: pull the next slot of each level down, as
+            // far up as levels wrap along with it
+            for (uint32_t level = 1; level <= LEVELS; ++level) {
+                const auto i = static_cast<uint32_t>(
+                        (current >> (8 + 6 * (level - 1))) &
+                        (LEVEL_SLOTS - 1));
+                cascade(level, i);
+                if (i) {
+                    break;
+                }
+            }
+        }
+        node *fired = slots[index];
+        slots[index] = nullptr;
+        for (node *n = fired; n; n = n->next) {
+            n->state = TimerState::Firing;
+            n->slot = nullptr;
+            --pending_count;
+            ++firing_count;
+        }
+        return fired;
+    }
+
+    void timer_wheel::fire(node *fired) {
+        while (fired) {
+            // run() may put the node straight back into a slot
+            node *next = fired->next;
+            fired->prev = nullptr;
+            fired->next = nullptr;
+            if (pool) {
+                pool->spawn(fired);
+            } else {
+                fired->run();
+            }
+            fired = next;
+        }
+    }
+
+    void timer_wheel::retire(node &n) {
+        std::function<void()> dead;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (n.cancelled) {
+            release(n, dead);
+        } else if (n.rearm || n.period) {
+            catch_up();
+            n.expires = current + (n.rearm ? n.rearm : n.period);
+            n.rearm = 0;
+            place(n);
+        } else {
+            release(n, dead);
+        }
+        if (!--firing_count) {
+            idle_cv.notify_all();
+        }
+    }
+
+    void timer_wheel::advance(uint64_t ticks) {
+        while (ticks--) {
+            node *fired = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                fired = step();
+            }
+            fire(fired);
+        }
+    }
+
+    void timer_wheel::tick_loop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (running) {
+            const uint64_t target = static_cast<uint64_t>(
+                    (std::chrono::steady_clock::now() - start_time) /
+                    tick_length);
+            if (!pending_count) {
+                // nothing can fire; empty slots need no cascading, so the
+                // idle ticks are skipped by catch_up() later on
+                tick_cv.wait(lock, [this] {
+                    return !running || pending_count;
+                });
+                continue;
+            }
+            if (current < target) {
+                node *fired = step();
+                lock.unlock();
+                fire(fired);
+                lock.lock();
+                continue;
+            }
+            tick_cv.wait_until(lock, start_time + tick_length * (current + 1));
+        }
+    }
+
+    size_t timer_wheel::pending() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return pending_count;
+    }
+} // namespace YanLib::sys
@@ -0,0 +1,164 @@
+/* clang-format off */
+/*
+ * @file timer_wheel.h
+ * @date 2026-10-19
+ * @license MIT License
+ *
+ * Copyright (c) 2025 BinRacer <native.lab@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* clang-format on */
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "scheduler.h"
+
+namespace YanLib::sys {
+    // Hierarchical timing wheel: 256 one-tick slots, then four levels of 64
+    // slots each covering 64 times the span of the one below (2^32 ticks
+    // in all, longer delays are clamped). Insert, cancel and reschedule
+    // are O(1) list operations; a level is redistributed downwards only
+    // when the level below wraps. Timers that fire are spawned onto the
+    // scheduler, or run on the ticking thread when there is none.
+    class timer_wheel {
+    public:
+        using timer_id = uint64_t;
+
+        static constexpr timer_id invalid_timer = 0;
+
+    private:
+        static constexpr uint32_t ROOT_SLOTS = 256;
+        static constexpr uint32_t LEVEL_SLOTS = 64;
+        static constexpr uint32_t LEVELS = 4;
+
+        enum class TimerState : uint8_t {
+            Free,
+            Pending,
+            Firing,
+        };
+
+        class node : public task {
+        public:
+            timer_wheel *wheel = nullptr;
+            node *prev = nullptr;
+            node *next = nullptr;
+            node **slot = nullptr;
+            std::function<void()> fn;
+            uint64_t expires = 0;
+            uint64_t period = 0;
+            // set by reschedule() while the callback runs
+            uint64_t rearm = 0;
+            uint32_t index = 0;
+            uint32_t generation = 1;
+            TimerState state = TimerState::Free;
+            bool cancelled = false;
+
+            void run() override;
+        };
+
+        scheduler *pool;
+        std::chrono::steady_clock::duration tick_length;
+        std::chrono::steady_clock::time_point start_time = {};
+        // ticks processed so far
+        uint64_t current = 0;
+        size_t pending_count = 0;
+        size_t firing_count = 0;
+        node *slots[ROOT_SLOTS + LEVELS * LEVEL_SLOTS] = {};
+        std::deque<node> nodes = {};
+        std::vector<node *> free_nodes = {};
+        mutable std::mutex mutex = {};
+        std::condition_variable tick_cv = {};
+        std::condition_variable idle_cv = {};
+        std::thread tick_thread = {};
+        bool running = false;
+
+        void catch_up();
+
+        node *find(timer_id id);
+
+        uint64_t to_ticks(std::chrono::milliseconds delay) const;
+
+        void place(node &n);
+
+        void unlink(node &n);
+
+        void release(node &n, std::function<void()> &dead);
+
+        void cascade(uint32_t level, uint32_t index);
+
+        node *step();
+
+        void fire(node *fired);
+
+        void retire(node &n);
+
+        void tick_loop();
+
+    public:
+        timer_wheel(const timer_wheel &other) = delete;
+
+        timer_wheel(timer_wheel &&other) = delete;
+
+        timer_wheel &operator=(const timer_wheel &other) = delete;
+
+        timer_wheel &operator=(timer_wheel &&other) = delete;
+
+        explicit timer_wheel(
+                scheduler *pool = nullptr,
+                std::chrono::milliseconds tick = std::chrono::milliseconds(1));
+
+        // stops ticking, drops pending timers and waits for running ones
+        ~timer_wheel();
+
+        // starts the thread that advances the wheel in real time
+        bool start();
+
+        void stop();
+
+        // fn runs once delay has passed, then every period if non-zero.
+        // Both are rounded up to whole ticks; the tick thread fires a
+        // timer within one tick of its deadline. An exception from fn is
+        // caught and dropped, a periodic timer keeps its period.
+        timer_id add(std::chrono::milliseconds delay,
+                     std::function<void()> fn,
+                     std::chrono::milliseconds period =
+                             std::chrono::milliseconds(0));
+
+        // false when the timer already fired (one-shot) or is unknown
+        bool cancel(timer_id id);
+
+        // moves the next expiry to delay from now
+        bool reschedule(timer_id id, std::chrono::milliseconds delay);
+
+        // Processes ticks by hand, for wheels driven by the caller's own
+        // loop instead of start().
+        void advance(uint64_t ticks = 1);
+
+        [[nodiscard]] size_t pending() const;
+    };
+} // namespace YanLib::sys
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "coro/io.h"
+#if defined(YANLIB_HAS_COROUTINES) && defined(_WIN32)
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+namespace coro = YanLib::coro;
+namespace sys = YanLib::sys;
+using std::chrono::milliseconds;
+
+namespace {
+    coro::task<bool> round_trip(coro::io_context &io,
+                                HANDLE file,
+                                const std::vector<uint8_t> &data) {
+        const coro::io_result wrote =
+                co_await io.write(file, data.data(),
+                                  static_cast<uint32_t>(data.size()), 100);
+        if (wrote.error || wrote.bytes != data.size()) {
+            co_return false;
+        }
+        std::vector<uint8_t> back(data.size());
+        const coro::io_result read =
+                co_await io.read(file, back.data(),
+                                 static_cast<uint32_t>(back.size()), 100);
+        co_return !read.error && read.bytes == data.size() && back == data;
+    }
+
+    coro::task<> read_pipe(coro::io_context &io,
+                           HANDLE pipe,
+                           char *buffer,
+                           std::atomic<uint32_t> &bytes,
+                           std::atomic<bool> &issued,
+                           std::atomic<bool> &done) {
+        issued = true;
+        const coro::io_result result = co_await io.read(pipe, buffer, 16, 0);
+        bytes = result.bytes;
+        done = true;
+    }
+} // namespace
+
+TEST(coro_io, file_round_trip) {
+    const std::filesystem::path path =
+            std::filesystem::temp_directory_path() / "yanlib_coro_io.bin";
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0,
+                              nullptr, CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED,
+                              nullptr);
+    ASSERT_NE(file, INVALID_HANDLE_VALUE);
+    {
+        sys::scheduler pool(2);
+        coro::executor ex(pool);
+        coro::io_context io(ex);
+        // the port exists before the pump runs
+        EXPECT_TRUE(io.attach(file));
+        ASSERT_TRUE(io.start());
+        EXPECT_FALSE(io.start());
+        std::vector<uint8_t> data(70000);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<uint8_t>(i * 31);
+        }
+        EXPECT_TRUE(coro::sync_wait(round_trip(io, file, data)));
+        io.stop();
+    }
+    CloseHandle(file);
+    std::filesystem::remove(path);
+}
+
+TEST(coro_io, in_flight_across_stop) {
+    const std::wstring name = L"\\\\.\\pipe\\yanlib_coro_io_" +
+            std::to_wstring(GetCurrentProcessId());
+    HANDLE server = CreateNamedPipeW(
+            name.c_str(), PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED,
+            PIPE_TYPE_BYTE | PIPE_WAIT, 1, 64, 64, 0, nullptr);
+    ASSERT_NE(server, INVALID_HANDLE_VALUE);
+    HANDLE client = CreateFileW(name.c_str(), GENERIC_WRITE, 0, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    ASSERT_NE(client, INVALID_HANDLE_VALUE);
+    char buffer[16] = {};
+    std::atomic<uint32_t> bytes{0};
+    std::atomic<bool> issued{false};
+    std::atomic<bool> done{false};
+    {
+        sys::scheduler pool(2);
+        coro::executor ex(pool);
+        coro::io_context io(ex);
+        ASSERT_TRUE(io.attach(server));
+        ASSERT_TRUE(io.start());
+        ex.spawn(read_pipe(io, server, buffer, bytes, issued, done));
+        while (!issued) {
+            std::this_thread::yield();
+        }
+        std::this_thread::sleep_for(milliseconds(20));
+        io.stop();
+        // completes while nothing pumps the port
+        DWORD written = 0;
+        ASSERT_TRUE(WriteFile(client, "YanLib", 6, &written, nullptr));
+        std::this_thread::sleep_for(milliseconds(20));
+        EXPECT_FALSE(done);
+        // the same port, so the queued completion is picked up now
+        ASSERT_TRUE(io.start());
+        for (int i = 0; i < 1000 && !done; ++i) {
+            std::this_thread::sleep_for(milliseconds(5));
+        }
+        EXPECT_TRUE(done);
+        EXPECT_EQ(bytes.load(), 6u);
+        EXPECT_EQ(std::memcmp(buffer, "YanLib", 6), 0);
+    }
+    CloseHandle(client);
+    CloseHandle(server);
+}
+#endif
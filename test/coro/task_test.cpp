@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "coro/executor.h"
+#ifdef YANLIB_HAS_COROUTINES
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+namespace coro = YanLib::coro;
+namespace sys = YanLib::sys;
+using std::chrono::milliseconds;
+
+namespace {
+    coro::task<int> value(const int v) {
+        co_return v;
+    }
+
+    coro::task<int> sum(const int n) {
+        int total = 0;
+        for (int i = 1; i <= n; ++i) {
+            total += co_await value(i);
+        }
+        co_return total;
+    }
+
+    coro::task<std::unique_ptr<std::string>> boxed() {
+        co_return std::make_unique<std::string>("YanLib");
+    }
+
+    coro::task<> fail() {
+        co_await value(1);
+        throw std::runtime_error("coroutine failed");
+    }
+
+    coro::task<std::thread::id> hop(coro::executor &ex) {
+        co_await ex.schedule();
+        co_return std::this_thread::get_id();
+    }
+
+    coro::task<int64_t> nap(coro::executor &ex, const milliseconds delay) {
+        const auto begin = std::chrono::steady_clock::now();
+        co_await ex.sleep_for(delay);
+        co_return std::chrono::duration_cast<milliseconds>(
+                std::chrono::steady_clock::now() - begin)
+                .count();
+    }
+} // namespace
+
+TEST(coro_task, chain) {
+    EXPECT_EQ(coro::sync_wait(sum(1000)), 500500);
+    EXPECT_EQ(*coro::sync_wait(boxed()), "YanLib");
+    EXPECT_THROW(coro::sync_wait(fail()), std::runtime_error);
+}
+
+TEST(coro_task, lazy) {
+    bool started = false;
+    // the lambda holds the captures, it has to outlive the coroutine
+    const auto body = [&]() -> coro::task<> {
+        started = true;
+        co_return;
+    };
+    auto t = body();
+    EXPECT_FALSE(started);
+    coro::sync_wait(std::move(t));
+    EXPECT_TRUE(started);
+}
+
+TEST(coro_executor, schedule_and_sleep) {
+    sys::scheduler pool(2);
+    coro::executor ex(pool);
+    EXPECT_NE(coro::sync_wait(hop(ex)), std::this_thread::get_id());
+    // within a tick of the deadline
+    EXPECT_GE(coro::sync_wait(nap(ex, milliseconds(20))), 19);
+}
+
+TEST(coro_executor, many_sleepers) {
+    sys::scheduler pool(4);
+    coro::executor ex(pool);
+    std::atomic<int> woke{0};
+    for (int i = 0; i < 10000; ++i) {
+        ex.spawn([](coro::executor &ex, std::atomic<int> &woke,
+                    const int i) -> coro::task<> {
+            co_await ex.sleep_for(milliseconds(1 + i % 20));
+            ++woke;
+        }(ex, woke, i));
+    }
+    for (int i = 0; i < 1000 && woke.load() < 10000; ++i) {
+        std::this_thread::sleep_for(milliseconds(5));
+    }
+    EXPECT_EQ(woke.load(), 10000);
+}
+#else
+// the build compiles this file as C++20; getting here means it did not
+TEST(coro_task, coroutines_enabled) {
+    FAIL() << "coro/task_test.cpp was compiled without coroutine support";
+}
+#endif
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include "helper/codepage.h"
+namespace helper = YanLib::helper;
+
+namespace {
+    std::u16string decode(const uint32_t code_page, const std::string &str) {
+        const size_t len =
+                helper::codepage::decode_length(code_page, str.data(),
+                                                str.size());
+        if (len == helper::codepage::npos) {
+            return u"<npos>";
+        }
+        std::u16string result(len, u'\0');
+        helper::codepage::decode(code_page, str.data(), str.size(),
+                                 result.data(), result.size());
+        return result;
+    }
+
+    std::string encode(const uint32_t code_page, const std::u16string &str) {
+        const size_t len =
+                helper::codepage::encode_length(code_page, str.data(),
+                                                str.size());
+        if (len == helper::codepage::npos) {
+            return "<npos>";
+        }
+        std::string result(len, '\0');
+        helper::codepage::encode(code_page, str.data(), str.size(),
+                                 result.data(), result.size());
+        return result;
+    }
+} // namespace
+
+TEST(helper_codepage, known_strings) {
+    const struct {
+        uint32_t code_page;
+        std::string bytes;
+        std::u16string text;
+    } cases[] = {
+            {936, "abc \xD6\xD0\xCE\xC4 \x80", u"abc 中文 €"},
+            {54936, "\xD6\xD0\xCE\xC4\xA2\xE3\x94\x39\xFC\x36",
+             u"中文€\U0001F600"},
+            {950, "\xA4\xA4\xA4\xE5!", u"中文!"},
+            {1252, "Gr\xFC\xDF\x65 \x80", u"Grüße €"},
+    };
+    for (const auto &c : cases) {
+        EXPECT_EQ(decode(c.code_page, c.bytes), c.text) << c.code_page;
+        EXPECT_EQ(encode(c.code_page, c.text), c.bytes) << c.code_page;
+    }
+    EXPECT_FALSE(helper::codepage::is_supported(65001));
+    EXPECT_TRUE(helper::codepage::is_supported(1258));
+}
+
+TEST(helper_codepage, strict) {
+    // 0x80 is the euro sign in code page 936 but not in GB18030
+    EXPECT_EQ(decode(54936, "\x80"), u"<npos>");
+    // truncated lead byte, undefined WIN1252 byte
+    EXPECT_EQ(decode(936, "\xD6"), u"<npos>");
+    EXPECT_EQ(decode(1252, "\x81"), u"<npos>");
+    // not in the code page, unpaired surrogate
+    EXPECT_EQ(encode(1252, u"中"), "<npos>");
+    EXPECT_EQ(encode(54936, std::u16string(1, u'\xD800')), "<npos>");
+    char buf[2];
+    EXPECT_EQ(helper::codepage::encode(936, u"中文", 2, buf, sizeof(buf)),
+              helper::codepage::npos);
+}
+
+TEST(helper_codepage, gb18030_round_trip) {
+    // GB18030 covers every code point, two or four bytes per character
+    std::u16string all;
+    for (uint32_t unit = 0; unit < 0x10000; ++unit) {
+        if (unit < 0xD800 || unit > 0xDFFF) {
+            all.push_back(static_cast<char16_t>(unit));
+        }
+    }
+    all.append(u"\U00010000\U0010FFFF");
+    const std::string bytes = encode(54936, all);
+    ASSERT_NE(bytes, "<npos>");
+    EXPECT_EQ(decode(54936, bytes), all);
+}
+
+TEST(helper_codepage, streaming) {
+    const std::string bytes = "ab\xD6\xD0\xCE\xC4\xA2\xE3\x94\x39\xFC\x36"
+                              "\xFF\xD6 c\xD6\xD0";
+    // 0xFF is never valid, 0xD6 loses its trail byte to the space
+    const std::u16string expected = u"ab中文€\U0001F600�� c中";
+    for (size_t chunk = 1; chunk <= 5; ++chunk) {
+        helper::codepage_decoder decoder(54936);
+        ASSERT_TRUE(decoder.is_ok());
+        std::u16string result;
+        char16_t buf[3];
+        for (size_t i = 0; i < bytes.size();) {
+            const size_t len = std::min(chunk, bytes.size() - i);
+            size_t consumed = 0;
+            const size_t written = decoder.decode(bytes.data() + i, len, buf,
+                                                  std::size(buf), &consumed);
+            result.append(buf, written);
+            i += consumed;
+        }
+        size_t written;
+        while ((written = decoder.finish(buf, std::size(buf))) != 0) {
+            result.append(buf, written);
+        }
+        EXPECT_EQ(result, expected) << chunk;
+    }
+
+    // a sequence cut off by the end of the input
+    helper::codepage_decoder decoder(936);
+    char16_t buf[4];
+    EXPECT_EQ(decoder.decode("a\xD6", 2, buf, std::size(buf)), 1);
+    EXPECT_EQ(decoder.finish(buf, std::size(buf)), 1);
+    EXPECT_EQ(buf[0], u'�');
+}
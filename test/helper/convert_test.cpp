@@ -0,0 +1,27 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "helper/convert.h"
+namespace helper = YanLib::helper;
+using helper::CodePage;
+
+TEST(helper_convert, utf8_round_trip) {
+    const std::string text = "abc \xC3\xA9 \xE4\xB8\xAD \xF0\x9F\x98\x80";
+    const std::wstring wide =
+            helper::convert::str_to_wstr(text, CodePage::UTF8);
+    EXPECT_EQ(wide, L"abc \u00E9 \u4E2D \U0001F600");
+    EXPECT_EQ(helper::convert::wstr_to_str(wide, CodePage::UTF8), text);
+    EXPECT_EQ(helper::convert::str_to_wstr("plain", CodePage::WIN1252),
+              L"plain");
+
+    wchar_t buf[2];
+    EXPECT_EQ(helper::convert::str_to_wstr("abc", 3, buf, 2, CodePage::UTF8),
+              0u);
+    EXPECT_EQ(helper::convert::str_to_wstr("abc", 3, nullptr, 0,
+                                           CodePage::UTF8),
+              3u);
+}
+
+TEST(helper_convert, err_string) {
+    EXPECT_FALSE(helper::convert::err_string(2).empty());
+    EXPECT_FALSE(helper::convert::err_wstring(2).empty());
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include "helper/convert.h"
+#include "helper/small_str.h"
+#include "support/alloc_counter.h"
+namespace helper = YanLib::helper;
+
+TEST(helper_small_str, inline_buffer) {
+    bool ok = false;
+    EXPECT_NO_ALLOC({
+        helper::small_str<char> str("C:/Windows/System32");
+        str.append("\\*.*");
+        str.push_back('x');
+        str.pop_back();
+        ok = !str.is_heap() && str.size() == 23 &&
+                strcmp(str.data(), "C:/Windows/System32\\*.*") == 0;
+    });
+    EXPECT_TRUE(ok);
+}
+
+TEST(helper_small_str, heap_fallback) {
+    const std::wstring long_path(helper::small_str<wchar_t>::inline_size * 3,
+                                 L'a');
+    helper::small_str<wchar_t> str(long_path.data(), 10);
+    EXPECT_FALSE(str.is_heap());
+    str.append(long_path.data() + 10);
+    EXPECT_TRUE(str.is_heap());
+    EXPECT_EQ(str.size(), long_path.size());
+    EXPECT_EQ(std::wstring(str.data()), long_path);
+    str.clear();
+    EXPECT_TRUE(str.empty());
+    EXPECT_EQ(str.data()[0], L'\0');
+}
+
+TEST(helper_small_str, convert) {
+    const char *path = "C:\\Windows\\System32\\drivers\\etc\\hosts";
+    helper::small_str<wchar_t> wide;
+    bool ok = false;
+    EXPECT_NO_ALLOC(ok = helper::convert::str_to_wstr(path, wide,
+                                                      helper::CodePage::UTF8));
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(std::wstring(wide.data()),
+              L"C:\\Windows\\System32\\drivers\\etc\\hosts");
+
+    helper::small_str<char> narrow;
+    EXPECT_NO_ALLOC(ok = helper::convert::wstr_to_str(wide.data(), narrow,
+                                                      helper::CodePage::UTF8));
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(std::string(narrow.data()), path);
+
+    // longer than the inline buffer: goes to the heap but still converts
+    const std::string long_name(helper::small_str<wchar_t>::inline_size * 2,
+                                'n');
+    EXPECT_TRUE(helper::convert::str_to_wstr(long_name.data(), wide,
+                                             helper::CodePage::UTF8));
+    EXPECT_TRUE(wide.is_heap());
+    EXPECT_EQ(wide.size(), long_name.size());
+}
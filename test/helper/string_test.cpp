@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "helper/string.h"
+#include "support/alloc_counter.h"
+namespace helper = YanLib::helper;
+
+TEST(helper_string, strstri) {
+    EXPECT_TRUE(helper::string::strstri(L"C:\\Windows\\System32\\NOTEPAD.EXE",
+                                        L"notepad.exe"));
+    EXPECT_TRUE(helper::string::strstri(std::wstring(L"Explorer.exe"),
+                                        std::wstring(L"PLORER")));
+    EXPECT_TRUE(helper::string::strstri(L"svchost.exe", L"S"));
+    EXPECT_FALSE(helper::string::strstri(L"svchost.exe", L"svchost.exe "));
+    EXPECT_FALSE(helper::string::strstri(L"svchost.exe", L""));
+    EXPECT_FALSE(helper::string::strstri(L"", L"a"));
+    EXPECT_FALSE(helper::string::strstri(nullptr, L"a"));
+}
+
+TEST(helper_string, needle) {
+    const helper::istr_needle needle(L"kernel32.DLL");
+    EXPECT_EQ(needle.size(), 12);
+    const std::wstring path = L"C:\\Windows\\System32\\KERNEL32.dll";
+    EXPECT_EQ(needle.find(path.data(), path.size()), 20);
+    EXPECT_TRUE(needle.is_in(path));
+    EXPECT_FALSE(needle.is_in(L"C:\\Windows\\System32\\kernel3.dll"));
+
+    // a needle longer than the filter window goes through Horspool
+    std::wstring text(300, L'x');
+    std::wstring long_needle(100, L'Y');
+    long_needle.back() = L'z';
+    text.replace(150, long_needle.size(), long_needle);
+    const helper::istr_needle horspool(std::wstring(100, L'y') + L"Z");
+    EXPECT_EQ(horspool.find(text.data(), text.size()),
+              helper::istr_needle::npos);
+    const helper::istr_needle hit(std::wstring(99, L'y') + L"Z");
+    EXPECT_EQ(hit.find(text.data(), text.size()), 150);
+
+    // matching does not allocate
+    bool found = false;
+    EXPECT_NO_ALLOC(found = needle.is_in(path.data()));
+    EXPECT_TRUE(found);
+}
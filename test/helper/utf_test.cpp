@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "helper/utf.h"
+#include "support/alloc_counter.h"
+namespace helper = YanLib::helper;
+
+class helper_utf : public ::testing::Test {
+protected:
+    void SetUp() override {
+        utf8_str = u8"Hello World!你好世界 \U0001F600 ÄÖÜ end";
+        utf16_str = u"Hello World!你好世界 \U0001F600 ÄÖÜ end";
+        // long enough to go through the vectorised ASCII loops several times
+        for (int32_t i = 0; i < 8; ++i) {
+            long_utf8.append("abcdefghijklmnopqrstuvwxyz0123456789");
+            long_utf8.append(utf8_str);
+            long_utf16.append(u"abcdefghijklmnopqrstuvwxyz0123456789");
+            long_utf16.append(utf16_str);
+        }
+    }
+
+    std::string utf8_str{};
+    std::u16string utf16_str{};
+    std::string long_utf8{};
+    std::u16string long_utf16{};
+};
+
+TEST_F(helper_utf, length) {
+    EXPECT_EQ(helper::utf::utf16_length(utf8_str.data(), utf8_str.size()),
+              utf16_str.size());
+    EXPECT_EQ(helper::utf::utf8_length(utf16_str.data(), utf16_str.size()),
+              utf8_str.size());
+    EXPECT_EQ(helper::utf::utf16_length(long_utf8.data(), long_utf8.size()),
+              long_utf16.size());
+    EXPECT_EQ(helper::utf::utf8_length(long_utf16.data(), long_utf16.size()),
+              long_utf8.size());
+    EXPECT_EQ(helper::utf::ascii_length(utf8_str.data(), utf8_str.size()), 12);
+    EXPECT_EQ(helper::utf::ascii_length(utf16_str.data(), utf16_str.size()),
+              12);
+    EXPECT_EQ(helper::utf::utf16_length("", 0), 0);
+}
+
+TEST_F(helper_utf, convert) {
+    std::u16string wide(long_utf16.size(), u'\0');
+    size_t written = 0;
+    EXPECT_NO_ALLOC(written = helper::utf::utf8_to_utf16(
+                            long_utf8.data(), long_utf8.size(), wide.data(),
+                            wide.size()));
+    EXPECT_EQ(written, long_utf16.size());
+    EXPECT_EQ(wide, long_utf16);
+
+    std::string narrow(long_utf8.size(), '\0');
+    EXPECT_NO_ALLOC(written = helper::utf::utf16_to_utf8(
+                            long_utf16.data(), long_utf16.size(),
+                            narrow.data(), narrow.size()));
+    EXPECT_EQ(written, long_utf8.size());
+    EXPECT_EQ(narrow, long_utf8);
+
+    // one unit short
+    EXPECT_EQ(helper::utf::utf8_to_utf16(utf8_str.data(), utf8_str.size(),
+                                         wide.data(), utf16_str.size() - 1),
+              helper::utf::npos);
+    EXPECT_EQ(helper::utf::utf16_to_utf8(utf16_str.data(), utf16_str.size(),
+                                         narrow.data(), utf8_str.size() - 1),
+              helper::utf::npos);
+}
+
+TEST_F(helper_utf, invalid) {
+    const char *bad_utf8[] = {
+            "\x80",             // stray continuation
+            "\xC0\xAF",         // overlong '/'
+            "\xE0\x80\xAF",     // overlong '/'
+            "\xED\xA0\x80",     // encoded surrogate
+            "\xF4\x90\x80\x80", // above U+10FFFF
+            "\xE4\xBD",         // truncated
+            "\xF5\x80\x80\x80", // invalid lead
+    };
+    for (const char *bad : bad_utf8) {
+        std::string str = "ok ";
+        str.append(bad);
+        EXPECT_FALSE(helper::utf::validate_utf8(str.data(), str.size()))
+                << str;
+        char16_t buf[16] = {};
+        EXPECT_EQ(helper::utf::utf8_to_utf16(str.data(), str.size(), buf, 16),
+                  helper::utf::npos);
+    }
+
+    const char16_t lone_high[] = {u'a', 0xD83D, u'b'};
+    const char16_t lone_low[] = {u'a', 0xDE00};
+    const char16_t truncated[] = {u'a', 0xD83D};
+    EXPECT_FALSE(helper::utf::validate_utf16(lone_high, 3));
+    EXPECT_FALSE(helper::utf::validate_utf16(lone_low, 2));
+    EXPECT_FALSE(helper::utf::validate_utf16(truncated, 2));
+    char buf[16] = {};
+    EXPECT_EQ(helper::utf::utf16_to_utf8(lone_high, 3, buf, 16),
+              helper::utf::npos);
+
+    EXPECT_TRUE(helper::utf::validate_utf8(utf8_str.data(), utf8_str.size()));
+    EXPECT_TRUE(helper::utf::validate_utf16(utf16_str.data(),
+                                            utf16_str.size()));
+}
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
+#include <filesystem>
 #include "io/pe32.h"
 namespace io = YanLib::io;
+namespace mem = YanLib::mem;
 
 class io_pe32 : public ::testing::Test {
 protected:
@@ -29,6 +31,44 @@ TEST_F(io_pe32, dos_header_check) {
     EXPECT_TRUE(pe32.set_dos_header(*dos_header));
 }
 
+TEST_F(io_pe32, map_mode_check) {
+    // on a copy, the default mode writes through to the file
+    const std::filesystem::path copy =
+            std::filesystem::temp_directory_path() / "yanlib_pe32_mode.dll";
+    std::filesystem::copy_file(
+            zlib, copy, std::filesystem::copy_options::overwrite_existing);
+    auto dos_header = std::make_unique<IMAGE_DOS_HEADER>();
+    {
+        io::pe32 pe32(copy.c_str(), mem::MapMode::ReadOnly);
+        EXPECT_TRUE(pe32.parse());
+        EXPECT_TRUE(pe32.get_dos_header(*dos_header));
+        EXPECT_FALSE(pe32.set_dos_header(*dos_header));
+    }
+    {
+        // copy-on-write edits stay in this instance
+        io::pe32 pe32(copy.c_str(), mem::MapMode::CopyOnWrite);
+        dos_header->e_magic = IMAGE_NT_SIGNATURE;
+        EXPECT_TRUE(pe32.set_dos_header(*dos_header));
+    }
+    {
+        io::pe32 pe32(copy.c_str(), mem::MapMode::ReadOnly);
+        EXPECT_TRUE(pe32.get_dos_header(*dos_header));
+        EXPECT_TRUE(dos_header->e_magic == IMAGE_DOS_SIGNATURE);
+    }
+    {
+        // the default reaches the file
+        io::pe32 pe32(copy.c_str());
+        dos_header->e_magic = IMAGE_NT_SIGNATURE;
+        EXPECT_TRUE(pe32.set_dos_header(*dos_header));
+    }
+    {
+        io::pe32 pe32(copy.c_str(), mem::MapMode::ReadOnly);
+        EXPECT_TRUE(pe32.get_dos_header(*dos_header));
+        EXPECT_TRUE(dos_header->e_magic == IMAGE_NT_SIGNATURE);
+    }
+    std::filesystem::remove(copy);
+}
+
 TEST_F(io_pe32, nt_headers_check) {
     io::pe32 pe32(zlib);
     auto nt_header = std::make_unique<IMAGE_NT_HEADERS32>();
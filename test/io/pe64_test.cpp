@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
+#include <filesystem>
 #include "io/pe64.h"
 namespace io = YanLib::io;
+namespace mem = YanLib::mem;
 
 class io_pe64 : public ::testing::Test {
 protected:
@@ -29,6 +31,44 @@ TEST_F(io_pe64, dos_header_check) {
     EXPECT_TRUE(pe64.set_dos_header(*dos_header));
 }
 
+TEST_F(io_pe64, map_mode_check) {
+    // on a copy, the default mode writes through to the file
+    const std::filesystem::path copy =
+            std::filesystem::temp_directory_path() / "yanlib_pe64_mode.dll";
+    std::filesystem::copy_file(
+            zlib, copy, std::filesystem::copy_options::overwrite_existing);
+    auto dos_header = std::make_unique<IMAGE_DOS_HEADER>();
+    {
+        io::pe64 pe64(copy.c_str(), mem::MapMode::ReadOnly);
+        EXPECT_TRUE(pe64.parse());
+        EXPECT_TRUE(pe64.get_dos_header(*dos_header));
+        EXPECT_FALSE(pe64.set_dos_header(*dos_header));
+    }
+    {
+        // copy-on-write edits stay in this instance
+        io::pe64 pe64(copy.c_str(), mem::MapMode::CopyOnWrite);
+        dos_header->e_magic = IMAGE_NT_SIGNATURE;
+        EXPECT_TRUE(pe64.set_dos_header(*dos_header));
+    }
+    {
+        io::pe64 pe64(copy.c_str(), mem::MapMode::ReadOnly);
+        EXPECT_TRUE(pe64.get_dos_header(*dos_header));
+        EXPECT_TRUE(dos_header->e_magic == IMAGE_DOS_SIGNATURE);
+    }
+    {
+        // the default reaches the file
+        io::pe64 pe64(copy.c_str());
+        dos_header->e_magic = IMAGE_NT_SIGNATURE;
+        EXPECT_TRUE(pe64.set_dos_header(*dos_header));
+    }
+    {
+        io::pe64 pe64(copy.c_str(), mem::MapMode::ReadOnly);
+        EXPECT_TRUE(pe64.get_dos_header(*dos_header));
+        EXPECT_TRUE(dos_header->e_magic == IMAGE_NT_SIGNATURE);
+    }
+    std::filesystem::remove(copy);
+}
+
 TEST_F(io_pe64, nt_headers_check) {
     io::pe64 pe64(zlib);
     auto nt_header = std::make_unique<IMAGE_NT_HEADERS64>();
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include "mem/allocate.h"
+#include "mem/large_page.h"
+namespace mem = YanLib::mem;
+
+namespace {
+    void fill(void *addr, const size_t size, const uint8_t seed) {
+        auto *bytes = static_cast<uint8_t *>(addr);
+        for (size_t i = 0; i < size; ++i) {
+            bytes[i] = static_cast<uint8_t>(i * 13 + seed);
+        }
+    }
+
+    bool check(const void *addr, const size_t size, const uint8_t seed) {
+        const auto *bytes = static_cast<const uint8_t *>(addr);
+        for (size_t i = 0; i < size; ++i) {
+            if (bytes[i] != static_cast<uint8_t>(i * 13 + seed)) {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+TEST(mem_allocate, realloc_keeps_contents) {
+    mem::allocate alloc;
+    void *addr = alloc.malloc(5000);
+    ASSERT_NE(addr, nullptr);
+    fill(addr, 5000, 1);
+    // past the two pages malloc reserved, so the block moves
+    addr = alloc.realloc(addr, 300000);
+    ASSERT_NE(addr, nullptr);
+    EXPECT_TRUE(check(addr, 5000, 1));
+    fill(addr, 300000, 2);
+    // shrinking decommits the tail and keeps the head in place
+    void *shrunk = alloc.realloc(addr, 100);
+    EXPECT_EQ(shrunk, addr);
+    EXPECT_TRUE(check(shrunk, 100, 2));
+    // and the decommitted pages come back on the next grow
+    void *grown = alloc.realloc(shrunk, 200000);
+    EXPECT_EQ(grown, addr);
+    EXPECT_TRUE(check(grown, 100, 2));
+    fill(grown, 200000, 3);
+    EXPECT_TRUE(check(grown, 200000, 3));
+    EXPECT_TRUE(alloc.free(grown));
+}
+
+TEST(mem_allocate, realloc_grows_in_reservation) {
+    constexpr size_t reserved = 1 << 20;
+    mem::allocate alloc;
+    void *const base = alloc.malloc_reserve(reserved);
+    ASSERT_NE(base, nullptr);
+    void *addr = alloc.realloc(base, 4096);
+    ASSERT_EQ(addr, base);
+    fill(addr, 4096, 4);
+    // every step up to the reservation commits in place
+    for (size_t size = 8192; size <= reserved; size *= 2) {
+        addr = alloc.realloc(addr, size);
+        ASSERT_EQ(addr, base);
+        EXPECT_TRUE(check(addr, size / 2, 4));
+        fill(addr, size, 4);
+    }
+
+    // one byte past the reservation has to move
+    addr = alloc.realloc(addr, reserved + 1);
+    ASSERT_NE(addr, nullptr);
+    EXPECT_NE(addr, base);
+    EXPECT_TRUE(check(addr, reserved, 4));
+    // into a reservation twice the size, so the next grow stays put
+    void *const moved = addr;
+    addr = alloc.realloc(addr, reserved * 2);
+    EXPECT_EQ(addr, moved);
+    EXPECT_TRUE(check(addr, reserved, 4));
+    EXPECT_TRUE(alloc.free(addr));
+    // the old block went back with the move
+    EXPECT_EQ(alloc.realloc(base, 100), nullptr);
+}
+
+TEST(mem_allocate, large_page_fallback) {
+    constexpr size_t size = 100000;
+    mem::allocate alloc;
+    // test accounts rarely hold SeLockMemoryPrivilege
+    const bool privileged = mem::large_page::enable();
+    auto *ptr = static_cast<uint8_t *>(alloc.malloc_large_page(size));
+    ASSERT_NE(ptr, nullptr);
+    memset(ptr, 0xA5, size);
+    if (!privileged) {
+        // normal pages, with the reason kept
+        EXPECT_NE(mem::large_page::err_code(), 0u);
+        EXPECT_EQ(alloc.err_code(), mem::large_page::err_code());
+        EXPECT_EQ(alloc.large_page_bytes(), 0u);
+        EXPECT_EQ(alloc.malloc_large_page(size, false), nullptr);
+    } else if (alloc.large_page_bytes()) {
+        EXPECT_EQ(alloc.large_page_bytes(), mem::large_page::round_up(size));
+    }
+    // either way the block resizes and frees like any other
+    ptr = static_cast<uint8_t *>(alloc.realloc(ptr, size * 3));
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(ptr[size - 1], 0xA5);
+    EXPECT_TRUE(alloc.free(ptr));
+    EXPECT_EQ(alloc.large_page_bytes(), 0u);
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "mem/arena.h"
+#include "support/alloc_counter.h"
+namespace mem = YanLib::mem;
+
+TEST(mem_arena, alignment) {
+    mem::arena arena(4096);
+    for (size_t align = 1; align <= 256; align *= 2) {
+        for (size_t size = 0; size < 100; size += 13) {
+            void *ptr = arena.malloc(size, align);
+            ASSERT_NE(ptr, nullptr);
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % align, 0u);
+        }
+    }
+}
+
+TEST(mem_arena, chained_blocks) {
+    mem::arena arena(1024);
+    std::vector<uint8_t *> blocks;
+    for (int i = 0; i < 100; ++i) {
+        auto *ptr = static_cast<uint8_t *>(arena.malloc(100));
+        ASSERT_NE(ptr, nullptr);
+        memset(ptr, i, 100);
+        blocks.push_back(ptr);
+    }
+    // larger than a block, gets a block of its own
+    auto *big = static_cast<uint8_t *>(arena.malloc(10000));
+    ASSERT_NE(big, nullptr);
+    memset(big, 0xFF, 10000);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(blocks[i][0], i);
+        EXPECT_EQ(blocks[i][99], i);
+    }
+    EXPECT_GE(arena.used(), 100 * 100 + 10000u);
+    EXPECT_GE(arena.reserved(), arena.used());
+}
+
+TEST(mem_arena, rewind) {
+    mem::arena arena(1024);
+    void *first = arena.malloc(16);
+    const mem::arena::marker m = arena.mark();
+    void *second = arena.malloc(16);
+    for (int i = 0; i < 50; ++i) {
+        arena.malloc(100);
+    }
+    const size_t reserved = arena.reserved();
+    arena.rewind(m);
+    EXPECT_EQ(arena.malloc(16), second);
+    for (int i = 0; i < 50; ++i) {
+        arena.malloc(100);
+    }
+    EXPECT_EQ(arena.reserved(), reserved);
+    arena.reset();
+    EXPECT_EQ(arena.malloc(16), first);
+    EXPECT_EQ(arena.used(), 16u);
+    {
+        mem::arena_scope scope(arena);
+        arena.malloc(500);
+    }
+    EXPECT_EQ(arena.used(), 16u);
+    arena.release();
+    EXPECT_EQ(arena.reserved(), 0u);
+}
+
+TEST(mem_arena, buffer) {
+    alignas(16) uint8_t buffer[4096];
+    mem::arena arena(buffer, sizeof(buffer));
+    bool ok = false;
+    EXPECT_NO_ALLOC({
+        auto *ptr = static_cast<uint8_t *>(arena.malloc(1000));
+        ok = ptr > buffer && ptr + 1000 <= buffer + sizeof(buffer);
+    });
+    EXPECT_TRUE(ok);
+    // spills over into blocks of its own, the buffer stays first
+    EXPECT_NE(arena.malloc(8000), nullptr);
+    arena.release();
+    EXPECT_EQ(arena.reserved(), sizeof(buffer));
+    EXPECT_GE(arena.malloc(100), static_cast<void *>(buffer));
+}
+
+TEST(mem_arena, pmr_resource) {
+    mem::arena arena;
+    mem::arena_resource resource(arena);
+    // the first round sizes the blocks, later rounds reuse them
+    for (int round = 0; round < 3; ++round) {
+        support::alloc_counter counter;
+        {
+            std::pmr::vector<std::pmr::string> lines(&resource);
+            for (int i = 0; i < 1000; ++i) {
+                lines.emplace_back("a line that does not fit inline ...");
+            }
+            EXPECT_EQ(lines.size(), 1000u);
+            EXPECT_EQ(lines[999], "a line that does not fit inline ...");
+        }
+        arena.reset();
+        if (round > 0) {
+            EXPECT_EQ(counter.count(), 0u);
+        }
+    }
+}
+
+TEST(mem_arena, upstream) {
+    struct counting_resource : std::pmr::memory_resource {
+        size_t live = 0;
+
+        void *do_allocate(const size_t bytes, const size_t align) override {
+            live += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, align);
+        }
+
+        void do_deallocate(void *p,
+                           const size_t bytes,
+                           const size_t align) override {
+            live -= bytes;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+        }
+
+        bool do_is_equal(const memory_resource &other) const noexcept
+                override {
+            return this == &other;
+        }
+    } upstream;
+    {
+        mem::arena arena(1024, &upstream);
+        for (int i = 0; i < 100; ++i) {
+            EXPECT_NE(arena.malloc(100), nullptr);
+        }
+        EXPECT_EQ(upstream.live, arena.reserved());
+        EXPECT_GT(upstream.live, 10000u);
+    }
+    EXPECT_EQ(upstream.live, 0u);
+}
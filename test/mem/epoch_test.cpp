@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "mem/epoch.h"
+namespace mem = YanLib::mem;
+
+namespace {
+    struct node {
+        uint64_t value;
+        node *next;
+        static inline std::atomic<int> alive{0};
+
+        explicit node(const uint64_t value) : value(value), next(nullptr) {
+            ++alive;
+        }
+
+        ~node() {
+            --alive;
+        }
+    };
+
+    // Treiber stack over pooled nodes; without reclamation a popped node
+    // could be reused by the pool while another pop still reads it
+    class stack {
+    private:
+        std::atomic<node *> head{nullptr};
+        mem::object_pool<node> &pool;
+        mem::epoch_domain &domain;
+
+    public:
+        stack(mem::object_pool<node> &pool, mem::epoch_domain &domain)
+            : pool(pool), domain(domain) {
+        }
+
+        void push(const uint64_t value) {
+            node *n = pool.create(value);
+            n->next = head.load(std::memory_order_relaxed);
+            while (!head.compare_exchange_weak(n->next, n,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+            }
+        }
+
+        bool pop(uint64_t &value) {
+            node *n = nullptr;
+            {
+                mem::epoch_guard guard(domain);
+                n = head.load(std::memory_order_acquire);
+                while (n && !head.compare_exchange_weak(
+                                    n, n->next, std::memory_order_acquire,
+                                    std::memory_order_acquire)) {
+                }
+                if (!n) {
+                    return false;
+                }
+                value = n->value;
+            }
+            domain.retire(n, pool);
+            return true;
+        }
+    };
+} // namespace
+
+TEST(mem_epoch, deferred_while_pinned) {
+    mem::epoch_domain domain;
+    std::atomic<bool> pinned{false};
+    std::atomic<bool> release{false};
+    std::thread reader([&] {
+        mem::epoch_guard guard(domain);
+        pinned = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+    while (!pinned) {
+        std::this_thread::yield();
+    }
+    domain.retire(new node(1));
+    EXPECT_EQ(domain.pending(), 1u);
+    for (int i = 0; i < 4; ++i) {
+        domain.collect();
+    }
+    // the reader may still hold it
+    EXPECT_EQ(node::alive, 1);
+    release = true;
+    reader.join();
+    for (int i = 0; i < 3; ++i) {
+        domain.collect();
+    }
+    EXPECT_EQ(node::alive, 0);
+    EXPECT_EQ(domain.pending(), 0u);
+}
+
+TEST(mem_epoch, nesting_and_exit) {
+    {
+        mem::epoch_domain domain;
+        domain.pin();
+        domain.pin();
+        domain.unpin();
+        EXPECT_TRUE(domain.pinned());
+        domain.unpin();
+        EXPECT_FALSE(domain.pinned());
+        // garbage of a thread that exits stays with the domain
+        std::thread([&] {
+            for (int i = 0; i < 10; ++i) {
+                domain.retire(new node(i));
+            }
+        }).join();
+        EXPECT_EQ(domain.pending(), 10u);
+        for (int i = 0; i < 3; ++i) {
+            domain.collect();
+        }
+        EXPECT_EQ(node::alive, 0);
+        domain.retire(new node(0));
+        domain.unregister_thread();
+        domain.retire(new node(1));
+        EXPECT_EQ(domain.pending(), 2u);
+        // the destructor frees the rest
+    }
+    EXPECT_EQ(node::alive, 0);
+}
+
+TEST(mem_epoch, exit_detaches_evicted) {
+    mem::epoch_domain domain;
+    std::vector<mem::epoch_domain> others(6);
+    // the thread's record for domain leaves its lookup cache to the
+    // others, it must still hand its garbage over on exit
+    std::thread([&] {
+        for (int i = 0; i < 10; ++i) {
+            domain.retire(new node(i));
+        }
+        for (auto &other : others) {
+            other.collect();
+        }
+    }).join();
+    EXPECT_EQ(domain.pending(), 10u);
+    for (int i = 0; i < 3; ++i) {
+        domain.collect();
+    }
+    EXPECT_EQ(node::alive, 0);
+}
+
+TEST(mem_epoch, batches_bound_garbage) {
+    mem::epoch_domain domain;
+    for (int i = 0; i < 100000; ++i) {
+        domain.retire(new node(i));
+    }
+    // nobody is pinned, every batch frees what came two epochs earlier
+    EXPECT_LE(domain.pending(), 3 * mem::epoch_domain::batch_size);
+    while (domain.pending()) {
+        domain.collect();
+    }
+    EXPECT_EQ(node::alive, 0);
+}
+
+TEST(mem_epoch, pooled_stack) {
+    constexpr int threads = 4;
+    constexpr uint64_t per_thread = 20000;
+    mem::object_pool<node> pool;
+    {
+        mem::epoch_domain domain;
+        stack s(pool, domain);
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> popped{0};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                for (uint64_t i = 0; i < per_thread; ++i) {
+                    s.push(t * per_thread + i + 1);
+                    uint64_t value = 0;
+                    if (s.pop(value)) {
+                        sum.fetch_add(value, std::memory_order_relaxed);
+                        popped.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+        }
+        for (auto &w : workers) {
+            w.join();
+        }
+        uint64_t value = 0;
+        while (s.pop(value)) {
+            sum += value;
+            ++popped;
+        }
+        const uint64_t n = threads * per_thread;
+        EXPECT_EQ(popped.load(), n);
+        EXPECT_EQ(sum.load(), n * (n + 1) / 2);
+        // the domain goes first, its garbage still needs the pool
+    }
+    EXPECT_EQ(node::alive, 0);
+    EXPECT_EQ(pool.stats().in_use, 0u);
+}
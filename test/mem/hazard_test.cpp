@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "mem/hazard.h"
+namespace mem = YanLib::mem;
+
+namespace {
+    struct item {
+        uint64_t value;
+        static inline std::atomic<int> alive{0};
+
+        explicit item(const uint64_t value) : value(value) {
+            ++alive;
+        }
+
+        ~item() {
+            --alive;
+        }
+    };
+} // namespace
+
+TEST(mem_hazard, protected_until_reset) {
+    {
+        mem::hazard_domain domain;
+        std::atomic<item *> shared{new item(1)};
+        mem::hazard_pointer hp(domain);
+        item *held = hp.protect(shared);
+        ASSERT_NE(held, nullptr);
+        // replaced and retired while still held
+        domain.retire(shared.exchange(new item(2)));
+        EXPECT_EQ(domain.collect(), 0u);
+        EXPECT_EQ(held->value, 1u);
+        EXPECT_EQ(item::alive, 2);
+        hp.reset();
+        EXPECT_EQ(domain.collect(), 1u);
+        EXPECT_EQ(item::alive, 1);
+        domain.retire(shared.exchange(nullptr));
+        EXPECT_EQ(hp.protect(shared), nullptr);
+        // the destructor frees the rest
+    }
+    EXPECT_EQ(item::alive, 0);
+}
+
+TEST(mem_hazard, slots_are_reused) {
+    mem::hazard_domain domain;
+    mem::hazard_domain::slot *first = domain.acquire_slot();
+    mem::hazard_domain::slot *second = domain.acquire_slot();
+    EXPECT_NE(first, second);
+    domain.release_slot(first);
+    EXPECT_EQ(domain.acquire_slot(), first);
+    domain.release_slot(first);
+    domain.release_slot(second);
+}
+
+TEST(mem_hazard, readers_and_writers) {
+    mem::object_pool<item> pool;
+    {
+        mem::hazard_domain domain;
+        std::atomic<item *> shared{pool.create(0)};
+        std::atomic<bool> done{false};
+        std::atomic<int> bad{0};
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 3; ++i) {
+            readers.emplace_back([&] {
+                mem::hazard_pointer hp(domain);
+                uint64_t last = 0;
+                while (!done.load(std::memory_order_acquire)) {
+                    const item *current = hp.protect(shared);
+                    // a freed and reused slot would show an older value
+                    if (current->value < last) {
+                        ++bad;
+                    }
+                    last = current->value;
+                    hp.reset();
+                }
+            });
+        }
+        for (uint64_t v = 1; v <= 50000; ++v) {
+            domain.retire(shared.exchange(pool.create(v)), pool);
+            EXPECT_LE(domain.pending(),
+                      mem::hazard_domain::batch_size + 8);
+        }
+        done.store(true, std::memory_order_release);
+        for (auto &t : readers) {
+            t.join();
+        }
+        EXPECT_EQ(bad.load(), 0);
+        pool.destroy(shared.load());
+    }
+    EXPECT_EQ(item::alive, 0);
+    EXPECT_EQ(pool.stats().in_use, 0u);
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "mem/mapped_file.h"
+#include "support/temp_file.h"
+namespace mem = YanLib::mem;
+using support::write_temp;
+
+namespace {
+    std::vector<uint8_t> pattern(const size_t size) {
+        std::vector<uint8_t> data(size);
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = static_cast<uint8_t>(i * 131 + (i >> 12));
+        }
+        return data;
+    }
+} // namespace
+
+TEST(mem_mapped_file, whole_file) {
+    const std::vector<uint8_t> data = pattern(100000);
+    const std::string path = write_temp("yanlib_mapped_whole.bin", data);
+    mem::mapped_file file;
+    ASSERT_TRUE(file.open(path.data()));
+    EXPECT_EQ(file.size(), data.size());
+    mem::mapped_view view(file);
+    const mem::byte_span all = view.bytes(0, data.size());
+    ASSERT_EQ(all.size(), data.size());
+    EXPECT_TRUE(std::equal(all.begin(), all.end(), data.begin()));
+    EXPECT_TRUE(view.advise(mem::MapAdvice::Sequential));
+    EXPECT_EQ(all.subspan(99990).size(), 10u);
+    EXPECT_TRUE(view.bytes(99990, 11).empty());
+    EXPECT_EQ(view.data(0, 1), nullptr);
+    view.unmap();
+    file.close();
+    std::filesystem::remove(path);
+}
+
+TEST(mem_mapped_file, sliding_window) {
+    const size_t window = 4 * mem::mapped_file::granularity();
+    const std::vector<uint8_t> data = pattern(window * 5 + 123);
+    const std::string path = write_temp("yanlib_mapped_window.bin", data);
+    mem::mapped_file file;
+    ASSERT_TRUE(file.open(path.data()));
+    mem::mapped_view view(file, window);
+    for (uint64_t offset = 0; offset + 100 <= data.size(); offset += 7777) {
+        const mem::byte_span bytes = view.bytes(offset, 100);
+        ASSERT_EQ(bytes.size(), 100u);
+        EXPECT_TRUE(std::equal(bytes.begin(), bytes.end(),
+                               data.begin() + offset));
+        EXPECT_LE(view.window_bytes(), window + 100);
+        EXPECT_EQ(view.window_offset() % mem::mapped_file::granularity(), 0u);
+    }
+    // a range across a window boundary gets a window of its own
+    const mem::byte_span across = view.bytes(window - 10, 20);
+    ASSERT_EQ(across.size(), 20u);
+    EXPECT_EQ(across[0], data[window - 10]);
+    EXPECT_EQ(across[19], data[window + 9]);
+    EXPECT_TRUE(view.advise(mem::MapAdvice::Random));
+    view.unmap();
+    file.close();
+    std::filesystem::remove(path);
+}
+
+TEST(mem_mapped_file, read_write) {
+    const std::string path =
+            write_temp("yanlib_mapped_rw.bin", std::vector<uint8_t>(5000));
+    {
+        mem::mapped_file file;
+        ASSERT_TRUE(file.open(path.data(), mem::MapMode::ReadWrite));
+        mem::mapped_view view(file, mem::mapped_file::granularity());
+        uint8_t *bytes = view.data(4000, 4);
+        ASSERT_NE(bytes, nullptr);
+        memcpy(bytes, "YLib", 4);
+        EXPECT_TRUE(view.flush());
+    }
+    mem::mapped_file file;
+    ASSERT_TRUE(file.open(path.data()));
+    mem::mapped_view view(file);
+    const mem::byte_span bytes = view.bytes(4000, 4);
+    ASSERT_EQ(bytes.size(), 4u);
+    EXPECT_EQ(std::string(bytes.begin(), bytes.end()), "YLib");
+    view.unmap();
+    file.close();
+    std::filesystem::remove(path);
+}
+
+TEST(mem_mapped_file, copy_on_write) {
+    const std::vector<uint8_t> data = pattern(5000);
+    const std::string path = write_temp("yanlib_mapped_cow.bin", data);
+    {
+        mem::mapped_file file;
+        ASSERT_TRUE(file.open(path.data(), mem::MapMode::CopyOnWrite));
+        mem::mapped_view view(file);
+        uint8_t *bytes = view.data(4000, 4);
+        ASSERT_NE(bytes, nullptr);
+        memcpy(bytes, "YLib", 4);
+        const mem::byte_span edited = view.bytes(4000, 4);
+        EXPECT_EQ(std::string(edited.begin(), edited.end()), "YLib");
+        EXPECT_TRUE(view.flush());
+    }
+    mem::mapped_file file;
+    ASSERT_TRUE(file.open(path.data()));
+    mem::mapped_view view(file);
+    const mem::byte_span bytes = view.bytes(0, data.size());
+    ASSERT_EQ(bytes.size(), data.size());
+    EXPECT_TRUE(std::equal(bytes.begin(), bytes.end(), data.begin()));
+    view.unmap();
+    file.close();
+    std::filesystem::remove(path);
+}
+
+TEST(mem_mapped_file, empty_and_missing) {
+    const std::string path =
+            write_temp("yanlib_mapped_empty.bin", std::vector<uint8_t>());
+    mem::mapped_file file;
+    ASSERT_TRUE(file.open(path.data()));
+    EXPECT_EQ(file.size(), 0u);
+    mem::mapped_view view(file);
+    EXPECT_TRUE(view.bytes(0, 1).empty());
+    file.close();
+    std::filesystem::remove(path);
+    EXPECT_FALSE(file.open(path.data()));
+    EXPECT_NE(file.err_code(), 0u);
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "mem/large_page.h"
+#include "mem/mmap.h"
+#include "support/temp_file.h"
+namespace mem = YanLib::mem;
+using support::write_temp;
+
+TEST(mem_mmap, whole_view_stops_at_eof) {
+    // ends in the middle of a page, past one allocation granule
+    const uint64_t granule = mem::mapped_file::granularity();
+    std::vector<uint8_t> data(granule + 5000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 7);
+    }
+    const std::string path = write_temp("yanlib_mmap_eof.bin", data);
+    {
+        mem::mmap map;
+        HANDLE section = map.create(path.data(), mem::MapMode::ReadOnly);
+        ASSERT_NE(section, nullptr);
+        void *addr = map.mmap_file(section, mem::MapMode::ReadOnly);
+        ASSERT_NE(addr, nullptr);
+        EXPECT_EQ(map.view(addr).size(), data.size());
+        uint8_t last = 0;
+        EXPECT_TRUE(map.read(addr, &last, 1, data.size() - 1));
+        EXPECT_EQ(last, data.back());
+        EXPECT_FALSE(map.read(addr, &last, 1, data.size()));
+        EXPECT_TRUE(map.unmap_file(addr));
+
+        // a view at an offset reaches the same end of file
+        addr = map.mmap_file(section, mem::MapMode::ReadOnly, granule);
+        ASSERT_NE(addr, nullptr);
+        EXPECT_EQ(map.view(addr).size(), 5000u);
+        EXPECT_TRUE(map.unmap_file(addr));
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(mem_mmap, anonymous_view_is_section_size) {
+    mem::mmap map;
+    HANDLE section = map.create_anonymous(static_cast<const char *>(nullptr),
+                                          10000);
+    ASSERT_NE(section, nullptr);
+    void *addr = map.mmap_file(section, mem::MapMode::ReadWrite);
+    ASSERT_NE(addr, nullptr);
+    EXPECT_EQ(map.view(addr).size(), 10000u);
+    const uint8_t byte = 0x5A;
+    EXPECT_TRUE(map.write(addr, &byte, 1, 9999));
+    EXPECT_FALSE(map.write(addr, &byte, 1, 10000));
+    EXPECT_TRUE(map.unmap_file(addr));
+}
+
+TEST(mem_mmap, large_page_fallback) {
+    mem::mmap map;
+    const bool privileged = mem::large_page::enable();
+    HANDLE section = map.create_anonymous(static_cast<const char *>(nullptr),
+                                          100000, true);
+    ASSERT_NE(section, nullptr);
+    void *addr = map.mmap_file(section, mem::MapMode::ReadWrite);
+    ASSERT_NE(addr, nullptr);
+    if (!privileged) {
+        // a normal section of exactly the asked size, with the reason kept
+        EXPECT_EQ(map.err_code(), mem::large_page::err_code());
+        EXPECT_EQ(map.large_page_bytes(), 0u);
+        EXPECT_EQ(map.view(addr).size(), 100000u);
+    } else if (map.large_page_bytes()) {
+        EXPECT_EQ(map.view(addr).size(), mem::large_page::round_up(100000));
+    }
+    const uint8_t byte = 0x5A;
+    EXPECT_TRUE(map.write(addr, &byte, 1, 99999));
+    EXPECT_TRUE(map.unmap_file(addr));
+    EXPECT_EQ(map.large_page_bytes(), 0u);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <new>
+#include <vector>
+#include "mem/arena.h"
+#include "mem/numa.h"
+#include "sys/processor.h"
+namespace mem = YanLib::mem;
+namespace sys = YanLib::sys;
+
+TEST(mem_numa, node_local) {
+    const uint32_t nodes = mem::numa::node_count();
+    ASSERT_GE(nodes, 1u);
+    sys::processor cpu;
+    EXPECT_EQ(nodes - 1, cpu.numa_highest_node());
+    EXPECT_LT(mem::numa::current_node(), nodes);
+
+    mem::numa numa;
+    std::vector<void *> blocks;
+    for (uint32_t node = 0; node < nodes; ++node) {
+        void *ptr = numa.malloc(10000, node);
+        ASSERT_NE(ptr, nullptr) << numa.err_string();
+        memset(ptr, 0x5A, 10000);
+        // whole pages
+        EXPECT_GE(numa.allocated_bytes(node), 10000u);
+        blocks.push_back(ptr);
+    }
+    void *local = numa.malloc(100);
+    ASSERT_NE(local, nullptr);
+    size_t total = 0;
+    for (uint32_t node = 0; node < nodes; ++node) {
+        total += numa.allocated_bytes(node);
+    }
+    EXPECT_GE(total, nodes * 10000u + 100u);
+
+    EXPECT_EQ(numa.malloc(100, nodes), nullptr);
+    EXPECT_EQ(numa.err_code(), static_cast<uint32_t>(ERROR_INVALID_PARAMETER));
+    for (void *ptr : blocks) {
+        EXPECT_TRUE(numa.free(ptr));
+    }
+    EXPECT_TRUE(numa.free(local));
+    EXPECT_FALSE(numa.free(local));
+    for (uint32_t node = 0; node < nodes; ++node) {
+        EXPECT_EQ(numa.allocated_bytes(node), 0u);
+    }
+}
+
+TEST(mem_numa, resource_on_one_node) {
+    // a machine without NUMA reports a single node 0, the resource must
+    // then behave like any page allocator
+    mem::numa numa;
+    {
+        mem::numa_resource resource(numa);
+        mem::arena arena(4096, &resource);
+        for (int i = 0; i < 100; ++i) {
+            auto *ptr = static_cast<uint8_t *>(arena.malloc(1000));
+            ASSERT_NE(ptr, nullptr);
+            memset(ptr, i, 1000);
+        }
+        if (mem::numa::node_count() == 1) {
+            EXPECT_GE(numa.allocated_bytes(0), 100 * 1000u);
+        }
+        std::pmr::vector<uint64_t> values(&resource);
+        for (uint64_t i = 0; i < 10000; ++i) {
+            values.push_back(i);
+        }
+        EXPECT_EQ(values[9999], 9999u);
+    }
+    for (uint32_t node = 0; node < mem::numa::node_count(); ++node) {
+        EXPECT_EQ(numa.allocated_bytes(node), 0u);
+    }
+
+    // node 0 always exists, the one past the last never does
+    mem::numa_resource first(numa, 0);
+    void *ptr = first.allocate(5000);
+    EXPECT_GE(numa.allocated_bytes(0), 5000u);
+    first.deallocate(ptr, 5000);
+    mem::numa_resource missing(numa, mem::numa::node_count());
+    EXPECT_THROW(missing.allocate(100), std::bad_alloc);
+}
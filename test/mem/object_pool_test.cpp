@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mem/object_pool.h"
+#include "support/alloc_counter.h"
+namespace mem = YanLib::mem;
+
+namespace {
+    struct connection {
+        uint64_t id;
+        char buffer[200];
+        static inline std::atomic<int> alive{0};
+
+        explicit connection(const uint64_t id) : id(id), buffer() {
+            ++alive;
+        }
+
+        ~connection() {
+            --alive;
+        }
+    };
+
+    struct alignas(64) aligned_io {
+        uint8_t data[100];
+    };
+} // namespace
+
+TEST(mem_object_pool, create_destroy) {
+    mem::object_pool<connection> pool;
+    std::vector<connection *> objects;
+    for (uint64_t i = 0; i < 1000; ++i) {
+        connection *obj = pool.create(i);
+        ASSERT_NE(obj, nullptr);
+        objects.push_back(obj);
+    }
+    EXPECT_EQ(connection::alive, 1000);
+    for (uint64_t i = 0; i < 1000; ++i) {
+        EXPECT_EQ(objects[i]->id, i);
+        pool.destroy(objects[i]);
+    }
+    EXPECT_EQ(connection::alive, 0);
+    const mem::pool_stats stats = pool.stats();
+    EXPECT_EQ(stats.in_use, 0u);
+    EXPECT_EQ(stats.high_water, 1000u);
+    EXPECT_GE(stats.capacity, 1000u);
+    // freed slots are reused, the high-water mark stays
+    for (auto &obj : objects) {
+        obj = pool.create(7);
+    }
+    EXPECT_EQ(pool.stats().high_water, 1000u);
+    EXPECT_EQ(pool.stats().in_use, 1000u);
+    for (const auto obj : objects) {
+        pool.destroy(obj);
+    }
+}
+
+TEST(mem_object_pool, alignment) {
+    mem::object_pool<aligned_io> pool;
+    for (int i = 0; i < 100; ++i) {
+        aligned_io *obj = pool.create();
+        ASSERT_NE(obj, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(obj) % 64, 0u);
+    }
+}
+
+TEST(mem_object_pool, prewarm) {
+    mem::object_pool<connection> pool(5000);
+    EXPECT_GE(pool.stats().capacity, 5000u);
+    std::vector<connection *> objects(5000);
+    bool ok = true;
+    pool.destroy(pool.create(0));
+    EXPECT_NO_ALLOC({
+        for (uint64_t i = 0; i < objects.size(); ++i) {
+            objects[i] = pool.create(i);
+            ok = ok && objects[i];
+        }
+        for (const auto obj : objects) {
+            pool.destroy(obj);
+        }
+    });
+    EXPECT_TRUE(ok);
+}
+
+TEST(mem_object_pool, cross_thread) {
+    mem::object_pool<connection> pool;
+    constexpr size_t THREADS = 8;
+    constexpr size_t COUNT = 20000;
+    std::vector<std::vector<connection *>> handoff(THREADS);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&pool, &handoff, t] {
+            for (size_t i = 0; i < COUNT; ++i) {
+                connection *obj = pool.create(t << 32 | i);
+                ASSERT_NE(obj, nullptr);
+                if (i % 4 == 0) {
+                    handoff[t].push_back(obj);
+                } else {
+                    EXPECT_EQ(obj->id, t << 32 | i);
+                    pool.destroy(obj);
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+    // every thread frees what another one allocated
+    for (size_t t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&pool, &handoff, t] {
+            for (const auto obj : handoff[(t + 1) % THREADS]) {
+                EXPECT_EQ(obj->id >> 32, (t + 1) % THREADS);
+                pool.destroy(obj);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(connection::alive, 0);
+    EXPECT_EQ(pool.stats().in_use, 0u);
+    // exited threads handed their caches back, so nothing new is carved
+    const size_t high_water = pool.stats().high_water;
+    std::vector<connection *> objects;
+    for (size_t i = 0; i < THREADS * mem::fixed_pool::cache_limit; ++i) {
+        objects.push_back(pool.create(i));
+    }
+    EXPECT_EQ(pool.stats().high_water, high_water);
+    for (const auto obj : objects) {
+        pool.destroy(obj);
+    }
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "mem/registry.h"
+namespace mem = YanLib::mem;
+
+TEST(mem_registry, insert_erase) {
+    mem::registry registry;
+    int a = 0;
+    int b = 0;
+    EXPECT_TRUE(registry.insert(&a, 1));
+    EXPECT_FALSE(registry.insert(&a, 2));
+    EXPECT_TRUE(registry.insert(&b));
+    uintptr_t value = 0;
+    EXPECT_TRUE(registry.find(&a, &value));
+    EXPECT_EQ(value, 1u);
+    EXPECT_TRUE(registry.update(&a, 3));
+    EXPECT_TRUE(registry.erase(&a, &value));
+    EXPECT_EQ(value, 3u);
+    EXPECT_FALSE(registry.erase(&a));
+    EXPECT_FALSE(registry.update(&a, 4));
+    EXPECT_EQ(registry.size(), 1u);
+    const auto entries = registry.drain();
+    ASSERT_EQ(entries.size(), 1u);
+    EXPECT_EQ(entries[0].first, &b);
+    EXPECT_EQ(registry.size(), 0u);
+}
+
+TEST(mem_registry, concurrent) {
+    mem::registry registry;
+    constexpr uintptr_t COUNT = 100000;
+    std::vector<std::thread> threads;
+    for (uintptr_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&registry, t] {
+            for (uintptr_t i = t; i < COUNT; i += 4) {
+                const auto addr = reinterpret_cast<const void *>(i * 4096);
+                EXPECT_TRUE(registry.insert(addr, i));
+            }
+            for (uintptr_t i = t; i < COUNT; i += 8) {
+                const auto addr = reinterpret_cast<const void *>(i * 4096);
+                EXPECT_TRUE(registry.erase(addr));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(registry.size(), COUNT / 2);
+}
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "mem/slab.h"
+namespace mem = YanLib::mem;
+
+TEST(mem_slab, size_classes) {
+    mem::slab slab;
+    for (size_t size = 0; size <= mem::slab::max_small_size; size += 7) {
+        void *block = slab.malloc(size);
+        ASSERT_NE(block, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % mem::slab::alignment,
+                  0u);
+        EXPECT_GE(mem::slab::size(block), size);
+        // 16 byte steps up to 128, then at most a quarter of the request
+        EXPECT_LE(mem::slab::size(block),
+                  size <= 128 ? size + 16 : size + size / 4);
+        memset(block, 0xA5, size);
+        EXPECT_TRUE(slab.free(block));
+    }
+}
+
+TEST(mem_slab, large) {
+    mem::slab slab;
+    const size_t size = 3 * 1024 * 1024 + 5;
+    auto *block = static_cast<uint8_t *>(slab.malloc(size));
+    ASSERT_NE(block, nullptr);
+    EXPECT_GE(mem::slab::size(block), size);
+    block[0] = 1;
+    block[size - 1] = 2;
+    EXPECT_GE(slab.reserved_bytes(), size);
+    EXPECT_TRUE(slab.free(block));
+    EXPECT_EQ(slab.reserved_bytes(), 0u);
+}
+
+TEST(mem_slab, reuse) {
+    mem::slab slab;
+    std::vector<void *> blocks;
+    for (int i = 0; i < 10000; ++i) {
+        blocks.push_back(slab.malloc(48));
+    }
+    const size_t reserved = slab.reserved_bytes();
+    for (const auto block : blocks) {
+        EXPECT_TRUE(slab.free(block));
+    }
+    for (auto &block : blocks) {
+        block = slab.malloc(48);
+        ASSERT_NE(block, nullptr);
+    }
+    EXPECT_EQ(slab.reserved_bytes(), reserved);
+}
+
+TEST(mem_slab, foreign_pointer) {
+    mem::slab a;
+    mem::slab b;
+    void *block = a.malloc(32);
+    EXPECT_FALSE(b.free(block));
+    EXPECT_FALSE(b.free(nullptr));
+    EXPECT_TRUE(a.owns(block));
+    EXPECT_FALSE(b.owns(block));
+    // memory no slab handed out is caught by owns(), not free()
+    int on_stack = 0;
+    EXPECT_FALSE(a.owns(&on_stack));
+    void *large = a.malloc(1 << 20);
+    EXPECT_TRUE(a.owns(large));
+    EXPECT_TRUE(a.owns(static_cast<uint8_t *>(large) + (1 << 20) - 1));
+    EXPECT_FALSE(b.owns(large));
+    EXPECT_TRUE(a.free(large));
+    EXPECT_FALSE(a.owns(large));
+    EXPECT_TRUE(a.free(block));
+}
+
+TEST(mem_slab, cross_thread_free) {
+    mem::slab slab;
+    constexpr size_t COUNT = 20000;
+    std::vector<void *> blocks(COUNT);
+    // this thread has a cache of its own, so it cannot just adopt the
+    // producer's
+    EXPECT_TRUE(slab.free(slab.malloc(16)));
+    std::thread producer([&] {
+        for (size_t i = 0; i < COUNT; ++i) {
+            blocks[i] = slab.malloc(16 + i % 512);
+            memset(blocks[i], static_cast<int>(i), 16);
+        }
+    });
+    producer.join();
+    std::vector<std::thread> consumers;
+    for (size_t t = 0; t < 4; ++t) {
+        consumers.emplace_back([&, t] {
+            for (size_t i = t; i < COUNT; i += 4) {
+                EXPECT_TRUE(slab.free(blocks[i]));
+            }
+        });
+    }
+    for (auto &consumer : consumers) {
+        consumer.join();
+    }
+    // the frees went to the exited producer's cache; its spans come back
+    // to the pool instead of new regions being reserved
+    const size_t reserved = slab.reserved_bytes();
+    for (size_t i = 0; i < COUNT; ++i) {
+        blocks[i] = slab.malloc(16 + i % 512);
+        ASSERT_NE(blocks[i], nullptr);
+    }
+    EXPECT_EQ(slab.reserved_bytes(), reserved);
+    for (const auto block : blocks) {
+        EXPECT_TRUE(slab.free(block));
+    }
+}
+
+TEST(mem_slab, thread_churn) {
+    mem::slab slab;
+    std::vector<void *> held;
+    size_t reserved = 0;
+    for (int round = 0; round < 50; ++round) {
+        // each thread frees what the last one left and leaves live blocks
+        // of its own behind
+        std::thread([&] {
+            for (const auto block : held) {
+                EXPECT_TRUE(slab.free(block));
+            }
+            held.clear();
+            for (size_t i = 0; i < 2000; ++i) {
+                held.push_back(slab.malloc(32 + i % 1024));
+            }
+        }).join();
+        if (round == 1) {
+            reserved = slab.reserved_bytes();
+        }
+    }
+    // exited threads' caches are adopted with their spans
+    EXPECT_EQ(slab.reserved_bytes(), reserved);
+    for (const auto block : held) {
+        EXPECT_TRUE(slab.free(block));
+    }
+}
+
+TEST(mem_slab, concurrent) {
+    mem::slab slab;
+    std::vector<std::thread> threads;
+    std::vector<void *> shared(8 * 1000);
+    for (size_t t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t] {
+            for (int round = 0; round < 50; ++round) {
+                for (size_t i = 0; i < 1000; ++i) {
+                    void *block = slab.malloc((i * 37 + t) % 4096);
+                    ASSERT_NE(block, nullptr);
+                    EXPECT_TRUE(slab.free(block));
+                }
+            }
+            for (size_t i = 0; i < 1000; ++i) {
+                shared[t * 1000 + i] = slab.malloc(i % 2048);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (const auto block : shared) {
+        EXPECT_TRUE(slab.free(block));
+    }
+}
+
+TEST(mem_slab, release) {
+    mem::slab slab;
+    for (int i = 0; i < 1000; ++i) {
+        slab.malloc(256);
+    }
+    slab.malloc(1024 * 1024);
+    EXPECT_GT(slab.reserved_bytes(), 0u);
+    slab.release();
+    EXPECT_EQ(slab.reserved_bytes(), 0u);
+    void *block = slab.malloc(256);
+    ASSERT_NE(block, nullptr);
+    EXPECT_TRUE(slab.free(block));
+}
@@ -0,0 +1,285 @@
+#include "alloc_counter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#if defined(_MSC_VER) && defined(_DEBUG)
+#include <crtdbg.h>
+#endif
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+namespace {
+    thread_local uint64_t t_count = 0;
+    thread_local uint64_t t_bytes = 0;
+    thread_local uint64_t t_frees = 0;
+    // set while operator new/delete call into the CRT, so the CRT hook does
+    // not count the same block twice
+    thread_local bool t_in_operator = false;
+
+    std::atomic<uint64_t> g_count{0};
+    std::atomic<uint64_t> g_bytes{0};
+    std::atomic<uint64_t> g_frees{0};
+
+    void record_alloc(const size_t size) {
+        ++t_count;
+        t_bytes += size;
+        g_count.fetch_add(1, std::memory_order_relaxed);
+        g_bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void record_free() {
+        ++t_frees;
+        g_frees.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void *counted_alloc(const size_t size) {
+        record_alloc(size);
+        t_in_operator = true;
+        void *ptr = std::malloc(size ? size : 1);
+        t_in_operator = false;
+        return ptr;
+    }
+
+    void counted_free(void *ptr) {
+        if (!ptr) {
+            return;
+        }
+        record_free();
+        t_in_operator = true;
+        std::free(ptr);
+        t_in_operator = false;
+    }
+
+    void *counted_aligned_alloc(const size_t size, const std::align_val_t al) {
+        const auto align = static_cast<size_t>(al);
+        record_alloc(size);
+        t_in_operator = true;
+#if defined(_MSC_VER)
+        void *ptr = _aligned_malloc(size ? size : 1, align);
+#else
+        void *ptr = nullptr;
+        if (posix_memalign(&ptr, align < sizeof(void *) ? sizeof(void *)
+                                                        : align,
+                           size ? size : 1)) {
+            ptr = nullptr;
+        }
+#endif
+        t_in_operator = false;
+        return ptr;
+    }
+
+    void counted_aligned_free(void *ptr) {
+        if (!ptr) {
+            return;
+        }
+        record_free();
+        t_in_operator = true;
+#if defined(_MSC_VER)
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+        t_in_operator = false;
+    }
+
+#if defined(_MSC_VER) && defined(_DEBUG)
+    int crt_alloc_hook(const int alloc_type,
+                       void *,
+                       const size_t size,
+                       const int block_type,
+                       long,
+                       const unsigned char *,
+                       int) {
+        if (block_type == _CRT_BLOCK || t_in_operator) {
+            return 1;
+        }
+        if (alloc_type == _HOOK_ALLOC || alloc_type == _HOOK_REALLOC) {
+            record_alloc(size);
+        } else if (alloc_type == _HOOK_FREE) {
+            record_free();
+        }
+        return 1;
+    }
+
+    const _CRT_ALLOC_HOOK g_prev_hook = _CrtSetAllocHook(crt_alloc_hook);
+#endif
+} // namespace
+
+void *operator new(const size_t size) {
+    if (void *ptr = counted_alloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](const size_t size) {
+    if (void *ptr = counted_alloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(const size_t size, const std::nothrow_t &) noexcept {
+    return counted_alloc(size);
+}
+
+void *operator new[](const size_t size, const std::nothrow_t &) noexcept {
+    return counted_alloc(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    counted_free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    counted_free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    counted_free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+    counted_free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    counted_free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+    counted_free(ptr);
+}
+
+void *operator new(const size_t size, const std::align_val_t align) {
+    if (void *ptr = counted_aligned_alloc(size, align)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](const size_t size, const std::align_val_t align) {
+    if (void *ptr = counted_aligned_alloc(size, align)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(const size_t size,
+                   const std::align_val_t align,
+                   const std::nothrow_t &) noexcept {
+    return counted_aligned_alloc(size, align);
+}
+
+void *operator new[](const size_t size,
+                     const std::align_val_t align,
+                     const std::nothrow_t &) noexcept {
+    return counted_aligned_alloc(size, align);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+    counted_aligned_free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+    counted_aligned_free(ptr);
+}
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept {
+    counted_aligned_free(ptr);
+}
+
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept {
+    counted_aligned_free(ptr);
+}
+
+void operator delete(void *ptr,
+                     std::align_val_t,
+                     const std::nothrow_t &) noexcept {
+    counted_aligned_free(ptr);
+}
+
+void operator delete[](void *ptr,
+                       std::align_val_t,
+                       const std::nothrow_t &) noexcept {
+    counted_aligned_free(ptr);
+}
+
+#if ALLOC_COUNTER_HOOKS_MALLOC && defined(__GLIBC__)
+// glibc lets the executable interpose the C allocator and keeps its own
+// entry points under __libc_*; blocks from the other glibc allocation
+// functions (posix_memalign, ...) are freed through here as well
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size) {
+    if (!t_in_operator) {
+        record_alloc(size);
+    }
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    if (!t_in_operator) {
+        record_alloc(count * size);
+    }
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    if (!t_in_operator) {
+        record_alloc(size);
+    }
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+    if (ptr && !t_in_operator) {
+        record_free();
+    }
+    __libc_free(ptr);
+}
+}
+#endif
+
+namespace support {
+    alloc_stats thread_alloc_stats() {
+        return {t_count, t_bytes, t_frees};
+    }
+
+    alloc_stats global_alloc_stats() {
+        return {g_count.load(std::memory_order_relaxed),
+                g_bytes.load(std::memory_order_relaxed),
+                g_frees.load(std::memory_order_relaxed)};
+    }
+
+    alloc_counter::alloc_counter() {
+        begin = thread_alloc_stats();
+    }
+
+    void alloc_counter::reset() {
+        begin = thread_alloc_stats();
+    }
+
+    alloc_stats alloc_counter::stats() const {
+        const alloc_stats now = thread_alloc_stats();
+        return {now.count - begin.count, now.bytes - begin.bytes,
+                now.frees - begin.frees};
+    }
+
+    uint64_t alloc_counter::count() const {
+        return stats().count;
+    }
+
+    uint64_t alloc_counter::bytes() const {
+        return stats().bytes;
+    }
+
+    uint64_t alloc_counter::frees() const {
+        return stats().frees;
+    }
+} // namespace support
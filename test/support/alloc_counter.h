@@ -0,0 +1,97 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+#include <cstdint>
+
+// Linking alloc_counter replaces the global operator new/delete family,
+// aligned forms included, so tests can assert how many heap blocks a code
+// region takes. malloc/calloc/realloc/free are counted too where they can be
+// hooked: the MSVC debug CRT, and glibc builds without a sanitizer (which
+// brings its own malloc). Elsewhere ALLOC_COUNTER_HOOKS_MALLOC is 0 and
+// direct C allocations go uncounted. Counts are kept per thread, so work
+// done by other threads does not leak into a region.
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) ||     \
+        __has_feature(memory_sanitizer)
+#define ALLOC_COUNTER_SANITIZED_ 1
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define ALLOC_COUNTER_SANITIZED_ 1
+#endif
+
+#if (defined(_MSC_VER) && defined(_DEBUG)) ||                                  \
+        (defined(__GLIBC__) && !defined(ALLOC_COUNTER_SANITIZED_))
+#define ALLOC_COUNTER_HOOKS_MALLOC 1
+#else
+#define ALLOC_COUNTER_HOOKS_MALLOC 0
+#endif
+
+namespace support {
+    struct alloc_stats {
+        uint64_t count = 0;
+        uint64_t bytes = 0;
+        uint64_t frees = 0;
+    };
+
+    // totals of the calling thread since it started
+    alloc_stats thread_alloc_stats();
+
+    // totals of every thread since process start
+    alloc_stats global_alloc_stats();
+
+    class alloc_counter {
+    private:
+        alloc_stats begin = {};
+
+    public:
+        alloc_counter(const alloc_counter &other) = delete;
+
+        alloc_counter(alloc_counter &&other) = delete;
+
+        alloc_counter &operator=(const alloc_counter &other) = delete;
+
+        alloc_counter &operator=(alloc_counter &&other) = delete;
+
+        alloc_counter();
+
+        ~alloc_counter() = default;
+
+        void reset();
+
+        [[nodiscard]] alloc_stats stats() const;
+
+        [[nodiscard]] uint64_t count() const;
+
+        [[nodiscard]] uint64_t bytes() const;
+
+        [[nodiscard]] uint64_t frees() const;
+    };
+} // namespace support
+
+#define ALLOC_COUNTER_CHECK_(check, field, expected, statement)               \
+    do {                                                                       \
+        ::support::alloc_counter alloc_counter_region_;                        \
+        {                                                                      \
+            statement;                                                         \
+        }                                                                      \
+        const uint64_t alloc_counter_value_ = alloc_counter_region_.field();   \
+        check(alloc_counter_value_, static_cast<uint64_t>(expected))           \
+                << #field " of: " #statement;                                  \
+    } while (false)
+
+#define EXPECT_ALLOCS(expected, statement)                                     \
+    ALLOC_COUNTER_CHECK_(EXPECT_EQ, count, expected, statement)
+
+#define ASSERT_ALLOCS(expected, statement)                                     \
+    ALLOC_COUNTER_CHECK_(ASSERT_EQ, count, expected, statement)
+
+#define EXPECT_ALLOC_BYTES(expected, statement)                                \
+    ALLOC_COUNTER_CHECK_(EXPECT_EQ, bytes, expected, statement)
+
+#define ASSERT_ALLOC_BYTES(expected, statement)                                \
+    ALLOC_COUNTER_CHECK_(ASSERT_EQ, bytes, expected, statement)
+
+#define EXPECT_NO_ALLOC(statement) EXPECT_ALLOCS(0, statement)
+
+#define ASSERT_NO_ALLOC(statement) ASSERT_ALLOCS(0, statement)
+#endif // ALLOC_COUNTER_H
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+#include "support/alloc_counter.h"
+
+class support_alloc_counter : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sink = nullptr;
+    }
+
+    // volatile keeps new/delete pairs from being elided
+    static inline int *volatile sink = nullptr;
+};
+
+TEST_F(support_alloc_counter, count_and_bytes) {
+    EXPECT_ALLOCS(1, {
+        sink = new int(7);
+        delete sink;
+    });
+    EXPECT_ALLOC_BYTES(sizeof(int) * 16, {
+        sink = new int[16];
+        delete[] sink;
+    });
+    EXPECT_NO_ALLOC({
+        int value = 7;
+        sink = &value;
+    });
+
+    support::alloc_counter counter;
+    std::vector<uint8_t> data(100);
+    EXPECT_EQ(counter.count(), 1);
+    EXPECT_GE(counter.bytes(), 100);
+    data.clear();
+    data.shrink_to_fit();
+    EXPECT_EQ(counter.frees(), 1);
+    counter.reset();
+    EXPECT_EQ(counter.count(), 0);
+    EXPECT_EQ(counter.bytes(), 0);
+    EXPECT_EQ(counter.frees(), 0);
+}
+
+TEST_F(support_alloc_counter, per_thread) {
+    std::atomic<int> stage{0};
+    std::thread worker([&stage] {
+        while (stage.load() != 1) {
+            std::this_thread::yield();
+        }
+        for (int i = 0; i < 8; ++i) {
+            sink = new int(i);
+            delete sink;
+        }
+        stage.store(2);
+    });
+
+    const support::alloc_stats global_begin = support::global_alloc_stats();
+    EXPECT_NO_ALLOC({
+        stage.store(1);
+        while (stage.load() != 2) {
+            std::this_thread::yield();
+        }
+    });
+    worker.join();
+    const support::alloc_stats global_end = support::global_alloc_stats();
+    EXPECT_GE(global_end.count - global_begin.count, 8);
+}
+
+TEST_F(support_alloc_counter, aligned) {
+    struct alignas(64) line {
+        uint8_t data[64];
+    };
+    static line *volatile block = nullptr;
+    EXPECT_ALLOCS(1, {
+        block = new line;
+        delete block;
+    });
+    EXPECT_ALLOC_BYTES(4096, {
+        void *volatile raw = ::operator new(4096, std::align_val_t(4096));
+        ::operator delete(raw, std::align_val_t(4096));
+    });
+}
+
+#if ALLOC_COUNTER_HOOKS_MALLOC
+TEST_F(support_alloc_counter, crt_malloc) {
+    EXPECT_ALLOCS(1, {
+        void *volatile block = std::malloc(32);
+        std::free(block);
+    });
+}
+#endif
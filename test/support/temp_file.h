@@ -0,0 +1,22 @@
+#ifndef TEMP_FILE_H
+#define TEMP_FILE_H
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace support {
+    // writes data to name in the temp directory, replacing any old file,
+    // and returns the full path; the caller removes it
+    inline std::string write_temp(const std::string &name,
+                                  const std::vector<uint8_t> &data) {
+        const std::filesystem::path path =
+                std::filesystem::temp_directory_path() / name;
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(data.data()),
+                  static_cast<std::streamsize>(data.size()));
+        return path.string();
+    }
+} // namespace support
+#endif // TEMP_FILE_H
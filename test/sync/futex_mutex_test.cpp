@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "sync/futex_mutex.h"
+using YanLib::sync::futex_mutex;
+
+TEST(sync_futex_mutex, try_lock) {
+    futex_mutex mutex;
+    EXPECT_TRUE(mutex.try_lock());
+    EXPECT_FALSE(mutex.try_lock());
+    mutex.unlock();
+    {
+        std::lock_guard<futex_mutex> lock(mutex);
+        EXPECT_FALSE(mutex.try_lock());
+    }
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+}
+
+TEST(sync_futex_mutex, contended) {
+    // with and without spinning, the second parks on every miss
+    for (const uint32_t spin_limit : {100u, 0u}) {
+        futex_mutex mutex(spin_limit);
+        uint64_t counter = 0;
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 8; ++i) {
+            threads.emplace_back([&] {
+                for (int j = 0; j < 20000; ++j) {
+                    std::lock_guard<futex_mutex> lock(mutex);
+                    ++counter;
+                }
+            });
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+        EXPECT_EQ(counter, 8u * 20000);
+    }
+}
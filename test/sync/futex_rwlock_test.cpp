@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "sync/futex_rwlock.h"
+using YanLib::sync::futex_rwlock;
+
+TEST(sync_futex_rwlock, try_locks) {
+    futex_rwlock lock;
+    EXPECT_TRUE(lock.try_read_lock());
+    EXPECT_TRUE(lock.try_read_lock());
+    EXPECT_FALSE(lock.try_write_lock());
+    lock.read_unlock();
+    lock.read_unlock();
+    EXPECT_TRUE(lock.try_write_lock());
+    EXPECT_FALSE(lock.try_read_lock());
+    EXPECT_FALSE(lock.try_write_lock());
+    lock.write_unlock();
+    lock.read_lock();
+    lock.read_unlock();
+}
+
+TEST(sync_futex_rwlock, readers_and_writers) {
+    futex_rwlock lock;
+    // a writer keeps both halves equal, readers must never see them differ
+    uint64_t a = 0, b = 0;
+    std::atomic<int> torn{0};
+    std::atomic<int> shared{0};
+    std::atomic<int> max_shared{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < 10000; ++j) {
+                lock.write_lock();
+                ++a;
+                ++b;
+                lock.write_unlock();
+            }
+        });
+    }
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < 20000; ++j) {
+                lock.read_lock();
+                const int now = ++shared;
+                int seen = max_shared.load();
+                while (now > seen &&
+                       !max_shared.compare_exchange_weak(seen, now)) {
+                }
+                if (a != b) {
+                    ++torn;
+                }
+                --shared;
+                lock.read_unlock();
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(a, 40000u);
+    EXPECT_EQ(b, 40000u);
+    EXPECT_GE(max_shared.load(), 1);
+}
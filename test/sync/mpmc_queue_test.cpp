@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sync/mpmc_queue.h"
+using YanLib::sync::mpmc_queue;
+
+TEST(sync_mpmc_queue, fifo_and_bounds) {
+    mpmc_queue<std::string> queue(3);
+    EXPECT_EQ(queue.capacity(), 4u);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.try_push(std::to_string(i)));
+    }
+    EXPECT_FALSE(queue.try_push("full"));
+    EXPECT_EQ(queue.size_approx(), 4u);
+    std::string out;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.try_pop(out));
+        EXPECT_EQ(out, std::to_string(i));
+    }
+    EXPECT_FALSE(queue.try_pop(out));
+}
+
+TEST(sync_mpmc_queue, batch) {
+    mpmc_queue<int> queue(8);
+    int in[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    EXPECT_EQ(queue.try_push_batch(in, 10), 8u);
+    int out[10] = {};
+    EXPECT_EQ(queue.try_pop_batch(out, 3), 3u);
+    EXPECT_EQ(queue.try_push_batch(in + 8, 2), 2u);
+    EXPECT_EQ(queue.try_pop_batch(out + 3, 10), 7u);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(out[i], i);
+    }
+    EXPECT_EQ(queue.try_pop_batch(out, 10), 0u);
+}
+
+TEST(sync_mpmc_queue, leftovers_destroyed) {
+    const auto item = std::make_shared<int>(1);
+    {
+        mpmc_queue<std::shared_ptr<int>> queue(4);
+        queue.try_push(item);
+        queue.try_push(item);
+        EXPECT_EQ(item.use_count(), 3);
+    }
+    EXPECT_EQ(item.use_count(), 1);
+}
+
+TEST(sync_mpmc_queue, producers_and_consumers) {
+    // small enough that both sides block on each other now and then
+    mpmc_queue<uint64_t> queue(16);
+    constexpr uint64_t per_producer = 50000;
+    constexpr int producers = 3;
+    constexpr int consumers = 3;
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> count{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (uint64_t i = 1; i <= per_producer; ++i) {
+                const uint64_t value = i + p * per_producer;
+                if (i % 3 == 0) {
+                    while (!queue.try_push(value)) {
+                        std::this_thread::yield();
+                    }
+                } else {
+                    queue.push(value);
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            uint64_t batch[8];
+            while (count.load() < per_producer * producers) {
+                size_t n = 0;
+                if (c == 0) {
+                    n = queue.try_pop_batch(batch, 8);
+                } else if (queue.try_pop(batch[0])) {
+                    n = 1;
+                }
+                for (size_t i = 0; i < n; ++i) {
+                    sum += batch[i];
+                }
+                count += n;
+                if (!n) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    const uint64_t total = per_producer * producers;
+    EXPECT_EQ(count.load(), total);
+    EXPECT_EQ(sum.load(), total * (total + 1) / 2);
+}
+
+TEST(sync_mpmc_queue, blocking_pop) {
+    mpmc_queue<int> queue(2);
+    constexpr int items = 20000;
+    std::atomic<int64_t> sum{0};
+    std::vector<std::thread> consumers;
+    for (int i = 0; i < 2; ++i) {
+        consumers.emplace_back([&] {
+            while (true) {
+                const int value = queue.pop();
+                if (value < 0) {
+                    break;
+                }
+                sum += value;
+            }
+        });
+    }
+    for (int i = 1; i <= items; ++i) {
+        queue.push(i);
+    }
+    queue.push(-1);
+    queue.push(-1);
+    for (auto &t : consumers) {
+        t.join();
+    }
+    EXPECT_EQ(sum.load(), int64_t{items} * (items + 1) / 2);
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "sync/percpu_rwlock.h"
+using YanLib::sync::percpu_rwlock;
+
+TEST(sync_percpu_rwlock, try_locks) {
+    percpu_rwlock lock(6);
+    EXPECT_EQ(lock.slot_count(), 8u);
+    EXPECT_TRUE(lock.try_read_lock());
+    EXPECT_FALSE(lock.try_write_lock());
+    // a reader on another slot as well
+    std::thread([&] {
+        EXPECT_TRUE(lock.try_read_lock());
+        lock.read_unlock();
+    }).join();
+    lock.read_unlock();
+    EXPECT_TRUE(lock.try_write_lock());
+    EXPECT_FALSE(lock.try_read_lock());
+    std::thread([&] { EXPECT_FALSE(lock.try_write_lock()); }).join();
+    lock.write_unlock();
+    lock.read_lock();
+    lock.read_unlock();
+}
+
+TEST(sync_percpu_rwlock, readers_and_writers) {
+    // fewer slots than threads, so slots are shared too
+    percpu_rwlock lock(4);
+    uint64_t a = 0, b = 0;
+    std::atomic<int> torn{0};
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> readers;
+    std::atomic<uint64_t> reads{0};
+    for (int i = 0; i < 6; ++i) {
+        readers.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                lock.read_lock();
+                if (a != b) {
+                    ++torn;
+                }
+                lock.read_unlock();
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 2; ++i) {
+        writers.emplace_back([&] {
+            for (int j = 0; j < 5000; ++j) {
+                lock.write_lock();
+                ++a;
+                ++b;
+                lock.write_unlock();
+            }
+        });
+    }
+    for (auto &t : writers) {
+        t.join();
+    }
+    stop = true;
+    for (auto &t : readers) {
+        t.join();
+    }
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(a, 10000u);
+    EXPECT_EQ(b, 10000u);
+    EXPECT_GT(reads.load(), 0u);
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "sync/rcu.h"
+using YanLib::sync::rcu;
+using YanLib::sync::rcu_guard;
+using YanLib::sync::rcu_ptr;
+
+namespace {
+    std::atomic<int> live{0};
+
+    struct table {
+        std::vector<uint64_t> values;
+        bool retired = false;
+
+        explicit table(const uint64_t version) : values(64, version) {
+            live.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        ~table() {
+            retired = true;
+            live.fetch_sub(1, std::memory_order_relaxed);
+        }
+    };
+} // namespace
+
+TEST(sync_rcu, publish) {
+    {
+        rcu_ptr<table> ptr;
+        {
+            rcu_guard guard;
+            EXPECT_EQ(ptr.read(), nullptr);
+            auto first = std::make_unique<table>(1);
+            EXPECT_TRUE(ptr.publish_if_empty(first));
+            EXPECT_EQ(first, nullptr);
+            auto second = std::make_unique<table>(2);
+            EXPECT_FALSE(ptr.publish_if_empty(second));
+            EXPECT_NE(second, nullptr);
+            EXPECT_EQ(ptr.read()->values[0], 1u);
+        }
+        ptr.publish(std::make_unique<table>(3));
+        rcu_guard guard;
+        EXPECT_EQ(ptr.read()->values[0], 3u);
+        EXPECT_EQ(live.load(), 1);
+    }
+    EXPECT_EQ(live.load(), 0);
+}
+
+TEST(sync_rcu, nested_sections) {
+    rcu::read_lock();
+    rcu::read_lock();
+    rcu::read_unlock();
+    rcu::read_unlock();
+    // a thread outside any section never holds up a grace period
+    rcu::synchronize();
+}
+
+TEST(sync_rcu, synchronize_waits_for_readers) {
+    std::atomic<bool> inside{false};
+    std::atomic<bool> leave{false};
+    std::atomic<bool> left{false};
+    std::thread reader([&] {
+        rcu_guard guard;
+        inside.store(true);
+        while (!leave.load()) {
+            std::this_thread::yield();
+        }
+        left.store(true);
+    });
+    while (!inside.load()) {
+        std::this_thread::yield();
+    }
+    std::thread writer([&] {
+        rcu::synchronize();
+        EXPECT_TRUE(left.load());
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    leave.store(true);
+    writer.join();
+    reader.join();
+}
+
+TEST(sync_rcu, new_reader_during_grace_period) {
+    std::atomic<bool> inside{false};
+    std::atomic<bool> leave{false};
+    std::thread reader([&] {
+        rcu_guard guard;
+        inside.store(true);
+        while (!leave.load()) {
+            std::this_thread::yield();
+        }
+    });
+    while (!inside.load()) {
+        std::this_thread::yield();
+    }
+    std::thread writer([] { rcu::synchronize(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    // a thread registering while the writer waits must not wait with it
+    std::atomic<bool> done{false};
+    std::thread late([&] {
+        rcu_guard guard;
+        done.store(true);
+    });
+    for (int i = 0; i < 200 && !done.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_TRUE(done.load());
+    leave.store(true);
+    late.join();
+    writer.join();
+    reader.join();
+    // exited threads leave their records idle for the next ones
+    std::vector<std::thread> churn;
+    for (int i = 0; i < 8; ++i) {
+        churn.emplace_back([] { rcu_guard guard; });
+    }
+    for (auto &t : churn) {
+        t.join();
+    }
+    rcu::synchronize();
+}
+
+TEST(sync_rcu, readers_and_writers) {
+    rcu_ptr<table> ptr(std::make_unique<table>(0));
+    std::atomic<bool> done{false};
+    std::atomic<int> bad{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i) {
+        readers.emplace_back([&] {
+            uint64_t last = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                rcu_guard guard;
+                const table *t = ptr.read();
+                const uint64_t version = t->values.front();
+                for (const uint64_t v : t->values) {
+                    if (v != version || t->retired) {
+                        bad.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                if (version < last) {
+                    bad.fetch_add(1, std::memory_order_relaxed);
+                }
+                last = version;
+            }
+        });
+    }
+    for (uint64_t version = 1; version <= 200; ++version) {
+        ptr.publish(std::make_unique<table>(version));
+    }
+    done.store(true, std::memory_order_release);
+    for (auto &t : readers) {
+        t.join();
+    }
+    EXPECT_EQ(bad.load(), 0);
+    EXPECT_EQ(live.load(), 1);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "sync/seqlock.h"
+using YanLib::sync::seqlock;
+
+namespace {
+    // every field derives from seq, so a torn copy is easy to spot
+    struct stats {
+        uint64_t seq;
+        uint64_t twice;
+        uint32_t low;
+        uint8_t tag;
+    };
+
+    stats make_stats(const uint64_t seq) {
+        return {seq, seq * 2, static_cast<uint32_t>(seq),
+                static_cast<uint8_t>(seq % 251)};
+    }
+
+    bool consistent(const stats &s) {
+        return s.twice == s.seq * 2 && s.low == static_cast<uint32_t>(s.seq) &&
+               s.tag == s.seq % 251;
+    }
+} // namespace
+
+TEST(sync_seqlock, store_load) {
+    seqlock<stats> lock(make_stats(7));
+    EXPECT_EQ(lock.load().seq, 7u);
+    lock.store(make_stats(9));
+    stats out{};
+    EXPECT_TRUE(lock.try_load(out));
+    EXPECT_EQ(out.seq, 9u);
+    EXPECT_TRUE(consistent(out));
+    lock.update([](stats &s) { s = make_stats(s.seq + 1); });
+    EXPECT_EQ(lock.load().seq, 10u);
+
+    seqlock<uint16_t> small;
+    EXPECT_EQ(small.load(), 0);
+    small.store(0xBEEF);
+    EXPECT_EQ(small.load(), 0xBEEF);
+}
+
+TEST(sync_seqlock, readers_never_see_torn_values) {
+    seqlock<stats> lock(make_stats(0));
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i) {
+        readers.emplace_back([&] {
+            uint64_t last = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                const stats s = lock.load();
+                if (!consistent(s) || s.seq < last) {
+                    torn.fetch_add(1, std::memory_order_relaxed);
+                }
+                last = s.seq;
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 2; ++i) {
+        writers.emplace_back([&] {
+            for (int n = 0; n < 20000; ++n) {
+                lock.update([](stats &s) { s = make_stats(s.seq + 1); });
+            }
+        });
+    }
+    for (auto &t : writers) {
+        t.join();
+    }
+    done.store(true, std::memory_order_release);
+    for (auto &t : readers) {
+        t.join();
+    }
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(lock.load().seq, 40000u);
+}
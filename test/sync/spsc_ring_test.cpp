@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include "sync/spsc_ring.h"
+using YanLib::sync::spsc_ring;
+
+TEST(sync_spsc_ring, fifo_and_batch) {
+    spsc_ring<std::unique_ptr<int>> ring(5);
+    EXPECT_EQ(ring.capacity(), 8u);
+    std::unique_ptr<int> in[10];
+    for (int i = 0; i < 10; ++i) {
+        in[i] = std::make_unique<int>(i);
+    }
+    EXPECT_TRUE(ring.try_push(std::move(in[0])));
+    EXPECT_EQ(ring.try_push_batch(in + 1, 9), 7u);
+    EXPECT_FALSE(ring.try_push(std::make_unique<int>(-1)));
+    std::unique_ptr<int> out[10];
+    EXPECT_EQ(ring.try_pop_batch(out, 2), 2u);
+    EXPECT_EQ(ring.try_push_batch(in + 8, 2), 2u);
+    EXPECT_EQ(ring.size_approx(), 8u);
+    EXPECT_EQ(ring.try_pop_batch(out + 2, 10), 8u);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(out[i]);
+        EXPECT_EQ(*out[i], i);
+    }
+    EXPECT_FALSE(ring.try_pop(out[0]));
+    // left in the ring, freed by its destructor
+    ring.try_push(std::make_unique<int>(7));
+}
+
+TEST(sync_spsc_ring, producer_consumer) {
+    spsc_ring<uint64_t> ring(64);
+    constexpr uint64_t items = 500000;
+    std::thread producer([&] {
+        uint64_t batch[16];
+        uint64_t next = 1;
+        while (next <= items) {
+            if (next % 1000 < 16) {
+                ring.push(next++);
+                continue;
+            }
+            size_t n = 0;
+            while (n < 16 && next + n <= items) {
+                batch[n] = next + n;
+                ++n;
+            }
+            next += ring.try_push_batch(batch, n);
+        }
+    });
+    uint64_t expected = 1;
+    bool in_order = true;
+    while (expected <= items) {
+        const uint64_t value = ring.pop();
+        in_order = in_order && value == expected;
+        ++expected;
+    }
+    producer.join();
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(ring.size_approx(), 0u);
+}
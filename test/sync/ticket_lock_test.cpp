@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "sync/ticket_lock.h"
+using YanLib::sync::ticket_lock;
+
+TEST(sync_ticket_lock, try_lock) {
+    ticket_lock lock;
+    EXPECT_TRUE(lock.try_lock());
+    EXPECT_FALSE(lock.try_lock());
+    lock.unlock();
+    EXPECT_TRUE(lock.try_lock());
+    lock.unlock();
+}
+
+TEST(sync_ticket_lock, fifo) {
+    ticket_lock lock;
+    std::vector<int> order;
+    lock.lock();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&, i] {
+            std::lock_guard<ticket_lock> guard(lock);
+            order.push_back(i);
+        });
+        // let thread i draw its ticket before the next one starts
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    lock.unlock();
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3}));
+}
+
+TEST(sync_ticket_lock, contended) {
+    for (const uint32_t spin_limit : {100u, 0u}) {
+        ticket_lock lock(spin_limit);
+        uint64_t counter = 0;
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 6; ++i) {
+            threads.emplace_back([&] {
+                for (int j = 0; j < 5000; ++j) {
+                    std::lock_guard<ticket_lock> guard(lock);
+                    ++counter;
+                }
+            });
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+        EXPECT_EQ(counter, 6u * 5000);
+    }
+}
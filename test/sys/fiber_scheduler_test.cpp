@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "sys/fiber_scheduler.h"
+namespace sys = YanLib::sys;
+using std::chrono::milliseconds;
+
+TEST(sys_fiber_scheduler, spawn_and_yield) {
+    std::atomic<int> steps{0};
+    {
+        sys::fiber_scheduler fibers(4);
+        EXPECT_EQ(fibers.size(), 4u);
+        for (int i = 0; i < 1000; ++i) {
+            ASSERT_TRUE(fibers.spawn([&] {
+                for (int j = 0; j < 10; ++j) {
+                    EXPECT_TRUE(sys::fiber_scheduler::in_fiber());
+                    steps.fetch_add(1, std::memory_order_relaxed);
+                    sys::fiber_scheduler::yield();
+                }
+            }));
+        }
+        fibers.wait();
+        EXPECT_EQ(steps.load(), 10000);
+        EXPECT_EQ(fibers.active(), 0u);
+        // finished fibers are reused
+        ASSERT_TRUE(fibers.spawn([&] { ++steps; }));
+        // the destructor waits for it
+    }
+    EXPECT_EQ(steps.load(), 10001);
+    EXPECT_FALSE(sys::fiber_scheduler::in_fiber());
+}
+
+TEST(sys_fiber_scheduler, yield_lets_others_run) {
+    // one carrier: a fiber spinning on yield() must give the turn to a
+    // fiber spawned from inside it and to one spawned from outside
+    sys::fiber_scheduler fibers(1);
+    std::atomic<bool> inner{false};
+    std::atomic<bool> outer{false};
+    std::atomic<int> spins{0};
+    fibers.spawn([&] {
+        fibers.spawn([&] { inner = true; });
+        while (!inner.load() || !outer.load()) {
+            ++spins;
+            sys::fiber_scheduler::yield();
+        }
+    });
+    fibers.spawn([&] { outer = true; });
+    fibers.wait();
+    EXPECT_TRUE(inner.load());
+    EXPECT_TRUE(outer.load());
+    EXPECT_GE(spins.load(), 1);
+}
+
+TEST(sys_fiber_scheduler, nested_spawn) {
+    sys::fiber_scheduler fibers(2);
+    std::atomic<int> leaves{0};
+    for (int i = 0; i < 32; ++i) {
+        fibers.spawn([&] {
+            for (int j = 0; j < 32; ++j) {
+                fibers.spawn([&] { ++leaves; });
+            }
+        });
+    }
+    fibers.wait();
+    EXPECT_EQ(leaves.load(), 32 * 32);
+}
+
+TEST(sys_fiber_scheduler, park_unpark) {
+    // a ping-pong between two fibers that hand each other the turn
+    sys::fiber_scheduler fibers(2);
+    std::atomic<sys::fiber_scheduler::green_thread *> ping{nullptr};
+    std::atomic<sys::fiber_scheduler::green_thread *> pong{nullptr};
+    std::atomic<int> turn{0};
+    constexpr int rounds = 2000;
+    auto player = [&](const int me,
+                      std::atomic<sys::fiber_scheduler::green_thread *> &self,
+                      std::atomic<sys::fiber_scheduler::green_thread *>
+                              &other) {
+        self = sys::fiber_scheduler::current();
+        while (!other.load()) {
+            sys::fiber_scheduler::yield();
+        }
+        for (int i = 0; i < rounds; ++i) {
+            while (turn.load() % 2 != me) {
+                sys::fiber_scheduler::park();
+            }
+            ++turn;
+            fibers.unpark(other.load());
+        }
+    };
+    fibers.spawn([&] { player(0, ping, pong); });
+    fibers.spawn([&] { player(1, pong, ping); });
+    fibers.wait();
+    EXPECT_EQ(turn.load(), rounds * 2);
+}
+
+TEST(sys_fiber_scheduler, sleep) {
+    sys::fiber_scheduler fibers(1);
+    std::atomic<int> woke{0};
+    std::atomic<int64_t> slept{0};
+    const auto begin = std::chrono::steady_clock::now();
+    // more sleepers than carriers, they only sleep in parallel if the
+    // carrier keeps running the others
+    for (int i = 0; i < 50; ++i) {
+        fibers.spawn([&] {
+            sys::fiber_scheduler::sleep_for(milliseconds(20));
+            ++woke;
+        });
+    }
+    fibers.wait();
+    slept = std::chrono::duration_cast<milliseconds>(
+                    std::chrono::steady_clock::now() - begin)
+                    .count();
+    EXPECT_EQ(woke.load(), 50);
+    EXPECT_GE(slept.load(), 19);
+    EXPECT_LT(slept.load(), 50 * 20);
+}
+
+TEST(sys_fiber_scheduler, blocking_and_event) {
+    sys::fiber_scheduler fibers(1);
+    sys::fiber_event ready(fibers);
+    std::atomic<int> waiting{0};
+    std::atomic<int> released{0};
+    for (int i = 0; i < 8; ++i) {
+        fibers.spawn([&] {
+            ++waiting;
+            ready.wait();
+            ++released;
+        });
+    }
+    std::atomic<int> result{0};
+    fibers.spawn([&] {
+        // the single carrier stays free for the waiters meanwhile
+        result = sys::fiber_scheduler::blocking([] {
+            std::this_thread::sleep_for(milliseconds(10));
+            return 42;
+        });
+        EXPECT_THROW(sys::fiber_scheduler::blocking(
+                             []() -> int { throw std::runtime_error("io"); }),
+                     std::runtime_error);
+        while (waiting.load() != 8) {
+            sys::fiber_scheduler::yield();
+        }
+        EXPECT_EQ(released.load(), 0);
+        ready.set();
+    });
+    fibers.wait();
+    EXPECT_EQ(result.load(), 42);
+    EXPECT_EQ(released.load(), 8);
+    // outside a fiber the calls fall back to the thread versions
+    EXPECT_EQ(sys::fiber_scheduler::blocking([] { return 7; }), 7);
+    ready.wait();
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "sys/scheduler.h"
+namespace sys = YanLib::sys;
+
+namespace {
+    struct counted_task : sys::task {
+        std::atomic<int> *counter = nullptr;
+
+        void run() override {
+            counter->fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    uint64_t fib(sys::scheduler &pool, const uint32_t n) {
+        if (n < 12) {
+            return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+        }
+        auto left = pool.submit([&pool, n] { return fib(pool, n - 1); });
+        const uint64_t right = fib(pool, n - 2);
+        return pool.wait(left) + right;
+    }
+} // namespace
+
+TEST(sys_work_deque, owner_and_thieves) {
+    constexpr int count = 100000;
+    std::vector<counted_task> tasks(count);
+    std::atomic<int> runs{0};
+    for (auto &t : tasks) {
+        t.counter = &runs;
+    }
+    // starts small, so the owner grows it while thieves read
+    sys::work_deque deque(16);
+    std::atomic<bool> done{false};
+    std::atomic<int> stolen{0};
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < 3; ++i) {
+        thieves.emplace_back([&] {
+            while (!done.load(std::memory_order_acquire) || !deque.empty()) {
+                if (sys::task *t = deque.steal()) {
+                    t->run();
+                    stolen.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    int popped = 0;
+    for (int i = 0; i < count; ++i) {
+        deque.push(&tasks[i]);
+        if (i % 3 == 0) {
+            if (sys::task *t = deque.pop()) {
+                t->run();
+                ++popped;
+            }
+        }
+    }
+    while (sys::task *t = deque.pop()) {
+        t->run();
+        ++popped;
+    }
+    done.store(true, std::memory_order_release);
+    for (auto &t : thieves) {
+        t.join();
+    }
+    EXPECT_EQ(runs.load(), count);
+    EXPECT_EQ(popped + stolen.load(), count);
+    EXPECT_TRUE(deque.empty());
+}
+
+TEST(sys_work_deque, lifo_for_owner) {
+    counted_task a, b;
+    sys::work_deque deque;
+    deque.push(&a);
+    deque.push(&b);
+    EXPECT_EQ(deque.size(), 2u);
+    EXPECT_EQ(deque.pop(), &b);
+    EXPECT_EQ(deque.steal(), &a);
+    EXPECT_EQ(deque.pop(), nullptr);
+    EXPECT_EQ(deque.steal(), nullptr);
+}
+
+TEST(sys_scheduler, submit) {
+    sys::scheduler pool(4);
+    EXPECT_EQ(pool.size(), 4u);
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 1000; ++i) {
+        results.push_back(pool.submit([i] { return i * 2; }));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(results[i].get(), i * 2);
+    }
+    auto failed = pool.submit([]() -> int {
+        throw std::runtime_error("task failed");
+    });
+    EXPECT_THROW(failed.get(), std::runtime_error);
+}
+
+TEST(sys_scheduler, nested_wait) {
+    sys::scheduler pool(4);
+    // tasks waiting on tasks they spawned must not run out of workers
+    auto result = pool.submit([&pool] { return fib(pool, 24); });
+    EXPECT_EQ(result.get(), 46368u);
+    EXPECT_EQ(fib(pool, 20), 6765u);
+}
+
+TEST(sys_scheduler, parallel_for) {
+    sys::scheduler pool(4);
+    std::vector<std::atomic<int>> hits(100003);
+    pool.parallel_for(3, hits.size(), [&](const size_t i) {
+        hits[i].fetch_add(1, std::memory_order_relaxed);
+    });
+    for (size_t i = 0; i < hits.size(); ++i) {
+        ASSERT_EQ(hits[i].load(), i < 3 ? 0 : 1) << i;
+    }
+
+    std::vector<uint64_t> values(50000);
+    std::iota(values.begin(), values.end(), 0);
+    std::atomic<uint64_t> sum{0};
+    pool.parallel_for(
+            0, values.size(),
+            [&](const size_t i) {
+                sum.fetch_add(values[i], std::memory_order_relaxed);
+            },
+            7);
+    EXPECT_EQ(sum.load(), 50000ULL * 49999 / 2);
+
+    pool.parallel_for(5, 5, [](size_t) { FAIL(); });
+    EXPECT_THROW(pool.parallel_for(0, 10000,
+                                   [](const size_t i) {
+                                       if (i == 4321) {
+                                           throw std::out_of_range("i");
+                                       }
+                                   }),
+                 std::out_of_range);
+}
+
+TEST(sys_scheduler, nested_parallel_for) {
+    sys::scheduler pool(3);
+    std::atomic<int> cells{0};
+    pool.parallel_for(0, 64, [&](size_t) {
+        pool.parallel_for(0, 64, [&](size_t) {
+            cells.fetch_add(1, std::memory_order_relaxed);
+        });
+    });
+    EXPECT_EQ(cells.load(), 64 * 64);
+}
+
+TEST(sys_scheduler, spawn_and_drain) {
+    std::atomic<int> runs{0};
+    std::vector<counted_task> tasks(5000);
+    {
+        sys::scheduler pool(2);
+        for (auto &t : tasks) {
+            t.counter = &runs;
+            pool.spawn(&t);
+        }
+        // the destructor runs whatever is still queued
+    }
+    EXPECT_EQ(runs.load(), 5000);
+}
+
+TEST(sys_scheduler, idle_wakeup) {
+    sys::scheduler pool(2);
+    for (int round = 0; round < 20; ++round) {
+        // long enough apart that the workers park in between
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        auto f = pool.submit([round] { return round; });
+        EXPECT_EQ(f.get(), round);
+    }
+}
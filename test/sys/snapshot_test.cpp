@@ -1,4 +1,8 @@
 #include <gtest/gtest.h>
+#include <Windows.h>
+#include <atomic>
+#include <thread>
+#include <vector>
 #include "sys/snapshot.h"
 namespace sys = YanLib::sys;
 
@@ -20,3 +24,31 @@ TEST_F(sys_snapshot, list_info) {
     auto heaps = snapshot.ls_heaps();
     EXPECT_GT(heaps.size(), 0);
 }
+
+TEST_F(sys_snapshot, lookups_during_refresh) {
+    const uint32_t self = GetCurrentProcessId();
+    const uint32_t tid = GetCurrentThreadId();
+    std::atomic<bool> done{false};
+    std::atomic<int> misses{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                if (!snapshot.pid_exists(self) ||
+                    snapshot.tid_to_pid(tid) != self) {
+                    ++misses;
+                }
+            }
+        });
+    }
+    for (int i = 0; i < 20; ++i) {
+        snapshot.refresh_procs();
+        snapshot.refresh_threads();
+        snapshot.refresh_modules();
+    }
+    done = true;
+    for (auto &t : readers) {
+        t.join();
+    }
+    EXPECT_EQ(misses.load(), 0);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include "sys/task_graph.h"
+namespace sys = YanLib::sys;
+
+TEST(sys_task_graph, diamond) {
+    sys::scheduler pool(4);
+    sys::task_graph graph;
+    std::mutex mutex;
+    std::vector<char> order;
+    auto record = [&](const char c) {
+        return [&, c] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(c);
+        };
+    };
+    const auto a = graph.add(record('a'));
+    const auto b = graph.add(record('b'), {a});
+    const auto c = graph.add(record('c'), {a});
+    graph.add(record('d'), {b, c});
+    ASSERT_TRUE(graph.run(pool));
+    ASSERT_EQ(order.size(), 4u);
+    EXPECT_EQ(order.front(), 'a');
+    EXPECT_EQ(order.back(), 'd');
+}
+
+TEST(sys_task_graph, pipeline_reuse) {
+    // read -> decode -> hash -> write for several independent blocks, run
+    // many times over the same graph
+    constexpr uint32_t blocks = 16;
+    sys::scheduler pool(4);
+    sys::task_graph graph;
+    std::vector<uint64_t> data(blocks);
+    std::vector<uint64_t> out(blocks);
+    std::atomic<int> stage_errors{0};
+    for (uint32_t i = 0; i < blocks; ++i) {
+        const auto read = graph.add([&data, i] { data[i] = i + 1; });
+        const auto decode =
+                graph.add([&data, i] { data[i] *= 3; }, {read});
+        const auto hash = graph.add(
+                [&data, i] { data[i] = data[i] * 0x9E3779B97F4A7C15ULL; },
+                {decode});
+        graph.add(
+                [&, i] {
+                    if (data[i] != (i + 1) * 3 * 0x9E3779B97F4A7C15ULL) {
+                        ++stage_errors;
+                    }
+                    out[i] += 1;
+                },
+                {hash});
+    }
+    EXPECT_EQ(graph.size(), blocks * 4);
+    for (int run = 0; run < 100; ++run) {
+        ASSERT_TRUE(graph.run(pool));
+    }
+    EXPECT_EQ(stage_errors.load(), 0);
+    for (uint32_t i = 0; i < blocks; ++i) {
+        EXPECT_EQ(out[i], 100u);
+    }
+}
+
+TEST(sys_task_graph, cycle_and_bad_edges) {
+    sys::scheduler pool(2);
+    sys::task_graph graph;
+    int runs = 0;
+    const auto a = graph.add([&] { ++runs; });
+    const auto b = graph.add([&] { ++runs; }, {a});
+    EXPECT_FALSE(graph.precede(a, 99));
+    EXPECT_EQ(graph.add([] {}, {42}), sys::task_graph::invalid_node);
+    EXPECT_TRUE(graph.precede(b, a));
+    EXPECT_FALSE(graph.run(pool));
+    EXPECT_EQ(runs, 0);
+    graph.clear();
+    EXPECT_TRUE(graph.run(pool));
+}
+
+TEST(sys_task_graph, exception) {
+    sys::scheduler pool(2);
+    sys::task_graph graph;
+    std::atomic<int> after{0};
+    const auto bad = graph.add([] { throw std::runtime_error("stage"); });
+    graph.add([&] { ++after; }, {bad});
+    EXPECT_THROW(graph.run(pool), std::runtime_error);
+    EXPECT_EQ(after.load(), 0);
+}
+
+TEST(sys_task_graph, nested_in_task) {
+    sys::scheduler pool(2);
+    std::atomic<int> total{0};
+    auto outer = pool.submit([&] {
+        sys::task_graph graph;
+        const auto first = graph.add([&] { total += 1; });
+        for (int i = 0; i < 32; ++i) {
+            graph.add([&] { total += 2; }, {first});
+        }
+        return graph.run(pool);
+    });
+    EXPECT_TRUE(pool.wait(outer));
+    EXPECT_EQ(total.load(), 65);
+}
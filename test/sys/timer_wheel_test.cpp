@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "sys/timer_wheel.h"
+namespace sys = YanLib::sys;
+using std::chrono::milliseconds;
+
+TEST(sys_timer_wheel, fires_in_order) {
+    // driven by hand with a 1ms tick, so ticks and milliseconds line up
+    sys::timer_wheel wheel;
+    std::vector<uint64_t> fired;
+    uint64_t now = 0;
+    const uint64_t delays[] = {1, 5, 255, 256, 300, 16383, 16384, 20000,
+                               1 << 20, (1 << 20) + 7};
+    for (const uint64_t delay : delays) {
+        wheel.add(milliseconds(delay), [&, delay] {
+            EXPECT_EQ(now, delay);
+            fired.push_back(delay);
+        });
+    }
+    EXPECT_EQ(wheel.pending(), std::size(delays));
+    while (now < (1 << 20) + 8) {
+        ++now;
+        wheel.advance();
+    }
+    ASSERT_EQ(fired.size(), std::size(delays));
+    for (size_t i = 0; i < fired.size(); ++i) {
+        EXPECT_EQ(fired[i], delays[i]);
+    }
+    EXPECT_EQ(wheel.pending(), 0u);
+}
+
+TEST(sys_timer_wheel, cancel_and_reschedule) {
+    sys::timer_wheel wheel;
+    int a = 0, b = 0, c = 0;
+    const auto id_a = wheel.add(milliseconds(10), [&] { ++a; });
+    const auto id_b = wheel.add(milliseconds(10), [&] { ++b; });
+    const auto id_c = wheel.add(milliseconds(1000), [&] { ++c; });
+    EXPECT_TRUE(wheel.cancel(id_a));
+    EXPECT_FALSE(wheel.cancel(id_a));
+    EXPECT_TRUE(wheel.reschedule(id_c, milliseconds(20)));
+    wheel.advance(10);
+    EXPECT_EQ(a, 0);
+    EXPECT_EQ(b, 1);
+    EXPECT_EQ(c, 0);
+    // fired one-shot timers are gone, ids are not reused
+    EXPECT_FALSE(wheel.cancel(id_b));
+    EXPECT_FALSE(wheel.reschedule(id_b, milliseconds(5)));
+    const auto id_d = wheel.add(milliseconds(5), [] {});
+    EXPECT_NE(id_d, id_b);
+    wheel.advance(10);
+    EXPECT_EQ(c, 1);
+    EXPECT_EQ(wheel.pending(), 0u);
+    EXPECT_FALSE(wheel.cancel(sys::timer_wheel::invalid_timer));
+}
+
+TEST(sys_timer_wheel, periodic) {
+    sys::timer_wheel wheel;
+    int runs = 0;
+    sys::timer_wheel::timer_id id = sys::timer_wheel::invalid_timer;
+    id = wheel.add(
+            milliseconds(3),
+            [&] {
+                if (++runs == 4) {
+                    wheel.cancel(id);
+                }
+            },
+            milliseconds(2));
+    wheel.advance(100);
+    EXPECT_EQ(runs, 4);
+    EXPECT_EQ(wheel.pending(), 0u);
+}
+
+TEST(sys_timer_wheel, throwing_callbacks) {
+    std::atomic<int> after{0};
+    std::atomic<int> periodic{0};
+    {
+        sys::timer_wheel wheel;
+        // the one after the throw in the same slot still fires
+        wheel.add(milliseconds(5), [] { throw std::runtime_error("t"); });
+        wheel.add(milliseconds(5), [&] { ++after; });
+        wheel.add(
+                milliseconds(2),
+                [&] {
+                    ++periodic;
+                    throw std::runtime_error("p");
+                },
+                milliseconds(2));
+        wheel.advance(10);
+        EXPECT_EQ(after.load(), 1);
+        EXPECT_EQ(periodic.load(), 5);
+        EXPECT_EQ(wheel.pending(), 1u);
+    }
+    {
+        sys::scheduler pool(2);
+        sys::timer_wheel wheel(&pool);
+        for (int i = 0; i < 100; ++i) {
+            wheel.add(milliseconds(1 + i % 10), [&, i] {
+                if (i % 2) {
+                    throw std::runtime_error("pool");
+                }
+                ++after;
+            });
+        }
+        wheel.advance(10);
+        // returns once every node is retired, thrown or not
+    }
+    EXPECT_EQ(after.load(), 51);
+}
+
+TEST(sys_timer_wheel, many_timeouts_on_pool) {
+    sys::scheduler pool(4);
+    std::atomic<int> fired{0};
+    std::vector<sys::timer_wheel::timer_id> ids;
+    {
+        sys::timer_wheel wheel(&pool);
+        for (int i = 0; i < 100000; ++i) {
+            ids.push_back(wheel.add(milliseconds(1 + i % 5000),
+                                    [&] { ++fired; }));
+        }
+        // most connections see traffic and push their timeout out
+        // and some close
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if (i % 4 == 1) {
+                EXPECT_TRUE(wheel.cancel(ids[i]));
+            } else if (i % 4) {
+                EXPECT_TRUE(wheel.reschedule(ids[i], milliseconds(100)));
+            }
+        }
+        EXPECT_EQ(wheel.pending(), 75000u);
+        wheel.advance(5000);
+        // the destructor waits for callbacks still running on the pool
+    }
+    EXPECT_EQ(fired.load(), 75000);
+}
+
+TEST(sys_timer_wheel, real_time) {
+    sys::scheduler pool(2);
+    sys::timer_wheel wheel(&pool);
+    ASSERT_TRUE(wheel.start());
+    std::atomic<int> fired{0};
+    const auto begin = std::chrono::steady_clock::now();
+    std::atomic<int64_t> elapsed{0};
+    wheel.add(milliseconds(30), [&] {
+        elapsed = std::chrono::duration_cast<milliseconds>(
+                          std::chrono::steady_clock::now() - begin)
+                          .count();
+        ++fired;
+    });
+    for (int i = 0; i < 500 && !fired; ++i) {
+        std::this_thread::sleep_for(milliseconds(2));
+    }
+    EXPECT_EQ(fired.load(), 1);
+    // within a tick of the deadline
+    EXPECT_GE(elapsed.load(), 29);
+    wheel.stop();
+}